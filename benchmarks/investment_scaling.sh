@@ -0,0 +1,74 @@
+#!/bin/sh
+# --------------------------------------------------------------------------- #
+#    Scaling of InvestmentFunction::compute() over the number of threads      #
+#                                                                             #
+#    Usage:                                                                   #
+#                                                                             #
+#        $ investment_scaling.sh [-x <exe>] [-t "<threads>"] [-r <number>]    #
+#                                -- <investment_solver options> <nc4-file>    #
+#                                                                             #
+#    For each number of threads T in the given list (by default, "1 2 4 8"),  #
+#    the given investment is simulated <number> times (by default, 3) by      #
+#    running                                                                  #
+#                                                                             #
+#        OMP_NUM_THREADS=T <exe> -s -n T -P <profile> <options> <nc4-file>    #
+#                                                                             #
+#    where <exe> is the investment_solver executable (by default, the one in  #
+#    the PATH). A CSV line with the columns                                   #
+#                                                                             #
+#        threads , repetition , seconds , compute_seconds                     #
+#                                                                             #
+#    is written on the standard output for each run, where seconds is the     #
+#    wall-clock time of the run and compute_seconds is the time spent in      #
+#    InvestmentFunction::compute() according to the report of the Profiler.   #
+#    The output of investment_solver is discarded.                            #
+# --------------------------------------------------------------------------- #
+
+exe=investment_solver
+threads="1 2 4 8"
+repetitions=3
+
+while getopts "x:t:r:" option; do
+    case "$option" in
+        x) exe="$OPTARG" ;;
+        t) threads="$OPTARG" ;;
+        r) repetitions="$OPTARG" ;;
+        *) echo "Usage: $0 [-x <exe>] [-t \"<threads>\"] [-r <number>]" \
+                "-- <investment_solver options> <nc4-file>" >&2
+           exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+    echo "$0: no input file" >&2
+    exit 1
+fi
+
+profile=$(mktemp) || exit 1
+trap 'rm -f "$profile"' EXIT
+
+echo "threads,repetition,seconds,compute_seconds"
+
+for t in $threads; do
+    r=0
+    while [ "$r" -lt "$repetitions" ]; do
+        start=$(date +%s.%N)
+        if ! OMP_NUM_THREADS="$t" "$exe" -s -n "$t" -P "$profile" "$@" \
+             > /dev/null 2>&1; then
+            echo "$0: $exe failed with $t threads" >&2
+            exit 1
+        fi
+        end=$(date +%s.%N)
+        compute=$(awk -F, '$1 == "timer" &&
+                           $2 == "InvestmentFunction::compute" {
+                               total += $6 }
+                           END { printf "%.9f", total }' "$profile")
+        awk -v t="$t" -v r="$r" -v start="$start" -v end="$end" \
+            -v compute="$compute" \
+            'BEGIN { printf "%s,%s,%.9f,%s\n", t, r, end - start, compute }'
+        r=$((r + 1))
+    done
+done
+
+# --------------------------------------------------------------------------- #
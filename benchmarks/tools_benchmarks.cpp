@@ -0,0 +1,1142 @@
+/*--------------------------------------------------------------------------*/
+/*----------------------- File tools_benchmarks.cpp ------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ *
+ * This is a tool for benchmarking the components of the tools on synthetic
+ * (and reproducible) workloads. It can be executed as follows:
+ *
+ *   ./tools_benchmarks [-b NAME] [-m NUMBER] [-n NUMBER] [-t NUMBER]
+ *                      [-j NUMBER] [-f FRACTION] [-r NUMBER] [-s SEED]
+ *                      [-o FILE]
+ *
+ * The -b option selects the benchmark to be run (every benchmark is run if
+ * this option is not used) and can be given more than once. The benchmarks
+ * are the following:
+ *
+ * - parallel_cuts: CutProcessing::remove_parallel_cuts() on a
+ *   PolyhedralFunction with m cuts in n variables, a fraction f of which are
+ *   parallel to (i.e., have the same coefficients as) another cut;
+ *
+ * - redundant_cuts: CutProcessing::remove_redundant_cuts() on a
+ *   PolyhedralFunction with m cuts in n variables, a fraction f of which are
+ *   dominated by (a convex combination of) two other cuts;
+ *
+ * - read_cuts: CutFileReader::read() of a CSV file, in the format written by
+ *   SDDPBlockSolutionOutput::print_cuts(), with m cuts in n variables for
+ *   each of t stages, using j threads;
+ *
+ * - print_cuts: SDDPBlockSolutionOutput::print_cuts() of the cuts of t
+ *   stages, each with m cuts in n variables (as for read_cuts), into a CSV
+ *   file;
+ *
+ * - cut_archive: CutArchive::write() of the same cuts as for print_cuts and
+ *   CutArchive::read_stage() of every stage of the written file, which
+ *   must give back the same cuts;
+ *
+ * - print_table: UCBlockSolutionOutput::print() of the Table of a quantity
+ *   (e.g., the active power) with m time steps and n columns (e.g., the
+ *   generators), into a CSV file;
+ *
+ * - profiler_threads: m rounds, each of which starts j threads that record
+ *   n timers of the Profiler (each with its own scenario) and waits for
+ *   them to exit, so that the memory used by the Profiler must not grow
+ *   with the number of rounds;
+ *
+ * - parallel_cuts_check: CutProcessing::remove_parallel_cuts() on several
+ *   PolyhedralFunction with m cuts in n variables (and in 1 and 0
+ *   variables) with many equal key values and NaN and infinite
+ *   coefficients, for several errors, whose removed cuts must be exactly
+ *   those of the pairwise comparison of the cuts;
+ *
+ * - global_pool: InvestmentFunctionState::serialize() into a netCDF file and
+ *   deserialize() out of it of a global pool of m names, three quarters of
+ *   which hold a linearization with n coefficients (diagonal or vertical,
+ *   exact or inexact, stored in random order), which must all be read back
+ *   unchanged;
+ *
+ * - parameter_sweep: ParameterSweep::override() of a configuration text
+ *   with m parameters (each followed by a comment), a tenth of which is
+ *   replaced, together with a parameter occurring twice and a name which
+ *   is a prefix of other ones (and must hence not be found);
+ *
+ * - run_batch: run_batch() (see block_solver/common_utils.h) of m jobs with
+ *   j threads, three quarters of which fail, by throwing an exception with
+ *   a message, one with an empty message, or one that is not an
+ *   std::exception; the number of failures, the outputs and the error
+ *   messages (which are captured) must be the expected ones and in order.
+ *
+ * The last four are deterministic checks rather than benchmarks: they throw
+ * an std::logic_error (and the tool exits with status 1) if the result is
+ * not the expected one, and they are run by ctest with small sizes.
+ *
+ * The cuts are the tangent planes of the function x^T x at points drawn
+ * uniformly at random in [ -1 , 1 ]^n, so that every one of them which is not
+ * parallel or dominated is active somewhere. The random numbers are produced
+ * by an std::mt19937 engine seeded with the value of the -s option (0 by
+ * default), so that the workloads only depend on the options. The default
+ * values are m = 1000, n = 50, t = 10, j = 1, f = 0.1.
+ *
+ * Every benchmark is repeated the number of times given by the -r option (5
+ * by default), the workload being rebuilt (and not timed) before each
+ * repetition. For each repetition, a CSV line with the following columns is
+ * written into the file given by the -o option (or on the standard output):
+ *
+ *   benchmark , rows , columns , stages , threads , repetition , seconds ,
+ *   items_per_second , result
+ *
+ * where the items are the cuts (or the values of the Table) that are
+ * processed, and result is the number of cuts that have been removed (for
+ * parallel_cuts and redundant_cuts), read (for read_cuts and cut_archive),
+ * the number of bytes written (for print_cuts and print_table), the number
+ * of thread data of the Profiler, which must not exceed j + 1 (for
+ * profiler_threads), the number of cuts removed in all cases (for
+ * parallel_cuts_check), the number of linearizations read back (for
+ * global_pool), the number of parameters replaced (for parameter_sweep) or
+ * the number of failed jobs (for run_batch).
+ *
+ * The files are written into a temporary directory, which is removed at the
+ * end.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+
+#include <getopt.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+#include <ColVariable.h>
+#include <PolyhedralFunction.h>
+
+#include "CutArchive.h"
+#include "CutFileReader.h"
+#include "CutProcessing.h"
+#include "InvestmentFunction.h"
+#include "ParameterSweep.h"
+#include "Profiler.h"
+#include "SDDPBlockSolutionOutput.h"
+#include "UCBlockSolutionOutput.h"
+#include "common_utils.h"
+
+using namespace SMSpp_di_unipi_it;
+
+using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+
+std::vector< std::string > benchmarks{};
+std::string output_filename{};
+long number_rows = 1000;
+long number_columns = 50;
+long number_stages = 10;
+long number_threads = 1;
+long number_repetitions = 5;
+long seed = 0;
+double fraction = 0.1;
+
+const std::vector< std::string > all_benchmarks =
+ { "parallel_cuts" , "redundant_cuts" , "read_cuts" , "print_cuts" ,
+   "cut_archive" , "print_table" , "profiler_threads" ,
+   "parallel_cuts_check" , "global_pool" , "parameter_sweep" , "run_batch" };
+
+// exe, docopt_desc and get_filename() come from common_utils.h
+
+/*--------------------------------------------------------------------------*/
+
+void print_help() {
+ // http://docopt.org
+ std::cout << docopt_desc << std::endl;
+ std::cout << "Usage:\n"
+           << "  " << exe << " [options]\n"
+           << "  " << exe << " -h | --help\n"
+           << std::endl
+           << "Options:\n"
+           << "  -b, --benchmark <name>          The benchmark to be run.\n"
+           << "  -f, --fraction <fraction>       Fraction of parallel/redundant cuts.\n"
+           << "  -h, --help                      Print this help.\n"
+           << "  -j, --threads <number>          Number of threads.\n"
+           << "  -m, --rows <number>             Number of cuts or time steps.\n"
+           << "  -n, --columns <number>          Number of variables or columns.\n"
+           << "  -o, --output <file>             Output the results into a file.\n"
+           << "  -r, --repetitions <number>      Number of repetitions.\n"
+           << "  -s, --seed <seed>               Seed of the random number engine.\n"
+           << "  -t, --stages <number>           Number of stages."
+           << std::endl;
+}
+
+/*--------------------------------------------------------------------------*/
+
+long get_long_option() {
+ char * end = nullptr;
+ errno = 0;
+ long option = std::strtol( optarg , &end , 10 );
+ if( ( ! optarg ) || ( ( option = std::strtol( optarg , &end , 10 ) ) ,
+                       ( errno || ( end && *end ) ) ) ) {
+  option = -1;
+ }
+ return( option );
+}
+
+/*--------------------------------------------------------------------------*/
+
+// not process_args(), which is the one of common_utils.h
+void process_benchmark_args( int argc , char ** argv ) {
+
+ const char * const short_opts = "b:f:hj:m:n:o:r:s:t:";
+ const option long_opts[] = {
+  { "benchmark" ,   required_argument , nullptr , 'b' } ,
+  { "fraction" ,    required_argument , nullptr , 'f' } ,
+  { "help" ,        no_argument ,       nullptr , 'h' } ,
+  { "threads" ,     required_argument , nullptr , 'j' } ,
+  { "rows" ,        required_argument , nullptr , 'm' } ,
+  { "columns" ,     required_argument , nullptr , 'n' } ,
+  { "output" ,      required_argument , nullptr , 'o' } ,
+  { "repetitions" , required_argument , nullptr , 'r' } ,
+  { "seed" ,        required_argument , nullptr , 's' } ,
+  { "stages" ,      required_argument , nullptr , 't' } ,
+  { nullptr ,       no_argument ,       nullptr , 0 }
+ };
+
+ auto get_positive_option = []( const std::string & name ) {
+  const auto option = get_long_option();
+  if( option <= 0 ) {
+   std::cout << "The " << name << " must be a positive integer."
+             << std::endl;
+   exit( 1 );
+  }
+  return( option );
+ };
+
+ // Options
+ while( true ) {
+  const auto opt = getopt_long( argc , argv , short_opts ,
+                                long_opts , nullptr );
+
+  if( opt == -1 ) {
+   break;
+  }
+
+  switch( opt ) {
+   case 'b': {
+    const std::string name( optarg );
+    if( std::find( all_benchmarks.begin() , all_benchmarks.end() , name ) ==
+        all_benchmarks.end() ) {
+     std::cout << "Unknown benchmark '" << name << "'. The benchmarks are:";
+     for( const auto & benchmark : all_benchmarks )
+      std::cout << " " << benchmark;
+     std::cout << "." << std::endl;
+     exit( 1 );
+    }
+    benchmarks.push_back( name );
+    break;
+   }
+   case 'f': {
+    char * end = nullptr;
+    fraction = std::strtod( optarg , &end );
+    if( ( end && *end ) || ( ! ( fraction >= 0 ) ) || ( fraction >= 1 ) ) {
+     std::cout << "The fraction of parallel or redundant cuts must be a "
+               << "number in [0, 1)." << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
+   case 'j':
+    number_threads = get_positive_option( "number of threads" );
+    break;
+   case 'm':
+    number_rows = get_positive_option( "number of rows" );
+    break;
+   case 'n':
+    number_columns = get_positive_option( "number of columns" );
+    break;
+   case 'o':
+    output_filename = std::string( optarg );
+    break;
+   case 'r':
+    number_repetitions = get_positive_option( "number of repetitions" );
+    break;
+   case 's':
+    seed = get_long_option();
+    if( seed < 0 ) {
+     std::cout << "The seed must be a nonnegative integer." << std::endl;
+     exit( 1 );
+    }
+    break;
+   case 't':
+    number_stages = get_positive_option( "number of stages" );
+    break;
+   case 'h': // -h or --help
+    print_help();
+    exit( 0 );
+   case '?': // Unrecognized option
+   default:
+    std::cout << "Try " << exe << "' --help' for more information.\n";
+    exit( 1 );
+  }
+ }
+
+ if( optind < argc ) {
+  std::cout << exe << ": unexpected argument '" << argv[ optind ] << "'\n"
+            << "Try " << exe << "' --help' for more information.\n";
+  exit( 1 );
+ }
+
+ if( benchmarks.empty() )
+  benchmarks = all_benchmarks;
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// generates m cuts of the function x^T x in n variables
+/** Generates m cuts of the function x^T x in n variables (the tangent planes
+ * at random points in [ -1 , 1 ]^n). If \p parallel is true, a fraction \p
+ * fraction of them are copies of the coefficients of a previous cut with a
+ * smaller constant term; otherwise, they are convex combinations of two
+ * previous cuts with a smaller constant term (so that they are dominated but
+ * not parallel to any other cut). */
+
+void generate_cuts( Index m , Index n , double fraction , bool parallel ,
+                    std::mt19937 & engine ,
+                    PolyhedralFunction::MultiVector & A ,
+                    PolyhedralFunction::RealVector & b ) {
+
+ std::uniform_real_distribution< double > point_distribution( -1 , 1 );
+ std::uniform_real_distribution< double > unit_distribution( 0 , 1 );
+
+ const auto number_dominated = Index( fraction * m );
+ const auto number_tangent = std::max( Index( 2 ) , m - number_dominated );
+
+ A.resize( std::max( m , number_tangent ) );
+ b.resize( A.size() );
+
+ for( Index i = 0 ; i < number_tangent ; ++i ) {
+  A[ i ].resize( n );
+  double norm = 0;
+  for( Index j = 0 ; j < n ; ++j ) {
+   const auto x = point_distribution( engine );
+   A[ i ][ j ] = 2 * x;
+   norm += x * x;
+  }
+  b[ i ] = - norm;
+ }
+
+ for( Index i = number_tangent ; i < A.size() ; ++i ) {
+  const auto k = Index( unit_distribution( engine ) * number_tangent ) %
+   number_tangent;
+  const auto shift = 1.0e-3 + unit_distribution( engine );
+  if( parallel ) {
+   A[ i ] = A[ k ];
+   b[ i ] = b[ k ] - shift;
+  }
+  else {
+   const auto l = ( k + 1 ) % number_tangent;
+   const auto lambda = 0.25 + 0.5 * unit_distribution( engine );
+   A[ i ].resize( n );
+   for( Index j = 0 ; j < n ; ++j )
+    A[ i ][ j ] = lambda * A[ k ][ j ] + ( 1 - lambda ) * A[ l ][ j ];
+   b[ i ] = lambda * b[ k ] + ( 1 - lambda ) * b[ l ] - shift;
+  }
+ }
+
+ // Shuffle the cuts, so that the dominated ones are not all at the end
+
+ std::vector< Index > permutation( A.size() );
+ std::iota( permutation.begin() , permutation.end() , 0 );
+ std::shuffle( permutation.begin() , permutation.end() , engine );
+
+ PolyhedralFunction::MultiVector shuffled_A( A.size() );
+ PolyhedralFunction::RealVector shuffled_b( b.size() );
+ for( Index i = 0 ; i < A.size() ; ++i ) {
+  shuffled_A[ i ] = std::move( A[ permutation[ i ] ] );
+  shuffled_b[ i ] = b[ permutation[ i ] ];
+ }
+ A = std::move( shuffled_A );
+ b = std::move( shuffled_b );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// the result of a repetition of a benchmark
+struct Result {
+ double seconds = 0;          ///< the time spent in the timed part
+ double items = 0;            ///< the number of items processed
+ double result = 0;           ///< what has been computed (see above)
+};
+
+/*--------------------------------------------------------------------------*/
+
+/// returns the time (in seconds) spent by the given function
+double get_elapsed_time( const std::function< void() > & function ) {
+ const auto start = std::chrono::steady_clock::now();
+ function();
+ const std::chrono::duration< double > elapsed =
+  std::chrono::steady_clock::now() - start;
+ return( elapsed.count() );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_cut_processing( bool parallel , std::mt19937 & engine ) {
+
+ PolyhedralFunction::MultiVector A;
+ PolyhedralFunction::RealVector b;
+ generate_cuts( number_rows , number_columns , fraction , parallel , engine ,
+                A , b );
+
+ // The current point, at which the pre-filter of remove_redundant_cuts()
+ // is performed, is the origin
+
+ std::vector< ColVariable > x( number_columns );
+ PolyhedralFunction::VarVector variables( number_columns );
+ for( Index j = 0 ; j < Index( number_columns ) ; ++j ) {
+  x[ j ].set_value( 0 );
+  variables[ j ] = & x[ j ];
+ }
+
+ const double number_cuts = A.size();
+
+ PolyhedralFunction function( std::move( variables ) , std::move( A ) ,
+                              std::move( b ) );
+
+ CutProcessing cut_processing;
+
+ Result result;
+ result.items = number_cuts;
+ result.seconds = get_elapsed_time( [ & ]() {
+  if( parallel )
+   cut_processing.remove_parallel_cuts( & function );
+  else
+   cut_processing.remove_redundant_cuts( & function );
+ } );
+ result.result = number_cuts - function.get_nrows();
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// returns the parallel cuts with the pairwise definition
+/** Returns the (sorted) indices of the rows of ( A , b ) that are removed
+ * by comparing every row i that has not been removed with every following
+ * one k that has not been removed, in order: if they are parallel (every
+ * component differs by at most \p error and by at most \p relative_error
+ * times the largest of its absolute values), the worse of them (row i if
+ * sign * b[ i ] > sign * b[ k ]) is removed. This is the original O( m^2 n )
+ * definition of CutProcessing::remove_parallel_cuts(). */
+
+std::vector< Index > find_parallel_cuts
+( const PolyhedralFunction::MultiVector & A ,
+  const PolyhedralFunction::RealVector & b , double sign , double error ,
+  double relative_error ) {
+
+ std::vector< Index > rows_to_remove;
+ std::vector< bool > remove( A.size() , false );
+
+ for( Index i = 0 ; i < A.size() ; ++i ) {
+  if( remove[ i ] ) continue;
+
+  for( Index k = i + 1 ; k < A.size() ; ++k ) {
+   if( remove[ k ] ) continue;
+
+   bool parallel = true;
+
+   for( Index j = 0 ; j < A[ i ].size() ; ++j ) {
+    if( ( std::abs( A[ i ][ j ] - A[ k ][ j ] ) > error ) ||
+        ( std::abs( A[ i ][ j ] - A[ k ][ j ] ) > relative_error *
+          std::max( std::abs( A[ i ][ j ] ) , std::abs( A[ k ][ j ] ) ) ) ) {
+     parallel = false;
+     break;
+    }
+   }
+
+   if( parallel ) {
+    if( sign * b[ i ] > sign * b[ k ] ) {
+     remove[ i ] = true;
+     rows_to_remove.push_back( i );
+     break;
+    }
+    else {
+     remove[ k ] = true;
+     rows_to_remove.push_back( k );
+    }
+   }
+  }
+ }
+
+ std::sort( rows_to_remove.begin() , rows_to_remove.end() );
+ return( rows_to_remove );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_parallel_cuts_check( std::mt19937 & engine ) {
+
+ // Each case gives the number of variables, the absolute and relative
+ // errors, whether the function is convex and whether the coefficients are
+ // drawn from a few values (so that many rows share the key value, and most
+ // searches scan the rows) or from an interval (so that the windows are
+ // small, and the candidates are sorted)
+
+ struct Case {
+  Index num_var;
+  double error;
+  double relative_error;
+  bool convex;
+  bool few_values;
+ };
+
+ const auto n = Index( number_columns );
+ const std::vector< Case > cases = {
+  { n , 0 , 0 , true , true } ,
+  { n , 1e-3 , 0 , true , true } ,
+  { n , 1e-3 , 1e-2 , false , false } ,
+  { 1 , 1e-3 , 0 , true , false } ,
+  { n , 0.5 , 0 , false , true } ,
+  { n , Inf< double >() , 0 , true , true } ,
+  { 0 , 0 , 0 , true , true } };
+
+ std::uniform_real_distribution< double > unit_distribution( 0 , 1 );
+ std::uniform_int_distribution< int > value_distribution( -2 , 2 );
+ std::uniform_int_distribution< int > shift_distribution( -4 , 4 );
+
+ const auto m = Index( number_rows );
+ const auto number_base_rows = std::max( Index( 1 ) , m / 4 );
+
+ Result result;
+
+ for( const auto & c : cases ) {
+
+  // The rows are copies of a few base rows, half of which have some
+  // coefficients shifted by multiples of half the error (so that some are
+  // just within it and some are just outside it) or replaced by NaN or
+  // infinite values. The constants are distinct, so that the removed rows
+  // can be told from the remaining constants.
+
+  const auto step = ( ( c.error > 0 ) && ( c.error < Inf< double >() ) ) ?
+   c.error / 2 : 1e-3;
+
+  PolyhedralFunction::MultiVector base( number_base_rows ,
+                                        PolyhedralFunction::RealVector
+                                        ( c.num_var ) );
+  for( auto & row : base )
+   for( auto & a : row )
+    a = c.few_values ? value_distribution( engine ) / 2.0 :
+     2 * unit_distribution( engine ) - 1;
+
+  PolyhedralFunction::MultiVector A( m );
+  for( auto & row : A ) {
+   row = base[ Index( unit_distribution( engine ) * number_base_rows ) %
+               number_base_rows ];
+   if( unit_distribution( engine ) < 0.5 )
+    continue;
+   for( auto & a : row ) {
+    const auto u = unit_distribution( engine );
+    if( u < 0.02 )
+     a = std::numeric_limits< double >::quiet_NaN();
+    else if( u < 0.04 )
+     a = Inf< double >();
+    else if( u < 0.06 )
+     a = - Inf< double >();
+    else if( u < 0.2 )
+     a += shift_distribution( engine ) * step;
+   }
+  }
+
+  std::vector< Index > permutation( m );
+  std::iota( permutation.begin() , permutation.end() , 0 );
+  std::shuffle( permutation.begin() , permutation.end() , engine );
+
+  PolyhedralFunction::RealVector b( m );
+  std::map< double , Index > row_of_constant;
+  for( Index i = 0 ; i < m ; ++i ) {
+   b[ i ] = - double( permutation[ i ] ) - unit_distribution( engine ) / 2;
+   row_of_constant[ b[ i ] ] = i;
+  }
+
+  const auto expected = find_parallel_cuts( A , b , c.convex ? -1.0 : 1.0 ,
+                                            c.error , c.relative_error );
+
+  std::vector< ColVariable > x( c.num_var );
+  PolyhedralFunction::VarVector variables( c.num_var );
+  for( Index j = 0 ; j < c.num_var ; ++j )
+   variables[ j ] = & x[ j ];
+
+  PolyhedralFunction function( std::move( variables ) , std::move( A ) ,
+                               std::move( b ) , c.convex ? - Inf< double >()
+                                                         : Inf< double >() ,
+                               c.convex );
+
+  CutProcessing cut_processing;
+  cut_processing.set_parallel_error( c.error );
+  cut_processing.set_parallel_relative_error( c.relative_error );
+
+  result.seconds += get_elapsed_time( [ & ]() {
+   cut_processing.remove_parallel_cuts( & function );
+  } );
+  result.items += m;
+
+  std::vector< bool > kept( m , false );
+  for( const auto constant : function.get_b() )
+   kept[ row_of_constant.at( constant ) ] = true;
+
+  std::vector< Index > removed;
+  for( Index i = 0 ; i < m ; ++i )
+   if( ! kept[ i ] )
+    removed.push_back( i );
+
+  if( removed != expected )
+   throw( std::logic_error( "parallel_cuts_check: " +
+                            std::to_string( removed.size() ) + " cuts in " +
+                            std::to_string( c.num_var ) + " variables have "
+                            "been removed with error " +
+                            std::to_string( c.error ) + " and relative "
+                            "error " + std::to_string( c.relative_error ) +
+                            ", but the pairwise definition removes " +
+                            std::to_string( expected.size() ) +
+                            " (or other ones)." ) );
+
+  result.result += removed.size();
+ }
+
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_read_cuts( const std::filesystem::path & directory ,
+                      std::mt19937 & engine ) {
+
+ const auto filename = ( directory / "BellmanValuesOUT.csv" ).string();
+
+ {
+  std::ofstream output( filename , std::ios::out );
+  output << "Timestep";
+  for( long j = 0 ; j < number_columns ; ++j )
+   output << ",a_" << j;
+  output << ",b\n";
+
+  PolyhedralFunction::MultiVector A;
+  PolyhedralFunction::RealVector b;
+  for( long stage = 0 ; stage < number_stages ; ++stage ) {
+   generate_cuts( number_rows , number_columns , 0 , true , engine , A , b );
+   for( Index i = 0 ; i < b.size() ; ++i ) {
+    output << stage;
+    for( const auto a : A[ i ] )
+     output << ',' << std::setprecision( 20 ) << a;
+    output << ',' << std::setprecision( 20 ) << b[ i ] << '\n';
+   }
+  }
+ }
+
+ const std::vector< Index > num_var( number_stages , number_columns );
+ std::vector< PolyhedralFunction::MultiVector > A;
+ std::vector< PolyhedralFunction::RealVector > b;
+
+ Result result;
+ result.seconds = get_elapsed_time( [ & ]() {
+  CutFileReader::read( filename , num_var , A , b , number_threads );
+ } );
+ for( const auto & b_stage : b )
+  result.result += b_stage.size();
+ result.items = result.result;
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// the PolyhedralFunction of t stages, each with m cuts in n variables
+struct StageFunctions {
+ std::vector< ColVariable > x;  ///< the variables of all the stages
+ std::vector< std::unique_ptr< PolyhedralFunction > > functions;
+ ///< the PolyhedralFunction of each stage
+
+ /// returns the PolyhedralFunction of each stage
+ std::vector< PolyhedralFunction * > get() const {
+  std::vector< PolyhedralFunction * > result;
+  for( const auto & function : functions )
+   result.push_back( function.get() );
+  return( result );
+ }
+};
+
+/*--------------------------------------------------------------------------*/
+
+/// generates the cuts of the read_cuts workload, one PolyhedralFunction each
+void generate_stage_functions( std::mt19937 & engine ,
+                               StageFunctions & stages ) {
+
+ stages.functions.clear();
+ stages.x = std::vector< ColVariable >( number_stages * number_columns );
+
+ for( long stage = 0 ; stage < number_stages ; ++stage ) {
+  PolyhedralFunction::MultiVector A;
+  PolyhedralFunction::RealVector b;
+  generate_cuts( number_rows , number_columns , 0 , true , engine , A , b );
+
+  PolyhedralFunction::VarVector variables( number_columns );
+  for( long j = 0 ; j < number_columns ; ++j )
+   variables[ j ] = & stages.x[ stage * number_columns + j ];
+
+  stages.functions.push_back( std::make_unique< PolyhedralFunction >
+                              ( std::move( variables ) , std::move( A ) ,
+                                std::move( b ) ) );
+ }
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_print_cuts( const std::filesystem::path & directory ,
+                       std::mt19937 & engine ) {
+
+ StageFunctions stages;
+ generate_stage_functions( engine , stages );
+ const auto functions = stages.get();
+
+ const auto filename = ( directory / "BellmanValuesOUT.csv" ).string();
+
+ Result result;
+ result.items = double( number_rows ) * number_stages;
+ result.seconds = get_elapsed_time( [ & ]() {
+  SDDPBlockSolutionOutput().print_cuts( functions , filename );
+ } );
+ result.result = std::filesystem::file_size( filename );
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_cut_archive( const std::filesystem::path & directory ,
+                        std::mt19937 & engine ) {
+
+ StageFunctions stages;
+ generate_stage_functions( engine , stages );
+ const auto functions = stages.get();
+
+ const auto filename =
+  ( directory / ( "BellmanValuesOUT" + CutArchive::extension ) ).string();
+
+ std::vector< PolyhedralFunction::MultiVector > A( functions.size() );
+ std::vector< PolyhedralFunction::RealVector > b( functions.size() );
+
+ Result result;
+ result.seconds = get_elapsed_time( [ & ]() {
+  CutArchive::write( functions , filename );
+  CutArchive archive( filename );
+  for( Index stage = 0 ; stage < archive.get_num_stages() ; ++stage )
+   archive.read_stage( stage , A[ stage ] , b[ stage ] );
+ } );
+
+ // The cuts must be read back exactly as they were written
+
+ for( Index stage = 0 ; stage < functions.size() ; ++stage ) {
+  if( ( A[ stage ] != functions[ stage ]->get_A() ) ||
+      ( b[ stage ] != functions[ stage ]->get_b() ) )
+   throw( std::logic_error( "cut_archive: the cuts of stage " +
+                            std::to_string( stage ) + " have changed." ) );
+  result.result += b[ stage ].size();
+ }
+ result.items = result.result;
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_print_table( const std::filesystem::path & directory ,
+                        std::mt19937 & engine ) {
+
+ std::uniform_real_distribution< double > distribution( 0 , 1000 );
+
+ std::vector< std::string > column_names( number_columns );
+ for( long j = 0 ; j < number_columns ; ++j )
+  column_names[ j ] = "Generator_" + std::to_string( j );
+
+ UCBlockSolutionOutput::Table table;
+ table.row_dimension = "time";
+ table.column_dimension = "generator";
+ table.column_names = & column_names;
+ table.rows = number_rows;
+ table.columns = number_columns;
+ table.values.resize( table.rows * table.columns );
+ for( auto & value : table.values )
+  value = distribution( engine );
+
+ // UCBlockSolutionOutput writes into the current directory
+
+ const auto current_path = std::filesystem::current_path();
+ std::filesystem::current_path( directory );
+
+ UCBlockSolutionOutput output;
+
+ Result result;
+ result.items = table.values.size();
+ result.seconds = get_elapsed_time( [ & ]() { output.print( table ); } );
+
+ for( const auto & entry : std::filesystem::directory_iterator( "." ) )
+  if( entry.path().extension() == ".csv" )
+   result.result += std::filesystem::file_size( entry.path() );
+
+ std::filesystem::current_path( current_path );
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_profiler_threads() {
+
+ Profiler::reset();
+ Profiler::enable();
+
+ Result result;
+ result.items = double( number_rows ) * number_threads * number_columns;
+ result.seconds = get_elapsed_time( [ & ]() {
+  for( long round = 0 ; round < number_rows ; ++round ) {
+   std::vector< std::thread > threads;
+   for( long t = 0 ; t < number_threads ; ++t )
+    threads.emplace_back( []() {
+     for( long scenario = 0 ; scenario < number_columns ; ++scenario )
+      Profiler::ScopedTimer timer( "profiler_threads" , scenario );
+    } );
+   for( auto & thread : threads )
+    thread.join();
+  }
+ } );
+
+ Profiler::enable( false );
+
+ result.result = Profiler::get_number_thread_data();
+ if( result.result > number_threads + 1 )
+  throw( std::logic_error( "profiler_threads: the Profiler holds " +
+                           std::to_string( long( result.result ) ) +
+                           " thread data for " +
+                           std::to_string( number_threads ) + " threads." ) );
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// an InvestmentFunctionState whose GlobalPool can be accessed
+struct GlobalPoolState : public InvestmentFunctionState {
+ using InvestmentFunctionState::global_pool;
+};
+
+/*--------------------------------------------------------------------------*/
+
+Result run_global_pool( const std::filesystem::path & directory ,
+                        std::mt19937 & engine ) {
+
+ std::uniform_real_distribution< double > distribution( -1 , 1 );
+
+ const auto size = Index( number_rows );
+ const auto n = Index( number_columns );
+
+ // Every fourth name is left empty, and the linearizations are stored in
+ // random order, so that the rows of the slab are not in the order of the
+ // names (and must be gathered by serialize())
+
+ std::vector< Index > names;
+ for( Index name = 0 ; name < size ; ++name )
+  if( name % 4 != 3 )
+   names.push_back( name );
+ std::shuffle( names.begin() , names.end() , engine );
+
+ GlobalPoolState state;
+ auto & pool = state.global_pool;
+ pool.resize( size );
+
+ std::vector< Function::FunctionValue > coefficients( n );
+ for( const auto name : names ) {
+  for( auto & coefficient : coefficients )
+   coefficient = distribution( engine );
+  const auto constant = distribution( engine );
+  const bool diagonal = distribution( engine ) < 0;
+  const bool inexact = distribution( engine ) < 0;
+  pool.store( constant , coefficients , name , diagonal , inexact );
+ }
+
+ const auto filename = ( directory / "GlobalPool.nc4" ).string();
+ GlobalPoolState read_state;
+
+ Result result;
+ result.items = double( names.size() ) * n;
+ result.seconds = get_elapsed_time( [ & ]() {
+  {
+   netCDF::NcFile file( filename , netCDF::NcFile::replace );
+   state.serialize( file );
+  }
+  netCDF::NcFile file( filename , netCDF::NcFile::read );
+  read_state.deserialize( file );
+ } );
+
+ const auto & read_pool = read_state.global_pool;
+ if( read_pool.size() != size )
+  throw( std::logic_error( "global_pool: the global pool has size " +
+                           std::to_string( read_pool.size() ) +
+                           " after the round trip, but " +
+                           std::to_string( size ) + " was expected." ) );
+
+ std::vector< Function::FunctionValue > read_coefficients( n );
+ for( Index name = 0 ; name < size ; ++name ) {
+  bool same = ( pool.is_linearization_there( name ) ==
+                read_pool.is_linearization_there( name ) );
+  if( same && pool.is_linearization_there( name ) ) {
+   pool.get_linearization_coefficients( coefficients.data() ,
+                                        Block::Range( 0 , n ) , name );
+   read_pool.get_linearization_coefficients( read_coefficients.data() ,
+                                             Block::Range( 0 , n ) , name );
+   same = ( pool.is_linearization_vertical( name ) ==
+            read_pool.is_linearization_vertical( name ) ) &&
+          ( pool.is_linearization_inexact( name ) ==
+            read_pool.is_linearization_inexact( name ) ) &&
+          ( pool.get_linearization_constant( name ) ==
+            read_pool.get_linearization_constant( name ) ) &&
+          ( coefficients == read_coefficients );
+   ++result.result;
+  }
+  if( ! same )
+   throw( std::logic_error( "global_pool: the linearization with name " +
+                            std::to_string( name ) + " has changed in the "
+                            "round trip." ) );
+ }
+
+ if( result.result != names.size() )
+  throw( std::logic_error( "global_pool: " +
+                           std::to_string( long( result.result ) ) +
+                           " linearizations were read back, but " +
+                           std::to_string( names.size() ) +
+                           " were stored." ) );
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_parameter_sweep() {
+
+ // The parameters are written in decreasing order, so that par_10 comes
+ // before par_1 (which must not match it); the comments must be dropped,
+ // duplicated parameters are replaced in order and par_ is not a parameter
+
+ std::ostringstream text;
+ std::string expected;
+ std::vector< ParameterSweep::Override > overrides;
+
+ text << "# par_0   0\n";
+ expected += "\n";
+ for( long i = number_rows ; i-- > 0 ; ) {
+  const auto name = "par_" + std::to_string( i );
+  text << "  " << name << "   " << i << "   # " << name << "   -1\n";
+  if( i % 10 == 1 ) {
+   overrides.emplace_back( name , "v" + std::to_string( i ) );
+   expected += name + "   v" + std::to_string( i ) + "\n";
+  }
+  else
+   expected += name + "   " + std::to_string( i ) + "   \n";
+ }
+ text << "par_twice 0\npar_twice 0\n";
+ overrides.emplace_back( "par_twice" , "1" );
+ overrides.emplace_back( "par_twice" , "2" );
+ expected += "par_twice   1\npar_twice   2\n";
+
+ const auto input = text.str();
+
+ Result result;
+ result.items = number_rows + 3;
+
+ std::string output;
+ result.seconds = get_elapsed_time( [ & ]() {
+  std::istringstream stream( input );
+  output = ParameterSweep::override( stream , overrides );
+ } );
+
+ if( output != expected )
+  throw( std::logic_error( "parameter_sweep: the configuration text has not "
+                           "been overridden as expected." ) );
+
+ bool found = true;
+ try {
+  std::istringstream stream( input );
+  ParameterSweep::override( stream , { { "par_" , "0" } } );
+ }
+ catch( const std::logic_error & ) {
+  found = false;
+ }
+ if( found )
+  throw( std::logic_error( "parameter_sweep: par_ has been found, but it is "
+                           "only a prefix of the parameters." ) );
+
+ result.result = overrides.size();
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Result run_batch_jobs() {
+
+ const auto number_jobs = std::size_t( number_rows );
+
+ // The job i writes i and succeeds if i % 4 == 0, and throws otherwise an
+ // std::runtime_error with a message, one with an empty message, or an int
+
+ std::string expected_output;
+ std::string expected_errors;
+ int expected_failed = 0;
+ for( std::size_t i = 0 ; i < number_jobs ; ++i ) {
+  expected_output += std::to_string( i ) + "\n";
+  if( i % 4 == 0 )
+   continue;
+  ++expected_failed;
+  expected_errors += exe + ": ";
+  if( i % 4 == 1 )
+   expected_errors += "job " + std::to_string( i );
+  else if( i % 4 == 3 )
+   expected_errors += "unknown exception";
+  expected_errors += "\n";
+ }
+
+ // run_batch() prints on std::cout and std::cerr, which are captured
+
+ std::ostringstream output;
+ std::ostringstream errors;
+ const auto cout_buffer = std::cout.rdbuf( output.rdbuf() );
+ const auto cerr_buffer = std::cerr.rdbuf( errors.rdbuf() );
+
+ num_threads = number_threads;
+
+ int failed = 0;
+ Result result;
+ result.items = number_jobs;
+ try {
+  result.seconds = get_elapsed_time( [ & ]() {
+   failed = run_batch( number_jobs , []( std::size_t i , std::ostream & out ) {
+    out << i << "\n";
+    if( i % 4 == 1 )
+     throw( std::runtime_error( "job " + std::to_string( i ) ) );
+    if( i % 4 == 2 )
+     throw( std::runtime_error( "" ) );
+    if( i % 4 == 3 )
+     throw( int( i ) );
+   } );
+  } );
+ }
+ catch( ... ) {
+  std::cout.rdbuf( cout_buffer );
+  std::cerr.rdbuf( cerr_buffer );
+  throw;
+ }
+
+ std::cout.rdbuf( cout_buffer );
+ std::cerr.rdbuf( cerr_buffer );
+
+ if( failed != expected_failed )
+  throw( std::logic_error( "run_batch: " + std::to_string( failed ) +
+                           " jobs have failed, but " +
+                           std::to_string( expected_failed ) +
+                           " were expected to." ) );
+
+ if( output.str() != expected_output )
+  throw( std::logic_error( "run_batch: the outputs of the jobs are not the "
+                           "expected ones." ) );
+
+ if( errors.str() != expected_errors )
+  throw( std::logic_error( "run_batch: the errors of the jobs are not the "
+                           "expected ones." ) );
+
+ result.result = failed;
+ return( result );
+}
+
+/*--------------------------------------------------------------------------*/
+
+int main( int argc , char ** argv ) {
+
+ docopt_desc = "SMS++ tools benchmarks.\n";
+ exe = get_filename( argv[ 0 ] );
+ process_benchmark_args( argc , argv );
+
+ std::ofstream output_file;
+ if( ! output_filename.empty() ) {
+  output_file.open( output_filename , std::ios::out );
+  if( ! output_file.is_open() ) {
+   std::cerr << "It was not possible to open the file \"" << output_filename
+             << "\"." << std::endl;
+   exit( 1 );
+  }
+ }
+ std::ostream & output = output_filename.empty() ? std::cout : output_file;
+
+ output << "benchmark,rows,columns,stages,threads,repetition,seconds,"
+        << "items_per_second,result" << std::endl;
+
+ const auto directory = std::filesystem::temp_directory_path() /
+  ( "tools_benchmarks_" + std::to_string( ::getpid() ) );
+
+ try {
+  for( const auto & benchmark : benchmarks ) {
+
+   // Each benchmark has its own engine, so that its workload does not
+   // depend on the other benchmarks that are run
+
+   std::mt19937 engine( seed );
+
+   for( long r = 0 ; r < number_repetitions ; ++r ) {
+
+    std::filesystem::remove_all( directory );
+    std::filesystem::create_directories( directory );
+
+    Result result;
+    if( benchmark == "parallel_cuts" )
+     result = run_cut_processing( true , engine );
+    else if( benchmark == "redundant_cuts" )
+     result = run_cut_processing( false , engine );
+    else if( benchmark == "read_cuts" )
+     result = run_read_cuts( directory , engine );
+    else if( benchmark == "print_cuts" )
+     result = run_print_cuts( directory , engine );
+    else if( benchmark == "cut_archive" )
+     result = run_cut_archive( directory , engine );
+    else if( benchmark == "print_table" )
+     result = run_print_table( directory , engine );
+    else if( benchmark == "profiler_threads" )
+     result = run_profiler_threads();
+    else if( benchmark == "parallel_cuts_check" )
+     result = run_parallel_cuts_check( engine );
+    else if( benchmark == "global_pool" )
+     result = run_global_pool( directory , engine );
+    else if( benchmark == "parameter_sweep" )
+     result = run_parameter_sweep();
+    else
+     result = run_batch_jobs();
+
+    output << benchmark << "," << number_rows << "," << number_columns << ","
+           << number_stages << "," << number_threads << "," << r << ","
+           << std::setprecision( 9 ) << result.seconds << ","
+           << std::setprecision( 9 )
+           << ( result.seconds > 0 ? result.items / result.seconds : 0 )
+           << "," << std::setprecision( 20 ) << result.result << std::endl;
+   }
+  }
+ }
+ catch( const std::exception & e ) {
+  std::cerr << e.what() << std::endl;
+  std::filesystem::remove_all( directory );
+  exit( 1 );
+ }
+
+ std::filesystem::remove_all( directory );
+ return( 0 );
+}
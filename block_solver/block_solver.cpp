@@ -11,6 +11,11 @@
  * (with a problem being a Block/BlockConfig/BlockSolverConfig tuple),
  * it solves each problem with all the loaded solvers.
  *
+ * Several files (or directories, standing for the .nc4 files they contain)
+ * can be given: the configurations and the libraries are then loaded once,
+ * the files are solved concurrently by the number of threads given by the
+ * -j option, and the results are printed in the order of the files.
+ *
  * \author Niccolo' Iardella \n
  *         Dipartimento di Informatica \n
  *         Universita' di Pisa \n
@@ -20,10 +25,14 @@
 
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 
 #ifdef USE_DL
 
 #include <dlfcn.h>
+#include <set>
 
 #endif
 
@@ -44,6 +53,8 @@ using namespace SMSpp_di_unipi_it;
 
 #ifdef USE_DL
 std::vector< void * > dl_handles;
+std::set< std::string > loaded_libraries;
+std::mutex dl_mutex;
 
 const static std::map< std::string, std::string > class_to_lib{
  { "ThermalUnitBlock", "UCBlock" },
@@ -56,12 +67,17 @@ const static std::map< std::string, std::string > class_to_lib{
 void load_library( const std::string & class_name ) {
 
  const std::string & lib = class_to_lib.at( class_name );
+
+ // Each library is only loaded once, whatever the number of files
+ std::lock_guard< std::mutex > lock( dl_mutex );
+ if( ! loaded_libraries.insert( lib ).second )
+  return;
+
  auto lib_path = "lib" + lib + LIBEXT;
  void * handle = dlopen( lib_path.c_str(), RTLD_LAZY );
 
  if( ! handle ) {
-  std::cerr << "Error:" << dlerror();
-  exit( 1 );
+  throw( std::runtime_error( std::string( "Error:" ) + dlerror() ) );
  } else {
   dl_handles.push_back( handle );
  }
@@ -77,45 +93,54 @@ void unload_libraries() {
 
 /*--------------------------------------------------------------------------*/
 
-int main( int argc, char ** argv ) {
+/// A Block to be solved, with its configurations
+struct ProblemData {
+ std::string name;              ///< The name of the problem (if any)
+ Block * block;                 ///< The Block
+ BlockConfig * b_config;        ///< Its BlockConfig (if any)
+ BlockSolverConfig * s_config;  ///< Its BlockSolverConfig (if any)
+};
 
- // Manage options and help, see common_utils.h
- docopt_desc = "SMS++ generic block and problem solver.\n";
- exe = get_filename( argv[ 0 ] );
- process_args( argc, argv );
+/*--------------------------------------------------------------------------*/
+
+/// Reads the Blocks (and their configurations) contained in the given file
+/** The given configurations, if any, are cloned for each Block of a Block
+ * file. This function must be called while holding netcdf_mutex. */
+std::vector< ProblemData > read_problems( const std::string & file,
+                                          BlockConfig * b_config,
+                                          BlockSolverConfig * s_config,
+                                          std::ostream & out ) {
 
  // Read nc4 file
  netCDF::NcFile f;
  try {
-  f.open( filename, netCDF::NcFile::read );
+  f.open( file, netCDF::NcFile::read );
  } catch( netCDF::exceptions::NcException & e ) {
-  std::cerr << exe << ": cannot open nc4 file " << filename << std::endl;
-  exit( 1 );
+  throw( std::runtime_error( "cannot open nc4 file " + file ) );
  }
 
  netCDF::NcGroupAtt gtype = f.getAtt( "SMS++_file_type" );
- if( gtype.isNull() ) {
-  std::cerr << exe << ": "
-            << filename << " is not an SMS++ nc4 file" << std::endl;
-  exit( 1 );
- }
+ if( gtype.isNull() )
+  throw( std::runtime_error( file + " is not an SMS++ nc4 file" ) );
 
  int type;
  gtype.getValues( &type );
 
+ std::vector< ProblemData > problems;
+
  switch( type ) {
 
   case eProbFile: {
    // Problem file containing one or more Block/BlockConfig/BlockSolver sets
 
-   std::cout << filename
-             << " is a problem file, ignoring Block/Solver configurations..."
-             << std::endl;
+   out << file
+       << " is a problem file, ignoring Block/Solver configurations..."
+       << std::endl;
 
-   std::multimap< std::string, netCDF::NcGroup > problems = f.getGroups();
+   std::multimap< std::string, netCDF::NcGroup > groups = f.getGroups();
 
    // For each problem descriptor
-   for( auto & p : problems ) {
+   for( auto & p : groups ) {
 
     // Deserialize block
     auto gb = p.second.getGroup( "Block" );
@@ -127,31 +152,14 @@ int main( int argc, char ** argv ) {
 #endif
     auto block = Block::new_Block( gb );
 
-    // Configure block
+    // Read the configurations
     auto bgc = p.second.getGroup( "BlockConfig" );
-    auto b_config = static_cast< BlockConfig * >( BlockConfig::new_Configuration( bgc ) );
-    if( b_config ) {
-     b_config->apply( block );
-    }
-
-    // Configure solver
     auto bgs = p.second.getGroup( "BlockSolver" );
-    auto s_config = static_cast< BlockSolverConfig * >( BlockSolverConfig::new_Configuration( bgs ) );
-    if( s_config ) {
-#ifdef USE_DL
-     for( const auto & solvername : s_config->get_SolverNames() ) {
-      load_library( solvername );
-     }
-#endif
-     s_config->apply( block );
-    }
-
-    std::cout << "Problem: " << p.first << std::endl;
-
-    // Solve
-    std::cout.setf( std::ios::scientific, std::ios::floatfield );
-    std::cout << std::setprecision( 8 );
-    solve_all( block );
+    problems.push_back( { p.first, block,
+                          static_cast< BlockConfig * >
+                          ( BlockConfig::new_Configuration( bgc ) ),
+                          static_cast< BlockSolverConfig * >
+                          ( BlockSolverConfig::new_Configuration( bgs ) ) } );
    }
    break;
   }
@@ -159,7 +167,7 @@ int main( int argc, char ** argv ) {
   case eBlockFile: {
    // Block file containing one or more Blocks
 
-   std::cout << filename << " is a block file" << std::endl;
+   out << file << " is a block file" << std::endl;
 
    std::multimap< std::string, netCDF::NcGroup > block_groups = f.getGroups();
 
@@ -176,53 +184,120 @@ int main( int argc, char ** argv ) {
 #endif
     auto block = Block::new_Block( gb );
 
-    // Configure block
-    BlockConfig * b_config;
-    if( ! bconf_file.empty() ) {
-     b_config = get_blockconfig( bconf_file );
-     if( b_config == nullptr ) {
-      std::cerr << exe << ": Block configuration not valid" << std::endl;
-      exit( 1 );
-     }
-     b_config->apply( block );
+    // The configurations are the given ones
+    BlockSolverConfig * solver_config;
+    if( s_config )
+     solver_config = s_config->clone();
+    else {
+     out << "Using a default Solver configuration" << std::endl;
+     solver_config = default_configure_solver( solvVerbose );
     }
 
-    // Configure solver
-    BlockSolverConfig * s_config;
-    if( ! sconf_file.empty() ) {
-     s_config = get_blocksolverconfig( sconf_file );
-     if( s_config == nullptr ) {
-      std::cerr << exe << ": Block configuration not valid" << std::endl;
-      exit( 1 );
-     }
-    } else {
-     std::cout << "Using a default Solver configuration" << std::endl;
-     s_config = default_configure_solver( solvVerbose );
-    }
+    problems.push_back( { "", block, b_config ? b_config->clone() : nullptr,
+                          solver_config } );
+   }
+   break;
+  }
+
+  default:
+   throw( std::runtime_error( file + " is not a valid SMS++ file" ) );
+ }
+
+ return( problems );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// Solves all the Blocks contained in the given file
+void solve_file( const std::string & file, BlockConfig * b_config,
+                 BlockSolverConfig * s_config, std::ostream & out ) {
 
+ std::vector< ProblemData > problems;
+ {
+  std::lock_guard< std::mutex > lock( netcdf_mutex );
+  problems = read_problems( file, b_config, s_config, out );
+ }
+
+ for( auto & p : problems ) {
+
+  // Configure block
+  if( p.b_config ) {
+   p.b_config->apply( p.block );
+   p.b_config->clear();
+  }
+
+  // Configure solver
+  if( p.s_config ) {
 #ifdef USE_DL
-    for( const auto & solvername : s_config->get_SolverNames() ) {
-     load_library( solvername );
-    }
+   for( const auto & solvername : p.s_config->get_SolverNames() ) {
+    load_library( solvername );
+   }
 #endif
-    s_config->apply( block );
+   p.s_config->apply( p.block );
+   p.s_config->clear();
+  }
 
-    // Solve
-    std::cout.setf( std::ios::scientific, std::ios::floatfield );
-    std::cout << std::setprecision( 8 );
-    solve_all( block );
-   }
-   break;
+  if( ! p.name.empty() )
+   out << "Problem: " << p.name << std::endl;
+
+  // Solve
+  out.setf( std::ios::scientific, std::ios::floatfield );
+  out << std::setprecision( 8 );
+  solve_all( p.block, out );
+
+  // Destroy the Block and the Configurations
+  if( p.b_config ) {
+   p.b_config->apply( p.block );
+   delete( p.b_config );
   }
+  if( p.s_config ) {
+   p.s_config->apply( p.block );
+   delete( p.s_config );
+  }
+  delete( p.block );
+ }
+}
 
-  default:
-   std::cerr << exe << ": "
-             << filename << " is not a valid SMS++ file" << std::endl;
+/*--------------------------------------------------------------------------*/
+
+int main( int argc, char ** argv ) {
+
+ // Manage options and help, see common_utils.h
+ docopt_desc = "SMS++ generic block and problem solver.\n";
+ exe = get_filename( argv[ 0 ] );
+ process_args( argc, argv );
+
+ // Read the configurations (once for all files)
+ BlockConfig * b_config = nullptr;
+ if( ! bconf_file.empty() ) {
+  b_config = get_blockconfig( bconf_file );
+  if( b_config == nullptr ) {
+   std::cerr << exe << ": Block configuration not valid" << std::endl;
+   exit( 1 );
+  }
+ }
+
+ BlockSolverConfig * s_config = nullptr;
+ if( ! sconf_file.empty() ) {
+  s_config = get_blocksolverconfig( sconf_file );
+  if( s_config == nullptr ) {
+   std::cerr << exe << ": Solver configuration not valid" << std::endl;
    exit( 1 );
+  }
  }
 
+ // Solve each file, possibly concurrently, see common_utils.h
+ const auto number_failed = run_batch
+  ( filenames.size(), [ b_config, s_config ]( std::size_t i,
+                                              std::ostream & out ) {
+     solve_file( filenames[ i ], b_config, s_config, out );
+    } );
+
+ delete( b_config );
+ delete( s_config );
+
 #ifdef USE_DL
  unload_libraries();
 #endif
- return( 0 );
+ return( number_failed ? 1 : 0 );
 }
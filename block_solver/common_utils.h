@@ -19,7 +19,16 @@
 #define __COMMON_UTILS
 
 #include <getopt.h> // For getting command line parameters
+#include <algorithm>
+#include <atomic>
 #include <chrono>   // For measuring compute time
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 #include <Block.h>
 #include <RBlockConfig.h>
@@ -44,7 +53,9 @@ using namespace SMSpp_di_unipi_it;
  * @{
  */
 
-std::string filename{};    ///< Input filename
+std::string filename{};    ///< Input filename (the first one, in batch mode)
+std::vector< std::string > filenames{}; ///< All input filenames
+long num_threads = 1;      ///< Number of files solved concurrently
 std::string bconf_file{};  ///< BlockConfig filename
 std::string sconf_file{};  ///< BlockSolverConfig filename
 bool solvVerbose = false;  ///< If the solver should be verbose
@@ -63,6 +74,11 @@ int solution_output_type = 1;
  * - solution_output_type = 3, then the solution is output to both the screen
  *   and file(s);
  */
+
+/// Mutex protecting every access to a netCDF file
+/** The netCDF-C library is not thread-safe: in batch mode, the files are
+ * read (and the problems are written) by one thread at a time. */
+std::mutex netcdf_mutex;
 /// @}
 
 /*--------------------------------------------------------------------------*/
@@ -82,7 +98,7 @@ void docopt() {
  // http://docopt.org
  std::cout << docopt_desc << std::endl;
  std::cout << "Usage:\n"
-           << "  " << exe << " [options] <file>\n"
+           << "  " << exe << " [options] <file>...\n"
            << "  " << exe << " -h | --help\n"
            << std::endl
            << "Options:\n"
@@ -91,12 +107,17 @@ void docopt() {
            << "  -n, --nc4problem <file>  Write nc4 problem on file.\n"
            << "  -v, --verbose            Make the solver verbose.\n"
            << "  -o, --output <type>      Solution output type (0 none, 1 screen, 2 files, 3 both).\n"
+           << "  -j, --threads <number>   Number of files solved concurrently.\n"
            << "  -h, --help               Print this help.\n";
 }
 
 /*--------------------------------------------------------------------------*/
 
 /// Processes the command line arguments
+/** The arguments that follow the options are the input files. A directory
+ * stands for all the .nc4 files it contains, in lexicographic order. If there
+ * is more than one input file, the tool runs in batch mode (see
+ * run_batch()). */
 void process_args( int argc, char ** argv ) {
 
  if( argc < 2 ) {
@@ -105,11 +126,12 @@ void process_args( int argc, char ** argv ) {
   exit( 1 );
  }
 
- const char * const short_opts = "B:S:o:nvh";
+ const char * const short_opts = "B:S:o:j:nvh";
  const option long_opts[] = {
   { "blockcfg",   required_argument, nullptr, 'B' },
   { "solvercfg",  required_argument, nullptr, 'S' },
   { "output",     required_argument, nullptr, 'o' },
+  { "threads",    required_argument, nullptr, 'j' },
   { "nc4problem", no_argument,       nullptr, 'n' },
   { "verbose",    no_argument,       nullptr, 'v' },
   { "help",       no_argument,       nullptr, 'h' },
@@ -140,6 +162,15 @@ void process_args( int argc, char ** argv ) {
     solution_output_type = s.front() - '0';
     break;
    }
+   case 'j': {
+    char * end = nullptr;
+    num_threads = std::strtol( optarg, &end, 10 );
+    if( ( end && *end ) || num_threads < 0 ) {
+     std::cout << "The number of threads must be a nonnegative integer.\n";
+     exit( 1 );
+    }
+    break;
+   }
    case 'n':
     writeprob = true;
     break;
@@ -156,14 +187,31 @@ void process_args( int argc, char ** argv ) {
   }
  }
 
- // Last argument
- if( optind < argc ) {
-  filename = std::string( argv[ optind ] );
- } else {
+ // Remaining arguments
+ for( ; optind < argc ; ++optind ) {
+  const std::filesystem::path path( argv[ optind ] );
+
+  if( ! std::filesystem::is_directory( path ) ) {
+   filenames.push_back( path.string() );
+   continue;
+  }
+
+  std::vector< std::string > directory_files;
+  for( const auto & entry : std::filesystem::directory_iterator( path ) )
+   if( entry.is_regular_file() && entry.path().extension() == ".nc4" )
+    directory_files.push_back( entry.path().string() );
+  std::sort( directory_files.begin(), directory_files.end() );
+  filenames.insert( filenames.end(), directory_files.begin(),
+                    directory_files.end() );
+ }
+
+ if( filenames.empty() ) {
   std::cout << exe << ": no input file\n"
             << "Try " << exe << "' --help' for more information.\n";
   exit( 1 );
  }
+
+ filename = filenames.front();
 }
 
 /*--------------------------------------------------------------------------*/
@@ -183,27 +231,27 @@ BlockSolverConfig * default_configure_solver( int verbose ) {
 /*--------------------------------------------------------------------------*/
 
 /// Prints the status in a human-readable form
-void print_status( int status ) {
- std::cout << "Status = " << status << " (";
+void print_status( int status, std::ostream & out = std::cout ) {
+ out << "Status = " << status << " (";
 
  switch( status ) {
   case Solver::kOK:
-   std::cout << "Success)" << std::endl;
+   out << "Success)" << std::endl;
    break;
   case Solver::kError:
-   std::cout << "Error)" << std::endl;
+   out << "Error)" << std::endl;
    break;
   case Solver::kInfeasible:
-   std::cout << "Infeasible)" << std::endl;
+   out << "Infeasible)" << std::endl;
    break;
   case Solver::kUnbounded:
-   std::cout << "Unbounded)" << std::endl;
+   out << "Unbounded)" << std::endl;
    break;
   case Solver::kStopTime:
-   std::cout << "Stopped for time limit)" << std::endl;
+   out << "Stopped for time limit)" << std::endl;
    break;
   case Solver::kStopIter:
-   std::cout << "Stopped for iteration limit)" << std::endl;
+   out << "Stopped for iteration limit)" << std::endl;
    break;
   default:;
  }
@@ -212,27 +260,27 @@ void print_status( int status ) {
 /*--------------------------------------------------------------------------*/
 
 /// Solves the problem with all available solvers
-void solve_all( Block * block ) {
+void solve_all( Block * block, std::ostream & out = std::cout ) {
  std::chrono::time_point< std::chrono::system_clock > start, end;
 
  for( auto solver : block->get_registered_solvers() ) {
-  std::cout << "Solver: " << solver->classname() << std::endl;
+  out << "Solver: " << solver->classname() << std::endl;
 
   start = std::chrono::system_clock::now();
   auto status = solver->compute();
   end = std::chrono::system_clock::now();
   std::chrono::duration< double > compute_time = end - start;
-  std::cout << "Elapsed time: " << compute_time.count() << " s" << std::endl;
+  out << "Elapsed time: " << compute_time.count() << " s" << std::endl;
 
   auto ub = solver->get_ub();
   auto lb = solver->get_lb();
-  print_status( status );
-  std::cout << "Upper bound = " << ub << std::endl;
-  std::cout << "Lower bound = " << lb << std::endl;
+  print_status( status, out );
+  out << "Upper bound = " << ub << std::endl;
+  out << "Lower bound = " << lb << std::endl;
 
 #ifndef NDEBUG
   solver->get_var_solution();
-  std::cout << "O.F. value  = " << solver->get_var_value() << std::endl;
+  out << "O.F. value  = " << solver->get_var_value() << std::endl;
 #endif
  }
 }
@@ -294,12 +342,15 @@ BlockSolverConfig * get_blocksolverconfig( const std::string & conf_file ) {
 /*--------------------------------------------------------------------------*/
 
 /// Writes a new nc4 problem using the block and its configurations
+/** The problem is written into the file whose name is obtained by replacing
+ * the extension of \p input_file with "_problem.nc4". */
 void write_nc4problem( Block * block,
                        BlockConfig * b_config,
-                       BlockSolverConfig * s_config ) {
+                       BlockSolverConfig * s_config,
+                       const std::string & input_file = filename ) {
 
- std::size_t found = filename.find_last_of( '.' );
- std::string nc4_file = filename.substr( 0, found ) + "_problem.nc4";
+ std::size_t found = input_file.find_last_of( '.' );
+ std::string nc4_file = input_file.substr( 0, found ) + "_problem.nc4";
 
  netCDF::NcFile outfile;
  try {
@@ -327,5 +378,99 @@ void write_nc4problem( Block * block,
 
 /*--------------------------------------------------------------------------*/
 
+/// Runs the given jobs concurrently and prints their outputs in order
+/** Runs job( i, out ) for each i in [ 0, number_jobs ) by means of at most
+ * num_threads threads (as many as the hardware threads if num_threads is
+ * 0). Each job writes into its own stream, which is printed on std::cout as
+ * soon as the outputs of all the previous jobs have been printed, so that
+ * the outputs appear in the order of the jobs. If a job throws an
+ * exception (of any type), its message (if any) is printed on std::cerr
+ * after its output; a job fails even if the message is empty. If there
+ * is a single job, it is run by the calling thread and writes directly on
+ * std::cout.
+ *
+ * @return the number of jobs that have thrown an exception. */
+int run_batch( std::size_t number_jobs,
+               const std::function< void( std::size_t,
+                                          std::ostream & ) > & job ) {
+
+ if( number_jobs == 1 ) {
+  try {
+   job( 0, std::cout );
+  } catch( const std::exception & e ) {
+   std::cerr << exe << ": " << e.what() << std::endl;
+   return( 1 );
+  } catch( ... ) {
+   std::cerr << exe << ": unknown exception" << std::endl;
+   return( 1 );
+  }
+  return( 0 );
+ }
+
+ std::vector< std::string > outputs( number_jobs );
+ std::vector< std::string > errors( number_jobs );
+ std::vector< char > done( number_jobs, false );
+ std::vector< char > failed( number_jobs, false );
+ std::mutex mutex;
+ std::condition_variable finished;
+ std::atomic< std::size_t > next_job( 0 );
+
+ auto worker = [ & ]() {
+  for( std::size_t i ; ( i = next_job++ ) < number_jobs ; ) {
+   std::ostringstream out;
+   std::string error;
+   bool has_failed = true;
+   try {
+    job( i, out );
+    has_failed = false;
+   } catch( const std::exception & e ) {
+    error = e.what();
+   } catch( ... ) {
+    error = "unknown exception";
+   }
+   {
+    std::lock_guard< std::mutex > lock( mutex );
+    outputs[ i ] = out.str();
+    errors[ i ] = std::move( error );
+    failed[ i ] = has_failed;
+    done[ i ] = true;
+   }
+   finished.notify_one();
+  }
+ };
+
+ auto number_threads = std::size_t( num_threads );
+ if( number_threads == 0 )
+  number_threads = std::max( 1u, std::thread::hardware_concurrency() );
+ number_threads = std::min( number_threads, number_jobs );
+
+ std::vector< std::thread > threads;
+ for( std::size_t t = 0 ; t < number_threads ; ++t )
+  threads.emplace_back( worker );
+
+ int number_failed = 0;
+ for( std::size_t i = 0 ; i < number_jobs ; ++i ) {
+  std::unique_lock< std::mutex > lock( mutex );
+  finished.wait( lock, [ & ]() { return( done[ i ] ); } );
+  const auto output = std::move( outputs[ i ] );
+  const auto error = std::move( errors[ i ] );
+  const bool has_failed = failed[ i ];
+  lock.unlock();
+
+  std::cout << output << std::flush;
+  if( has_failed ) {
+   std::cerr << exe << ": " << error << std::endl;
+   ++number_failed;
+  }
+ }
+
+ for( auto & thread : threads )
+  thread.join();
+
+ return( number_failed );
+}
+
+/*--------------------------------------------------------------------------*/
+
 
 #endif //__COMMON_UTILS
@@ -20,28 +20,40 @@
 #include "BendersBFunction.h"
 #include "BendersBlock.h"
 #include "BlockSolverConfig.h"
+#include "CutSet.h"
 #include "DCNetworkBlock.h"
 #include "FRealObjective.h"
 #include "Observer.h"
 #include "OneVarConstraint.h"
+#include "Profiler.h"
 #include "RBlockConfig.h"
 #include "IntermittentUnitBlock.h"
 #include "InvestmentFunction.h"
+#include "NetCDFSolutionOutput.h"
 #include "SDDPBlock.h"
 #include "SDDPBlockSolutionOutput.h"
 #include "SDDPGreedySolver.h"
 #include "SMSTypedefs.h"
+#include "SolutionWriter.h"
 #include "ThermalUnitBlock.h"
 #include "UCBlock.h"
 
+#include <chrono>
 #include <cmath>
+#include <filesystem>
 #include <functional>
+#include <memory>
 #include <queue>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#ifdef USE_MPI
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#endif
+
 /*--------------------------------------------------------------------------*/
 /*------------------------- NAMESPACE AND USING ----------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -57,6 +69,21 @@ using namespace SMSpp_di_unipi_it;
 SMSpp_insert_in_factory_cpp_1( InvestmentFunction );
 SMSpp_insert_in_factory_cpp_1( InvestmentFunctionState );
 
+/*--------------------------------------------------------------------------*/
+/*------------------------------ SolutionSet -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+class InvestmentFunction::SolutionSet {
+
+public:
+
+ std::vector< SDDPBlockSolutionOutput::Solution > solutions;
+ ///< the solution of each sampled scenario
+ /**< solutions[ k ] is the solution of the k-th sampled scenario, which is
+  * empty (it has no Table) if it has not been evaluated by this process. */
+
+}; // end( class( SolutionSet ) )
+
 /*--------------------------------------------------------------------------*/
 /*---------------------------------TODO-------------------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -85,6 +112,7 @@ InvestmentFunction::InvestmentFunction
  v_asset_type = std::move( asset_type );
  v_cost = std::move( cost );
  v_disinvestment_cost = std::move( disinvestment_cost );
+ v_stage_map.clear(); // the StageMaps must be rebuilt
 
  f_violated_constraint = { Inf< Index >() , eLHS };
 
@@ -94,12 +122,14 @@ InvestmentFunction::InvestmentFunction
 
  f_compute_linearization = get_dflt_int_par( intComputeLinearization );
  AAccMlt = get_dflt_dbl_par( dblAAccMlt );
+ f_investment_update_tolerance = get_dflt_dbl_par( dblInvestmentUpdateTol );
  set_par( intGPMaxSz , C05Function::get_dflt_int_par( intGPMaxSz ) );
 }
 
 /*--------------------------------------------------------------------------*/
 
 InvestmentFunction::~InvestmentFunction() {
+ f_solution_writer.reset();  // stops the writer thread (see compute())
  for( auto block : v_Block )
   delete( block );
 }
@@ -172,6 +202,8 @@ void InvestmentFunction::deserialize( const netCDF::NcGroup & group ,
                              " 1, or 'NumAssets'." ) );
   }
 
+  v_stage_map.clear(); // the StageMaps must be rebuilt
+
   // Deserialize the lower bound on the active variables
 
   ::deserialize( group , "LowerBound" , { num_assets } , v_lower_bound ,
@@ -457,6 +489,7 @@ void InvestmentFunction::set_variables( VarVector && x ) {
 
  v_x = std::move( x );
  f_blocks_are_updated = false;
+ v_stage_map.clear(); // the StageMaps must be rebuilt
 }  // end( InvestmentFunction::set_variables )
 
 /*--------------------------------------------------------------------------*/
@@ -472,6 +505,51 @@ void InvestmentFunction::set_par( const idx_type par , const int value ) {
    f_output_solution = value;
    break;
 
+  case( intDistributeScenarios ):
+   f_distribute_scenarios = value;
+   break;
+
+  case( intEvaluationCacheSize ):
+   if( value < 0 )
+    throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                  "intEvaluationCacheSize must be "
+                                  "non-negative" ) );
+   evaluation_cache.set_capacity( value );
+   break;
+
+  case( intScenarioSampleSize ):
+   if( value < 0 )
+    throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                  "intScenarioSampleSize must be "
+                                  "non-negative" ) );
+   f_scenario_sample_size = value;
+   f_current_sample_size = value;
+   break;
+
+  case( intScenarioSampleSeed ):
+   f_scenario_sample_seed = value;
+   scenario_sample_engine.seed( value );
+   break;
+
+  case( intWarmStart ):
+   f_warm_start = value;
+   if( ! f_warm_start )
+    v_scenario_state.clear();
+   break;
+
+  case( intKeepSolutions ):
+   f_keep_solutions = value;
+   if( ! f_keep_solutions )
+    f_kept_solutions.reset();
+   break;
+
+  case( intScenarioSchedule ):
+   if( ( value < eStaticSchedule ) || ( value > eCostSchedule ) )
+    throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                  "intScenarioSchedule must be 0, 1, or 2" ) );
+   f_scenario_schedule = value;
+   break;
+
   case( intGPMaxSz ): {
    if( value < 0 )
     throw( std::invalid_argument( "InvestmentFunction::set_par: intGPMaxSz "
@@ -690,7 +768,7 @@ void InvestmentFunction::remove_variable( Index i , ModParam issueMod ) {
  v_asset_type.erase( v_asset_type.begin() + i );
 
  f_blocks_are_updated = false;
- generator_node_map.clear(); // the generator map must be rebuilt
+ v_stage_map.clear(); // the StageMaps must be rebuilt
 
  if( ( ! f_Observer ) || ( ! f_Observer->issue_mod( issueMod ) ) )
   return;
@@ -714,7 +792,7 @@ void InvestmentFunction::remove_variables( Range range , ModParam issueMod ) {
   return;
 
  f_blocks_are_updated = false;
- generator_node_map.clear(); // the generator map must be rebuilt
+ v_stage_map.clear(); // the StageMaps must be rebuilt
 
  if( ( range.first == 0 ) && ( range.second == Index( v_x.size() ) ) ) {
   // removing *all* Variables
@@ -839,7 +917,7 @@ void InvestmentFunction::remove_variables( Subset && indices , bool ordered ,
   v_disinvestment_cost.clear();
 
   f_blocks_are_updated = false;
-  generator_node_map.clear(); // the generator map must be rebuilt
+  v_stage_map.clear(); // the StageMaps must be rebuilt
 
   // Now issue the Modification: note that the subset is empty.
   // An InvestmentFunction is strongly quasi-additive, and indices is ordered.
@@ -861,7 +939,7 @@ void InvestmentFunction::remove_variables( Subset && indices , bool ordered ,
                                 "Variable index in the Subset indices." ) );
 
  f_blocks_are_updated = false;
- generator_node_map.clear(); // the generator map must be rebuilt
+ v_stage_map.clear(); // the StageMaps must be rebuilt
 
  const auto erase = [ this , &indices ]() {
   compact( v_asset_indices , indices );
@@ -962,6 +1040,8 @@ void InvestmentFunction::serialize( netCDF::NcGroup & group ) const {
 
 int InvestmentFunction::compute( bool changedvars ) {
 
+ Profiler::ScopedTimer compute_timer( "InvestmentFunction::compute" );
+
  if( ( ! changedvars ) && f_blocks_are_updated ) {
   // TODO We need another flag telling whether the sub-Block has changed since
   // the last call.
@@ -969,6 +1049,11 @@ int InvestmentFunction::compute( bool changedvars ) {
   return( f_status ); //  nothing changed since last call, nothing to do
  }
 
+ // If the scenarios are distributed among processes, all of them must
+ // evaluate the function at the same point.
+
+ broadcast_variable_values();
+
  output_variable_values();
 
  reset_linearization();
@@ -989,59 +1074,114 @@ int InvestmentFunction::compute( bool changedvars ) {
   throw( std::logic_error( "InvestmentFunction::compute: there must be at "
                            "least one sub-Block, but there is none." ) );
 
+ // Look for the current point in the evaluation cache. The cache is not
+ // used if the solutions must be output, since they would not be produced.
+
+ const bool use_evaluation_cache =
+  ( evaluation_cache.get_capacity() > 0 ) && ( ! f_output_solution );
+
+ if( ! f_blocks_are_updated )
+  // The sub-Blocks may have changed: the cached evaluations may be wrong.
+  evaluation_cache.clear();
+
+ std::vector< double > cache_key;
+
+ if( use_evaluation_cache ) {
+  std::vector< double > x( v_x.size() );
+  for( Index i = 0 ; i < v_x.size() ; ++i )
+   x[ i ] = get_var_value( i , false );
+  cache_key = evaluation_cache.get_key( std::move( x ) );
+
+  const auto entry = evaluation_cache.find( cache_key );
+  if( entry && ( entry->has_linearization || ( ! f_compute_linearization ) ) ) {
+   // An evaluation at this point is available: use it.
+   f_value = entry->value;
+   if( f_compute_linearization )
+    v_linearization = entry->linearization;
+   v_scenario_value = entry->scenario_value;
+   f_has_diagonal_linearization = f_compute_linearization;
+   // only full evaluations are cached
+   f_linearization_is_sampled = false;
+   f_standard_error = 0;
+   f_number_sampled_scenarios = get_number_scenarios();
+   f_has_value = true;
+   output_function_value();
+   f_status = kOK;
+   handle_events( eBeforeTermination );
+   return( f_status );
+  }
+ }
+
  // For the InvestmentFunction to be correctly computed, the inner Block
  // cannot be modified by other entities. Therefore, the inner Block must be
  // locked.
 
- std::vector< bool > owned( v_Block.size() );
+ // This variable indicates whether the loop over the scenarios must be
+ // interrupted. The loop is interrupted when the sub-Blocks cannot be locked
+ // or updated, when a solution for a subproblem is not found or when an
+ // error occurs while updating the linearization. Even then, this process
+ // goes through the loop (doing nothing) up to the point where all the
+ // processes agree on whether the loop has been interrupted, so that all of
+ // them take part in the same collective operations and return the same
+ // status.
+ bool interrupt_loop = false;
+
+ // The sub-Blocks that are locked by this function (those that it already
+ // owns are not), and the identities of their Solvers
+
+ std::vector< bool > locked( v_Block.size() , false );
+ std::vector< void * > solver_ids( v_Block.size() , nullptr );
+ std::vector< bool > lent_id( v_Block.size() , false );
 
  // Try to lock the inner Blocks.
  for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-  owned[ i ] = v_Block[ i ]->is_owned_by( f_id );
-  if( ( ! owned[ i ] ) && ( ! v_Block[ i ]->lock( f_id ) ) ) {
-   f_value = worst_value();
-   output_function_value();
-   f_status = kError; // If this does not work, this is clearly an error.
-   handle_events( eBeforeTermination );
-   return( f_status );
+  if( v_Block[ i ]->is_owned_by( f_id ) )
+   continue;
+  if( ! v_Block[ i ]->lock( f_id ) ) {
+   // If this does not work, this is clearly an error.
+   interrupt_loop = true;
+   break;
   }
+  locked[ i ] = true;
  }
 
  // Since the inner Solver may need to lock the inner Block, the
  // InvestmentFunction lends its identity to the inner Solver.
 
- std::vector< void * > solver_ids( v_Block.size() );
- for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-  if( auto solver = get_solver( i ) ) {
-   solver_ids[ i ] = solver->id();
-   solver->set_id( f_id );
+ if( ! interrupt_loop )
+  for( Index i = 0 ; i < v_Block.size() ; ++i ) {
+   if( auto solver = get_solver( i ) ) {
+    solver_ids[ i ] = solver->id();
+    solver->set_id( f_id );
+    lent_id[ i ] = true;
+   }
   }
- }
 
- if( generator_node_map.empty() )
-  build_generator_node_map();
+ // Gives the Solvers their identities back and unlocks the inner Blocks
+ auto release_blocks = [ & ]() {
+  for( Index i = 0 ; i < v_Block.size() ; ++i ) {
+   if( lent_id[ i ] )
+    get_solver( i )->set_id( solver_ids[ i ] );
+   if( locked[ i ] )
+    v_Block[ i ]->unlock( f_id );  // unlock the inner Block
+  }
+ };
+
+ if( ( ! interrupt_loop ) && v_stage_map.empty() )
+  build_stage_maps();
 
- if( changedvars || ( ! f_blocks_are_updated ) ) {
+ if( ( ! interrupt_loop ) && ( changedvars || ( ! f_blocks_are_updated ) ) ) {
   // Update the Blocks.
 
   try {
+   Profiler::ScopedTimer timer( "update_blocks" );
    update_blocks();
   }
   catch( const std::exception & e ) {
-   // An error occurred whule updating the Blocks.
-   for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-    if( auto solver = get_solver( i ) )
-     solver->set_id( solver_ids[ i ] );
-    if( ! owned[ i ] )
-     v_Block[ i ]->unlock( f_id );  // unlock the inner Block
-   }
+   // An error occurred while updating the Blocks.
    std::cerr << "InvestmentFunction::compute(): an error occurred while "
     "updating the Blocks: '" << e.what() << "'" << std::endl;
-   f_value = worst_value();
-   output_function_value();
-   f_status = kError;
-   handle_events( eBeforeTermination );
-   return( f_status );
+   interrupt_loop = true;
   }
  }
 
@@ -1053,26 +1193,172 @@ int InvestmentFunction::compute( bool changedvars ) {
 
  f_status = kUnEval;
 
- // This variable indicates whether the loop over the scenarios must be
- // interrupted. The loop is interrupted when either a solution for a
- // subproblem is not found or when an error occurs while updating the
- // linearization.
- bool interrupt_loop = false;
-
  int error_status = kError;
 
+ // Make sure the pool of sub-Blocks is aware of all sub-Blocks
+
+ sub_block_pool.resize( v_Block.size() );
+
+ // Each sub-Block accumulates the linearizations of the scenarios it solves
+ // in its own buffer. Since a sub-Block is used by a single thread at a time,
+ // these buffers can be updated without any synchronization. They are summed
+ // up into v_linearization once all scenarios have been evaluated.
+
+ if( f_compute_linearization )
+  v_sub_block_linearization.assign
+   ( v_Block.size() , std::vector< double >( v_linearization.size() , 0 ) );
+
  auto simulation_value = decltype( f_value )( 0 );
 
- #pragma omp parallel for reduction( + : simulation_value )
- for( int scenario = 0 ; scenario < int( num_scenarios ) ; ++scenario ) {
+ // The value of each scenario
+ std::vector< double > scenario_value( num_scenarios , 0 );
+
+ // The scenarios that are evaluated
+ const auto scenarios = sample_scenarios();
+ const auto num_sampled_scenarios = scenarios.size();
+
+ // Make room for the States of the Solvers of every scenario
+
+ if( f_warm_start )
+  v_scenario_state.resize( num_scenarios );
+
+ // Make room for the time taken by every scenario
+
+ v_scenario_time.resize( num_scenarios , -1 );
+
+ // This process only evaluates the scenarios whose index modulo num_ranks
+ // is equal to its rank (all of them, if the scenarios are not distributed),
+ // in the order given by schedule_scenarios().
+
+ const auto rank_and_size = get_process_rank_and_size();
+ const int rank = rank_and_size.first;
+ const int num_ranks = rank_and_size.second;
+
+ const auto order = schedule_scenarios( scenarios , rank , num_ranks );
+
+ // Possibly create the netCDF file into which the solutions are output and
+ // use the SolutionWriter that outputs them (into that file or into CSV
+ // files) in the background, so that the sub-Blocks are unlocked as soon as
+ // the solutions have been copied. At most one solution per sub-Block can
+ // be waiting to be written. The SolutionWriter (with its thread and the
+ // solutions it recycles) is kept from one call to the next, and is only
+ // created again if the number of sub-Blocks changes.
+
+ SolutionWriter * solution_writer = nullptr;
+
+ // If the solutions must be kept, they are copied into a SolutionSet (the
+ // previous one, unless it is shared, so that its memory is reused), with a
+ // slot for each sampled scenario, and nothing is output.
+
+ std::shared_ptr< SolutionSet > kept_solutions;
+
+ // Nothing is output if the loop has already been interrupted.
+
+ if( ( ! interrupt_loop ) && f_output_solution && f_keep_solutions ) {
+  if( f_kept_solutions && ( f_kept_solutions.use_count() == 1 ) )
+   kept_solutions = std::move( f_kept_solutions );
+  else
+   kept_solutions = std::make_shared< SolutionSet >();
+  f_kept_solutions.reset();
+  kept_solutions->solutions.resize( num_sampled_scenarios );
+  for( auto & solution : kept_solutions->solutions )
+   solution.number_tables = 0;
+ }
+ else if( ( ! interrupt_loop ) && f_output_solution ) {
+  if( ! f_netcdf_output )
+   f_netcdf_output = std::make_unique< NetCDFSolutionOutput >();
+
+  if( ! f_solution_filename.empty() )
+   f_netcdf_output->open( get_solution_filename() );
+
+  if( ( ! f_solution_writer ) ||
+      ( f_solution_writer_capacity != v_Block.size() ) ) {
+   f_solution_writer.reset();
+   f_solution_writer = std::make_unique< SolutionWriter >
+    ( [ this , output = SDDPBlockSolutionOutput() ]
+      ( const SolutionWriter::Solution & solution ) {
+      Profiler::ScopedTimer timer( "write_solution" , solution.scenario );
+      if( f_netcdf_output->is_open() )
+       f_netcdf_output->print( solution );
+      else
+       output.print( solution );
+     } , v_Block.size() );
+   f_solution_writer_capacity = v_Block.size();
+  }
+  solution_writer = f_solution_writer.get();
+ }
+
+ // The snapshots of each sub-Block are taken by its own
+ // SDDPBlockSolutionOutput, which is kept from one call to the next.
+
+ if( kept_solutions || solution_writer ) {
+  v_solution_output.resize( v_Block.size() );
+  for( auto & output : v_solution_output )
+   if( ! output )
+    output = std::make_unique< SDDPBlockSolutionOutput >();
+ }
+
+ // The schedule of the loop is set at run time, according to
+ // intScenarioSchedule. The previous schedule is restored afterwards.
+
+#ifdef _OPENMP
+ omp_sched_t saved_schedule_kind;
+ int saved_schedule_chunk;
+ omp_get_schedule( & saved_schedule_kind , & saved_schedule_chunk );
+ if( f_scenario_schedule == eStaticSchedule )
+  omp_set_schedule( omp_sched_static , 0 );
+ else
+  omp_set_schedule( omp_sched_dynamic , 1 );
+#endif
+
+ #pragma omp parallel for schedule( runtime ) reduction( + : simulation_value )
+ for( int j = 0 ; j < int( order.size() ) ; ++j ) {
 
   if( interrupt_loop )
    continue;
 
+  const auto k = order[ j ];
+  const auto scenario = scenarios[ k ];
+
+  Profiler::ScopedTimer lock_timer( "lock_sub_block" , scenario );
   const auto sub_block_index = lock_sub_block();
+  lock_timer.stop();
+
+  // Possibly give the sub-Block the cuts shared by all sub-Blocks, if it
+  // has not received them yet (see share_cuts())
+
+  if( ! v_has_shared_cuts[ sub_block_index ] ) {
+   try {
+    Profiler::ScopedTimer timer( "install_shared_cuts" , scenario );
+    f_shared_cuts->apply_to( get_sddp_block( sub_block_index ) );
+    v_has_shared_cuts[ sub_block_index ] = 1;
+   }
+   catch( const std::exception & e ) {
+    std::cout << "InvestmentFunction::compute(): an error occurred while "
+     "installing the shared cuts: '" << e.what() << "'" << std::endl;
+    unlock_sub_block( sub_block_index );
+    #pragma omp critical( InvestmentFunction )
+    {
+     error_status = kError;
+     interrupt_loop = true;
+    }
+    continue;
+   }
+  }
+
   auto solver = get_solver( sub_block_index );
-  solver->set_par( SDDPGreedySolver::intScenarioId , scenario );
+  solver->set_par( SDDPGreedySolver::intScenarioId , int( scenario ) );
+  restore_scenario_states( scenario , sub_block_index );
+
+  Profiler::ScopedTimer solve_timer( "solve_scenario" , scenario );
+  const auto solve_start = std::chrono::steady_clock::now();
   const auto status = solver->compute( true );
+  const std::chrono::duration< double > solve_time =
+   std::chrono::steady_clock::now() - solve_start;
+  solve_timer.stop();
+
+  // Each scenario is evaluated by a single thread
+  v_scenario_time[ scenario ] = solve_time.count();
 
   if( ! solver->has_var_solution() ) {
    unlock_sub_block( sub_block_index );
@@ -1085,12 +1371,10 @@ int InvestmentFunction::compute( bool changedvars ) {
   }
 
   try {
-   #pragma omp critical( InvestmentFunction )
-   {
-    f_status = status;
-    if( f_compute_linearization )
-     update_linearization( sub_block_index );
-   }
+   Profiler::ScopedTimer timer( "update_linearization" , scenario );
+   if( f_compute_linearization )
+    update_linearization( sub_block_index ,
+                          v_sub_block_linearization[ sub_block_index ] );
   }
   catch( const std::exception & e ) {
    // An error occurred while updating the linearization.
@@ -1105,35 +1389,95 @@ int InvestmentFunction::compute( bool changedvars ) {
    continue;
   }
 
+  #pragma omp critical( InvestmentFunction )
+  {
+   f_status = status;
+  }
+
   // Update the function value
 
-  simulation_value += solver->get_var_value();
+  scenario_value[ scenario ] = solver->get_var_value();
+  simulation_value += scenario_value[ scenario ];
 
-  // Possibly output the solution
+  // Possibly keep the States of the Solvers for the next evaluation
 
-  if( f_output_solution )
-   SDDPBlockSolutionOutput().print( get_sddp_block( sub_block_index ) ,
-                                    scenario , true );
+  save_scenario_states( scenario , sub_block_index );
 
-  // Unlock the sub-Block
+  // Possibly take a snapshot of the solution, unlock the sub-Block, and
+  // hand the snapshot over to the SolutionWriter
 
-  unlock_sub_block( sub_block_index );
+  Profiler::ScopedTimer output_timer( "output_solution" , scenario );
+
+  if( kept_solutions ) {
+   v_solution_output[ sub_block_index ]->snapshot
+    ( get_sddp_block( sub_block_index ) , scenario ,
+      kept_solutions->solutions[ k ] );
+   unlock_sub_block( sub_block_index );
+  }
+  else if( solution_writer ) {
+   auto solution = solution_writer->take();
+   v_solution_output[ sub_block_index ]->snapshot
+    ( get_sddp_block( sub_block_index ) , scenario , solution );
+   unlock_sub_block( sub_block_index );
+   solution_writer->push( std::move( solution ) );
+  }
+  else
+   unlock_sub_block( sub_block_index );
 
  } // end( for each scenario )
 
+#ifdef _OPENMP
+ omp_set_schedule( saved_schedule_kind , saved_schedule_chunk );
+#endif
+
+ // The shared cuts are no longer needed once every sub-Block has them
+
+ if( f_shared_cuts &&
+     std::find( v_has_shared_cuts.begin() , v_has_shared_cuts.end() , 0 ) ==
+     v_has_shared_cuts.end() )
+  f_shared_cuts.reset();
+
+ // Wait until all solutions are written. The netCDF file is closed so that
+ // it can be read (e.g., copied) even if the loop has been interrupted. An
+ // error while writing the solutions does not affect the evaluation.
+
+ if( solution_writer ) {
+  try {
+   solution_writer->flush();
+  }
+  catch( const std::exception & e ) {
+   std::cout << "InvestmentFunction::compute(): an error occurred while "
+    "outputting the solutions: '" << e.what() << "'" << std::endl;
+  }
+ }
+
+ if( f_netcdf_output )
+  f_netcdf_output->close();
+
+ if( kept_solutions )
+  f_kept_solutions = std::move( kept_solutions );
+
+#ifdef USE_MPI
+ if( num_ranks > 1 ) {
+  // The loop must be regarded as interrupted if it was interrupted in any
+  // process.
+  boost::mpi::communicator world;
+  interrupt_loop = boost::mpi::all_reduce( world , interrupt_loop ,
+                                           std::logical_or< bool >() );
+ }
+#endif
+
  if( interrupt_loop ) {
-  // The loop was interrupted due to an error. Unlock the sub-Blocks and
-  // return.
+  // The loop was interrupted due to an error (in this process or in
+  // another one). Unlock the sub-Blocks and return.
 
-  for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-   if( auto solver = get_solver( i ) )
-    solver->set_id( solver_ids[ i ] );
-   if( ! owned[ i ] )
-    v_Block[ i ]->unlock( f_id );  // unlock the inner Block
+  release_blocks();
 
-   // Unlock locally
+  // Unlock locally
+  for( Index i = 0 ; i < v_Block.size() ; ++i )
    unlock_sub_block( i );
-  }
+
+  f_ignore_modifications = saved_f_ignore_modifications;
 
   f_status = kError;
   f_value = worst_value();
@@ -1146,14 +1490,79 @@ int InvestmentFunction::compute( bool changedvars ) {
 
  f_ignore_modifications = saved_f_ignore_modifications;
 
- // Compute the expectation of the operational costs
+ // Gather the linearizations accumulated by the sub-Blocks
+
+ if( f_compute_linearization ) {
+  for( const auto & linearization : v_sub_block_linearization )
+   for( Index i = 0 ; i < v_linearization.size() ; ++i )
+    v_linearization[ i ] += linearization[ i ];
+ }
+
+#ifdef USE_MPI
+ if( num_ranks > 1 ) {
+  // Sum up the partial function values and linearizations of all processes
 
- f_value /= num_scenarios;
+  boost::mpi::communicator world;
+  f_value = boost::mpi::all_reduce( world , f_value , std::plus< double >() );
+
+  if( ! scenario_value.empty() ) {
+   std::vector< double > values( scenario_value.size() );
+   boost::mpi::all_reduce( world , scenario_value.data() ,
+                           int( scenario_value.size() ) ,
+                           values.data() , std::plus< double >() );
+   scenario_value = std::move( values );
+  }
+
+  if( f_compute_linearization && ( ! v_linearization.empty() ) ) {
+   std::vector< double > linearization( v_linearization.size() );
+   boost::mpi::all_reduce( world , v_linearization.data() ,
+                           int( v_linearization.size() ) ,
+                           linearization.data() , std::plus< double >() );
+   v_linearization = std::move( linearization );
+  }
+ }
+#endif
+
+ // Compute the expectation of the operational costs (or its estimate, if
+ // the scenarios have been sampled)
+
+ f_value /= num_sampled_scenarios;
 
  // Compute the expectation of the linearization
 
  for( Index i = 0 ; i < v_linearization.size() ; ++i ) {
-  v_linearization[ i ] /= num_scenarios;
+  v_linearization[ i ] /= num_sampled_scenarios;
+ }
+
+ // Compute the standard error of the estimate
+
+ f_number_sampled_scenarios = num_sampled_scenarios;
+ f_linearization_is_sampled = ( num_sampled_scenarios < num_scenarios );
+ f_standard_error = 0;
+
+ if( num_sampled_scenarios < num_scenarios ) {
+
+  if( num_sampled_scenarios > 1 ) {
+   double variance = 0;
+   for( auto scenario : scenarios )
+    variance += std::pow( scenario_value[ scenario ] - f_value , 2 );
+   variance /= num_sampled_scenarios - 1;
+
+   const auto n = double( num_sampled_scenarios );
+   f_standard_error =
+    std::sqrt( variance / n * ( 1 - n / double( num_scenarios ) ) );
+  }
+
+  update_sample_size( f_value , f_standard_error );
+
+  // Value of the scenarios that have not been sampled
+
+  std::vector< bool > sampled( num_scenarios , false );
+  for( auto scenario : scenarios )
+   sampled[ scenario ] = true;
+  for( Index i = 0 ; i < num_scenarios ; ++i )
+   if( ! sampled[ i ] )
+    scenario_value[ i ] = std::numeric_limits< double >::quiet_NaN();
  }
 
  // Consider the linear term of the objective
@@ -1180,17 +1589,22 @@ int InvestmentFunction::compute( bool changedvars ) {
  }
 
  // Unlock the inner Block if it is necessary
- for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-  if( auto solver = get_solver( i ) )
-   solver->set_id( solver_ids[ i ] );
-  if( ! owned[ i ] )
-   v_Block[ i ]->unlock( f_id );
- }
+ release_blocks();
 
  // At this point, if a linearization has been computed, then a diagonal
  // linearization is available.
  f_has_diagonal_linearization = f_compute_linearization;
 
+ v_scenario_value = std::move( scenario_value );
+
+ // Possibly store this evaluation in the cache
+
+ if( use_evaluation_cache && ( num_sampled_scenarios == num_scenarios ) )
+  evaluation_cache.insert( std::move( cache_key ) ,
+                           { f_value , f_compute_linearization ,
+                             f_compute_linearization ? v_linearization :
+                             std::vector< double >() , v_scenario_value } );
+
  f_has_value = true;
 
  output_function_value();
@@ -1273,8 +1687,13 @@ void InvestmentFunction::store_linearization( Index name , ModParam issueMod ) {
                                 "invalid global pool name: " +
                                 std::to_string( name ) ) );
 
+ // A linearization computed from a sample of the scenarios is an estimate,
+ // not a valid linearization of the function, and it is stored as inexact
+
  global_pool.store( get_linearization_constant() , v_linearization , name ,
-                    f_diagonal_linearization_required );
+                    f_diagonal_linearization_required ,
+                    f_diagonal_linearization_required &&
+                    f_linearization_is_sampled );
 
  if( ( ! f_Observer ) || ( ! f_Observer->issue_mod( issueMod ) ) )
   return;
@@ -1597,6 +2016,40 @@ SDDPBlock * InvestmentFunction::get_sddp_block( Index i ) const {
 
 /*--------------------------------------------------------------------------*/
 
+void InvestmentFunction::output_solutions( const SolutionSet & solutions )
+ const {
+ NetCDFSolutionOutput netcdf_output;
+ if( ! f_solution_filename.empty() )
+  netcdf_output.open( get_solution_filename() );
+
+ SDDPBlockSolutionOutput output;
+ for( const auto & solution : solutions.solutions ) {
+  if( solution.number_tables == 0 )
+   continue;  // not evaluated by this process
+  if( netcdf_output.is_open() )
+   netcdf_output.print( solution );
+  else
+   output.print( solution );
+ }
+}
+
+/*--------------------------------------------------------------------------*/
+
+std::string InvestmentFunction::get_solution_filename() const {
+ const auto [ rank , num_ranks ] = get_process_rank_and_size();
+ if( f_solution_filename.empty() || ( num_ranks == 1 ) )
+  return( f_solution_filename );
+
+ std::filesystem::path path( f_solution_filename );
+ auto filename = path.stem();
+ filename += "_" + std::to_string( rank );
+ filename += path.extension();
+ path.replace_filename( filename );
+ return( path.string() );
+}
+
+/*--------------------------------------------------------------------------*/
+
 CDASolver * InvestmentFunction::get_ucblock_solver( Index stage ,
                                                     Index i ) const {
  if( auto ucblock = get_ucblock( stage , i ) )
@@ -1638,90 +2091,156 @@ Index InvestmentFunction::get_node( Index stage , Index block_index ,
                                     Index generator ) const {
  // i is between 0 and the number of UnitBlock assets - 1.
  const auto i = v_block_indices_map[ block_index ];
- return( generator_node_map[ stage ][ i ][ generator ] );
+ const auto & map = v_stage_map[ stage ];
+ return( map.generator_node[ map.generator_start[ i ] + generator ] );
 }
 
 /*--------------------------------------------------------------------------*/
 
-void InvestmentFunction::build_generator_node_map() {
+void InvestmentFunction::build_stage_maps() {
 
- // The indices of the UnitBlocks
- std::vector< Index > block_indices;
- block_indices.reserve( v_asset_indices.size() );
+ // The indices of the UnitBlocks and of the transmission lines, together
+ // with the indices of their variables
+
+ v_unit_assets.clear();
+ v_line_assets.clear();
 
  for( Index i = 0 ; i < v_asset_indices.size() ; ++i ) {
-  if( v_asset_type[ i ] == eUnitBlock )
-   block_indices.push_back( v_asset_indices[ i ] );
- }
 
- if( block_indices.empty() )
-  return;
+  const auto asset_type = v_asset_type[ i ];
+  const auto asset_index = v_asset_indices[ i ];
 
- v_block_indices_map.resize
-  ( 1 + * std::max_element( block_indices.cbegin() , block_indices.cend() ) ,
-    Inf< Index >() );
- for( Index i = 0 ; i < block_indices.size() ; ++i ) {
-  v_block_indices_map[ block_indices[ i ] ] = i;
- }
+  if( asset_type == eUnitBlock )
+   v_unit_assets.push_back( { asset_index , i } );
+  else if( asset_type == eLine )
+   v_line_assets.push_back( { asset_index , i } );
+  else
+   throw( std::logic_error( "InvestmentFunction::build_stage_maps: invalid "
+                            "asset type: " + std::to_string( asset_type ) ) );
+ } // end( for each asset )
+
+ // The StageMaps are created even if there is no UnitBlock asset, so that
+ // they are not built again by the next call to compute().
 
  const auto num_stages = get_number_stages();
+ v_stage_map.assign( num_stages , StageMap() );
 
- generator_node_map.resize( num_stages );
+ if( v_unit_assets.empty() )
+  return;
+
+ Index max_block_index = 0;
+ for( const auto & asset : v_unit_assets )
+  max_block_index = std::max( max_block_index , asset.first );
+
+ v_block_indices_map.assign( max_block_index + 1 , Inf< Index >() );
+ for( Index i = 0 ; i < v_unit_assets.size() ; ++i )
+  v_block_indices_map[ v_unit_assets[ i ].first ] = i;
 
  for( Index stage = 0 ; stage < num_stages ; ++stage ) {
 
-  generator_node_map[ stage ].resize( block_indices.size() );
+  auto & map = v_stage_map[ stage ];
 
   const auto ucblock = get_ucblock( stage , 0 );
   const auto network_data = ucblock->get_NetworkData();
   const auto number_nodes = network_data ? network_data->get_number_nodes() : 1;
+  const auto number_units = ucblock->get_number_units();
+
+  // The index of the first electrical generator of each UnitBlock
+
+  std::vector< Index > first_generator( number_units + 1 , 0 );
+  for( Index unit_id = 0 ; unit_id < number_units ; ++unit_id )
+   first_generator[ unit_id + 1 ] = first_generator[ unit_id ] +
+    ucblock->get_unit_block( unit_id )->get_number_generators();
+
+  // The kind of the UnitBlocks and the nodes of their generators
+
+  map.unit_kind.reserve( v_unit_assets.size() );
+  map.generator_start.reserve( v_unit_assets.size() + 1 );
+  map.generator_start.push_back( 0 );
 
-  if( number_nodes <= 1 ) {
-   // Since there is only one node, all generators belong to the same node
-   // (node 0).
-   for( Index i = 0 ; i < block_indices.size() ; ++i ) {
-    const auto unit_block = ucblock->get_unit_block( block_indices[ i ] );
-    const auto num_generators = unit_block->get_number_generators();
-    generator_node_map[ stage ][ i ].resize( num_generators , 0 );
+  for( const auto & asset : v_unit_assets ) {
+
+   const auto block_index = asset.first;
+   const auto block = ucblock->get_unit_block( block_index );
+
+   if( dynamic_cast< const ThermalUnitBlock * >( block ) )
+    map.unit_kind.push_back( StageMap::eThermal );
+   else if( dynamic_cast< const BatteryUnitBlock * >( block ) )
+    map.unit_kind.push_back( StageMap::eBattery );
+   else if( dynamic_cast< const IntermittentUnitBlock * >( block ) )
+    map.unit_kind.push_back( StageMap::eIntermittent );
+   else
+    map.unit_kind.push_back( StageMap::eUnknown );
+
+   const auto num_generators = block->get_number_generators();
+
+   if( number_nodes <= 1 ) {
+    // Since there is only one node, all generators belong to the same node
+    // (node 0).
+    map.generator_node.resize( map.generator_node.size() + num_generators ,
+                               0 );
+   }
+   else {
+    const auto & generator_node = ucblock->get_generator_node();
+    for( Index generator = 0 ; generator < num_generators ; ++generator )
+     map.generator_node.push_back
+      ( generator_node[ first_generator[ block_index ] + generator ] );
    }
-   continue;
-  }
 
-  // There are multiple nodes.
+   map.generator_start.push_back( map.generator_node.size() );
 
-  const auto number_units = ucblock->get_number_units();
-  const auto & generator_node = ucblock->get_generator_node();
+  } // end( for each UnitBlock asset )
 
-  for( Index node_id = 0 ; node_id < number_nodes ; ++node_id ) {
+  // The generators of the UnitBlocks in each zone, ordered by zone, then by
+  // node, and then by generator.
 
-   Index elc_generator = 0;
-   for( Index unit_id = 0 ; unit_id < number_units ; ++unit_id ) {
+  const auto build_zone_map =
+   [ & ]( StageMap::ZoneMap & zone_map , Index number_zones ,
+          const auto & node_belongs_to_zone ) {
 
-    const auto unit_block = ucblock->get_unit_block( unit_id );
-    const auto num_generators = unit_block->get_number_generators();
+    zone_map.start.reserve( v_unit_assets.size() + 1 );
+    zone_map.start.push_back( 0 );
 
-    auto it = std::find( block_indices.cbegin() ,
-                         block_indices.cend() , unit_id );
+    for( const auto & asset : v_unit_assets ) {
 
-    const auto index = std::distance( block_indices.cbegin() , it );
+     const auto block_index = asset.first;
+     const auto num_generators =
+      ucblock->get_unit_block( block_index )->get_number_generators();
 
-    if( index == decltype( index )( block_indices.size() ) ) {
-     // This UnitBlock is not subject to investment.
-     elc_generator += num_generators;
-     continue;
-    }
+     for( Index zone_id = 0 ; zone_id < number_zones ; ++zone_id ) {
+      for( Index node_id = 0 ; node_id < number_nodes ; ++node_id ) {
+       if( ! node_belongs_to_zone( node_id , zone_id ) )
+        continue;
+       for( Index generator = 0 ; generator < num_generators ; ++generator )
+        if( ucblock->generator_belongs_to_node
+            ( first_generator[ block_index ] + generator , node_id ) )
+         zone_map.entries.push_back( { zone_id , generator } );
+      } // end( for each node )
+     } // end( for each zone )
 
-    generator_node_map[ stage ][ index ].resize( num_generators );
+     zone_map.start.push_back( zone_map.entries.size() );
+
+    } // end( for each UnitBlock asset )
+   };
+
+  build_zone_map( map.primary_zones , ucblock->get_number_primary_zones() ,
+                  [ ucblock ]( Index node_id , Index zone_id ) {
+                   return( ucblock->node_belongs_to_primary_zone
+                           ( node_id , zone_id ) ); } );
+
+  build_zone_map( map.secondary_zones ,
+                  ucblock->get_number_secondary_zones() ,
+                  [ ucblock ]( Index node_id , Index zone_id ) {
+                   return( ucblock->node_belongs_to_secondary_zone
+                           ( node_id , zone_id ) ); } );
+
+  build_zone_map( map.inertia_zones , ucblock->get_number_inertia_zones() ,
+                  [ ucblock ]( Index node_id , Index zone_id ) {
+                   return( ucblock->node_belongs_to_inertia_zone
+                           ( node_id , zone_id ) ); } );
 
-    for( Index generator = 0 ; generator < num_generators ;
-         ++generator , ++elc_generator ) {
-     generator_node_map[ stage ][ index ][ generator ] =
-      generator_node[ elc_generator ];
-    }
-   } // end( for each UnitBlock )
-  } // end( for each node )
  } // end( for each stage )
-} // end( InvestmentFunction::build_generator_node_map )
+} // end( InvestmentFunction::build_stage_maps )
 
 /*--------------------------------------------------------------------------*/
 
@@ -1733,12 +2252,14 @@ double InvestmentFunction::compute_scale_linearization
   * implemented, this function must be updated. */
 
  const auto ucblock = get_ucblock( stage , sub_block_index );
- const auto network_data = ucblock->get_NetworkData();
- const auto number_nodes = network_data ? network_data->get_number_nodes() : 1;
  const auto time_horizon = ucblock->get_time_horizon();
 
  const auto block = ucblock->get_unit_block( block_index );
 
+ // The generators of this UnitBlock in each zone
+ const auto & map = v_stage_map[ stage ];
+ const auto asset = v_block_indices_map[ block_index ];
+
  // This is the contribution to the linearization associated with this
  // UnitBlock.
  double linearization = 0;
@@ -1785,41 +2306,22 @@ double InvestmentFunction::compute_scale_linearization
 
  if( ! primary_demand_constraints.empty() ) {
 
-  const auto number_primary_zones = ucblock->get_number_primary_zones();
+  const auto & zones = map.primary_zones;
 
   for( Index t = 0 ; t < time_horizon ; ++t ) {
-   for( Index zone_id = 0 ; zone_id < number_primary_zones ; ++zone_id ) {
-    for( Index node_id = 0 ; node_id < number_nodes ; ++node_id ) {
-     if( ! ucblock->node_belongs_to_primary_zone( node_id , zone_id ) )
-      continue;
-
-     // Compute the index of the first electrical generator of the current
-     // UnitBlock.
-     Index elc_generator = 0;
-     for( Index unit_id = 0 ; unit_id < block_index ; ++unit_id ) {
-      const auto unit_block = ucblock->get_unit_block( unit_id );
-      elc_generator += unit_block->get_number_generators();
-     }
-
-     const auto num_generators = block->get_number_generators();
+   for( auto k = zones.start[ asset ] ; k < zones.start[ asset + 1 ] ; ++k ) {
 
-     for( Index generator = 0 ; generator < num_generators ;
-          ++generator , ++elc_generator ) {
+    const auto [ zone_id , generator ] = zones.entries[ k ];
 
-      if( ! ucblock->generator_belongs_to_node( elc_generator , node_id ) )
-       continue;
+    if( const auto primary_s_r =
+        block->get_primary_spinning_reserve( generator ) ) {
 
-      if( const auto primary_s_r =
-          block->get_primary_spinning_reserve( generator ) ) {
-
-       const auto primary_spinning_reserve = & primary_s_r[ t ];
-       const auto dual = primary_demand_constraints[ t ][ zone_id ].get_dual();
-       linearization += dual * primary_spinning_reserve->get_value();
-      }
+     const auto primary_spinning_reserve = & primary_s_r[ t ];
+     const auto dual = primary_demand_constraints[ t ][ zone_id ].get_dual();
+     linearization += dual * primary_spinning_reserve->get_value();
+    }
 
-     } // end( for each generator )
-    } // end( for each node )
-   } // end( for each zone )
+   } // end( for each generator in each zone )
   } // end( for each time instant )
 
  } // end( non-empty primary demand constraints )
@@ -1831,41 +2333,22 @@ double InvestmentFunction::compute_scale_linearization
 
  if( ! secondary_demand_constraints.empty() ) {
 
-  const auto number_secondary_zones = ucblock->get_number_secondary_zones();
+  const auto & zones = map.secondary_zones;
 
   for( Index t = 0 ; t < time_horizon ; ++t ) {
-   for( Index zone_id = 0 ; zone_id < number_secondary_zones ; ++zone_id ) {
-    for( Index node_id = 0 ; node_id < number_nodes ; ++node_id ) {
-     if( ! ucblock->node_belongs_to_secondary_zone( node_id , zone_id ) )
-      continue;
-
-     // Compute the index of the first electrical generator of the current
-     // UnitBlock.
-     Index elc_generator = 0;
-     for( Index unit_id = 0 ; unit_id < block_index ; ++unit_id ) {
-      const auto unit_block = ucblock->get_unit_block( unit_id );
-      elc_generator += unit_block->get_number_generators();
-     }
-
-     const auto num_generators = block->get_number_generators();
+   for( auto k = zones.start[ asset ] ; k < zones.start[ asset + 1 ] ; ++k ) {
 
-     for( Index generator = 0 ; generator < num_generators ;
-          ++generator , ++elc_generator ) {
+    const auto [ zone_id , generator ] = zones.entries[ k ];
 
-      if( ! ucblock->generator_belongs_to_node( elc_generator , node_id ) )
-       continue;
+    if( const auto secondary_s_r =
+        block->get_secondary_spinning_reserve( generator ) ) {
 
-      if( const auto secondary_s_r =
-          block->get_secondary_spinning_reserve( generator ) ) {
-
-       const auto secondary_spinning_reserve = & secondary_s_r[ t ];
-       const auto dual = secondary_demand_constraints[ t ][ zone_id ].get_dual();
-       linearization += dual * secondary_spinning_reserve->get_value();
-      }
+     const auto secondary_spinning_reserve = & secondary_s_r[ t ];
+     const auto dual = secondary_demand_constraints[ t ][ zone_id ].get_dual();
+     linearization += dual * secondary_spinning_reserve->get_value();
+    }
 
-     } // end( for each generator )
-    } // end( for each node )
-   } // end( for each zone )
+   } // end( for each generator in each zone )
   } // end( for each time instant )
 
  } // end( non-empty secondary demand constraints )
@@ -1877,56 +2360,37 @@ double InvestmentFunction::compute_scale_linearization
 
  if( ! inertia_demand_constraints.empty() ) {
 
-  const auto number_inertia_zones = ucblock->get_number_inertia_zones();
+  const auto & zones = map.inertia_zones;
 
   for( Index t = 0 ; t < time_horizon ; ++t ) {
-   for( Index zone_id = 0 ; zone_id < number_inertia_zones ; ++zone_id ) {
-    for( Index node_id = 0 ; node_id < number_nodes ; ++node_id ) {
-     if( ! ucblock->node_belongs_to_inertia_zone( node_id , zone_id ) )
-      continue;
-
-     // Compute the index of the first electrical generator of the current
-     // UnitBlock.
-     Index elc_generator = 0;
-     for( Index unit_id = 0 ; unit_id < block_index ; ++unit_id ) {
-      const auto unit_block = ucblock->get_unit_block( unit_id );
-      elc_generator += unit_block->get_number_generators();
-     }
-
-     const auto num_generators = block->get_number_generators();
+   for( auto k = zones.start[ asset ] ; k < zones.start[ asset + 1 ] ; ++k ) {
 
-     for( Index generator = 0 ; generator < num_generators ;
-          ++generator , ++elc_generator ) {
+    const auto [ zone_id , generator ] = zones.entries[ k ];
 
-      if( ! ucblock->generator_belongs_to_node( elc_generator , node_id ) )
-       continue;
+    const auto dual = inertia_demand_constraints[ t ][ zone_id ].get_dual();
 
-      const auto dual = inertia_demand_constraints[ t ][ zone_id ].get_dual();
+    // Commitment variable
 
-      // Commitment variable
+    auto commitment = block->get_commitment( generator );
+    auto inertia_commitment = block->get_inertia_commitment( generator );
 
-      auto commitment = block->get_commitment( generator );
-      auto inertia_commitment = block->get_inertia_commitment( generator );
-
-      if( commitment && inertia_commitment ) {
-       const auto commitment_t = & commitment[ t ];
-       linearization +=
-        dual * inertia_commitment[ t ] * commitment_t->get_value();
-      }
+    if( commitment && inertia_commitment ) {
+     const auto commitment_t = & commitment[ t ];
+     linearization +=
+      dual * inertia_commitment[ t ] * commitment_t->get_value();
+    }
 
-      // Active power variable
+    // Active power variable
 
-      auto active_power = block->get_active_power( generator );
-      auto inertia_power = block->get_inertia_power( generator );
+    auto active_power = block->get_active_power( generator );
+    auto inertia_power = block->get_inertia_power( generator );
 
-      if( active_power && inertia_power ) {
-       auto active_power_t = & active_power[ t ];
-       linearization += dual * inertia_power[ t ] * active_power_t->get_value();
-      }
+    if( active_power && inertia_power ) {
+     auto active_power_t = & active_power[ t ];
+     linearization += dual * inertia_power[ t ] * active_power_t->get_value();
+    }
 
-     } // end( for each generator )
-    } // end( for each node )
-   } // end( for each zone )
+   } // end( for each generator in each zone )
   } // end( for each time instant )
 
  } // end( non-empty inertia demand constraints )
@@ -2239,7 +2703,7 @@ double InvestmentFunction::compute_kappa_linearization
 
 void InvestmentFunction::update_linearization_unit_blocks
 ( Index stage , Index sub_block_index ,
-  const std::vector< std::pair< Index , Index > > & block_indices ) {
+  std::vector< double > & linearization ) {
 
  /* The UnitBlocks that are subject to investment can be divided into two
   * groups, depending on how the investment is represented.
@@ -2258,30 +2722,32 @@ void InvestmentFunction::update_linearization_unit_blocks
   */
 
  const auto ucblock = get_ucblock( stage , sub_block_index );
+ const auto & unit_kind = v_stage_map[ stage ].unit_kind;
 
- for( const auto & [ block_index , var_index ] : block_indices ) {
+ for( Index i = 0 ; i < v_unit_assets.size() ; ++i ) {
 
+  const auto [ block_index , var_index ] = v_unit_assets[ i ];
   auto block = ucblock->get_unit_block( block_index );
 
-  if( dynamic_cast< const ThermalUnitBlock * >( block ) ) {
-   v_linearization[ var_index ] +=
+  if( unit_kind[ i ] == StageMap::eThermal ) {
+   linearization[ var_index ] +=
     compute_scale_linearization( block_index , stage , sub_block_index );
   }
-  else if( auto unit = dynamic_cast< BatteryUnitBlock * >( block ) ) {
+  else if( unit_kind[ i ] == StageMap::eBattery ) {
    if( f_replicate_battery )
-    v_linearization[ var_index ] +=
+    linearization[ var_index ] +=
      compute_scale_linearization( block_index , stage , sub_block_index );
    else
-    v_linearization[ var_index ] +=
-     compute_kappa_linearization( unit , var_index );
+    linearization[ var_index ] += compute_kappa_linearization
+     ( static_cast< BatteryUnitBlock * >( block ) , var_index );
   }
-  else if( auto unit = dynamic_cast< IntermittentUnitBlock * >( block ) ) {
+  else if( unit_kind[ i ] == StageMap::eIntermittent ) {
    if( f_replicate_intermittent )
-    v_linearization[ var_index ] +=
+    linearization[ var_index ] +=
      compute_scale_linearization( block_index , stage , sub_block_index );
    else
-    v_linearization[ var_index ] +=
-     compute_kappa_linearization( unit , var_index );
+    linearization[ var_index ] += compute_kappa_linearization
+     ( static_cast< IntermittentUnitBlock * >( block ) , var_index );
   }
   else {
    // Unrecognized Block
@@ -2299,11 +2765,11 @@ void InvestmentFunction::update_linearization_unit_blocks
 
 void InvestmentFunction::update_linearization_network_blocks
 ( Index stage , Index sub_block_index ,
-  const std::vector< std::pair< Index , Index > > & line_indices ) {
+  std::vector< double > & linearization ) {
 
  // Update the linearization with respect to the lines
 
- if( line_indices.empty() )
+ if( v_line_assets.empty() )
   // There is no investment in lines, so there is nothing to be done.
   return;
 
@@ -2343,7 +2809,7 @@ void InvestmentFunction::update_linearization_network_blocks
    const auto obj_sign =
     ( dc_network->get_objective_sense() == Objective::eMin ) ? - 1 : 1;
 
-   for( const auto & [ line , var_index ] : line_indices ) {
+   for( const auto & [ line , var_index ] : v_line_assets ) {
 
     const auto dual = constraints[ line ].get_dual();
     const auto min_flow = dc_network->get_min_power_flow( line );
@@ -2356,7 +2822,7 @@ void InvestmentFunction::update_linearization_network_blocks
 
     // Finally, update the linearization.
 
-    v_linearization[ var_index ] += - dual * bound;
+    linearization[ var_index ] += - dual * bound;
    } // end( for each line )
   } // end( dynamic_cast< const DCNetworkBlock * > )
   else {
@@ -2371,61 +2837,42 @@ void InvestmentFunction::update_linearization_network_blocks
 
 /*--------------------------------------------------------------------------*/
 
-void InvestmentFunction::update_linearization( Index sub_block_index ) {
+void InvestmentFunction::update_linearization
+( Index sub_block_index , std::vector< double > & linearization ) {
 
  const auto sddp_block = get_sddp_block( sub_block_index );
  const auto num_stages = sddp_block->get_time_horizon();
 
- // The indices of the UnitBlocks and the indices of their variables
- std::vector< std::pair< Index , Index > > block_indices;
- block_indices.reserve( v_asset_indices.size() );
-
- // The indices of the transmission lines and the indices of their variables
- std::vector< std::pair< Index , Index > > line_indices;
- line_indices.reserve( v_asset_indices.size() );
-
- for( Index i = 0 ; i < v_asset_indices.size() ; ++i ) {
-
-  const auto asset_type =  v_asset_type[ i ];
-  const auto asset_index =  v_asset_indices[ i ];
-
-  if( asset_type == eUnitBlock ) {
-   block_indices.push_back( { asset_index , i } );
-  }
-  else if( asset_type == eLine ) {
-   line_indices.push_back( { asset_index , i } );
-  }
-  else {
-   throw( std::logic_error( "InvestmentFunction::update_linearization: invalid"
-                            " asset type: " + std::to_string( asset_type ) ) );
-  }
- } // end( for each asset )
-
  auto solver = get_solver< CDASolver >( sub_block_index );
 
  // Retrieve the dual solution
 
- if( solver && solver->has_dual_solution() )
+ if( solver && solver->has_dual_solution() ) {
+  Profiler::ScopedTimer timer( "get_dual_solution" );
   solver->get_dual_solution(); // TODO pass Configuration
+ }
  else
   throw( std::logic_error( "InvestmentFunction::update_linearization: "
                            "dual solution not available." ) );
 
  // Retrieve the primal solution.
 
- if( ! block_indices.empty() ) {
+ if( ! v_unit_assets.empty() ) {
   // The primal solution may only be necessary if there are UnitBlocks
   // subject to investment.
-  if( solver && solver->has_var_solution() )
+  if( solver && solver->has_var_solution() ) {
+   Profiler::ScopedTimer timer( "get_var_solution" );
    solver->get_var_solution(); // TODO pass Configuration
+  }
   else
    throw( std::logic_error( "InvestmentFunction::update_linearization: "
                             "primal solution not available." ) );
  }
 
  for( Index stage = 0 ; stage < num_stages ; ++stage ) {
-  update_linearization_unit_blocks( stage , sub_block_index , block_indices );
-  update_linearization_network_blocks( stage , sub_block_index , line_indices );
+  update_linearization_unit_blocks( stage , sub_block_index , linearization );
+  update_linearization_network_blocks( stage , sub_block_index ,
+                                       linearization );
  } // end( for each stage )
 
 }  // end( InvestmentFunction::update_linearization() )
@@ -2529,6 +2976,23 @@ void InvestmentFunction::update_blocks() {
 
  f_ignore_modifications = true;
 
+ // If the sub-Blocks may have changed since they were last updated, the
+ // investment last applied to them is no longer meaningful.
+
+ if( ( ! f_blocks_are_updated ) ||
+     ( v_applied_investment.size() != v_Block.size() ) )
+  v_applied_investment.assign( v_Block.size() , {} );
+
+ // The current investment in each asset
+
+ std::vector< double > var_value( v_asset_indices.size() );
+ for( Index i = 0 ; i < v_asset_indices.size() ; ++i ) {
+  if( ( v_asset_type[ i ] != eUnitBlock ) && ( v_asset_type[ i ] != eLine ) )
+   throw( std::logic_error( "InvestmentFunction::update_blocks: invalid asset"
+                            " type: " + std::to_string( v_asset_type[ i ] ) ) );
+  var_value[ i ] = get_var_value( i , false );
+ }
+
  // The indices of the UnitBlocks
  std::vector< Index > block_indices;
  block_indices.reserve( v_asset_indices.size() );
@@ -2545,30 +3009,52 @@ void InvestmentFunction::update_blocks() {
  std::vector< double > line_investment;
  line_investment.reserve( v_asset_indices.size() );
 
- for( Index i = 0 ; i < v_asset_indices.size() ; ++i ) {
+ // The indices of the assets that are updated
+ std::vector< Index > updated_assets;
+ updated_assets.reserve( v_asset_indices.size() );
 
-  const auto asset_type =  v_asset_type[ i ];
-  const auto asset_index =  v_asset_indices[ i ];
-  const auto var_value = get_var_value( i , false );
+ for( Index s = 0 ; s < v_Block.size() ; ++s ) {
 
-  if( asset_type == eUnitBlock ) {
-   block_indices.push_back( asset_index );
-   block_investment.push_back( var_value );
-  }
-  else if( asset_type == eLine ) {
-   line_indices.push_back( asset_index );
-   line_investment.push_back( var_value );
-  }
-  else {
-   throw( std::logic_error( "InvestmentFunction::update_blocks: invalid asset"
-                            " type: " + std::to_string( asset_type ) ) );
-  }
- } // end( for each asset )
+  auto & applied_investment = v_applied_investment[ s ];
+  const bool update_all =
+   ( applied_investment.size() != v_asset_indices.size() );
 
- for( Index i = 0 ; i < v_Block.size() ; ++i ) {
-  update_unit_blocks( i , block_indices , block_investment );
-  update_network_blocks( i , line_indices , line_investment );
- }
+  block_indices.clear();
+  block_investment.clear();
+  line_indices.clear();
+  line_investment.clear();
+  updated_assets.clear();
+
+  for( Index i = 0 ; i < v_asset_indices.size() ; ++i ) {
+
+   if( ( ! update_all ) &&
+       ( std::abs( var_value[ i ] - applied_investment[ i ] ) <=
+         f_investment_update_tolerance ) )
+    continue; // this asset has not changed
+
+   updated_assets.push_back( i );
+
+   if( v_asset_type[ i ] == eUnitBlock ) {
+    block_indices.push_back( v_asset_indices[ i ] );
+    block_investment.push_back( var_value[ i ] );
+   }
+   else {
+    line_indices.push_back( v_asset_indices[ i ] );
+    line_investment.push_back( var_value[ i ] );
+   }
+  } // end( for each asset )
+
+  update_unit_blocks( s , block_indices , block_investment );
+  update_network_blocks( s , line_indices , line_investment );
+
+  // Record the investment that has been applied to this sub-Block
+
+  if( update_all )
+   applied_investment = var_value;
+  else
+   for( auto i : updated_assets )
+    applied_investment[ i ] = var_value[ i ];
+ } // end( for each sub-Block )
 
  f_ignore_modifications = saved_f_ignore_modifications;
  f_blocks_are_updated = true;
@@ -2580,8 +3066,10 @@ void InvestmentFunction::send_nuclear_modification
 ( const Observer::ChnlName chnl ) {
  // "nuclear modification" for Function: everything changed
  global_pool.invalidate();
+ evaluation_cache.clear();
+ v_scenario_state.clear();
  f_blocks_are_updated = false;
- generator_node_map.clear(); // the generator map must be rebuilt
+ v_stage_map.clear(); // the StageMaps must be rebuilt
  if( f_Observer )
   f_Observer->add_Modification
    ( std::make_shared< FunctionMod >( this , FunctionMod::NaNshift ) , chnl );
@@ -2608,42 +3096,199 @@ Index InvestmentFunction::get_number_stages() const {
 
 /*--------------------------------------------------------------------------*/
 
+void InvestmentFunction::share_cuts( Index source ) {
+ if( source >= v_Block.size() )
+  throw( std::invalid_argument( "InvestmentFunction::share_cuts: invalid "
+                                "sub-Block index: " +
+                                std::to_string( source ) ) );
+
+ cancel_shared_cuts();
+
+ if( v_Block.size() == 1 )
+  return;
+
+ f_shared_cuts = std::make_shared< const CutSet >( get_sddp_block( source ) );
+
+ v_has_shared_cuts.assign( v_Block.size() , 0 );
+ v_has_shared_cuts[ source ] = 1;
+
+ for( Index i = 0 ; i < v_Block.size() ; ++i )
+  if( i != source )
+   CutSet::remove_cuts( get_sddp_block( i ) );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::cancel_shared_cuts() {
+ f_shared_cuts.reset();
+ v_has_shared_cuts.assign( v_Block.size() , 1 );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::clear_solution_outputs() {
+ v_solution_output.clear();
+}
+
+/*--------------------------------------------------------------------------*/
+
 Index InvestmentFunction::lock_sub_block() {
- auto sub_block_index = Inf< Index >();
+ return( sub_block_pool.acquire() );
+}
 
- while( true ) {
+/*--------------------------------------------------------------------------*/
 
-#pragma omp critical (InvestmentFunction)
-  {
-   if( is_locked.empty() )
-    is_locked.resize( v_Block.size() , false );
-
-   for( Index i = 0 ; i < is_locked.size() ; ++i ) {
-    if( ! is_locked[ i ] ) {
-     sub_block_index = i;
-     is_locked[ i ] = true;
-     break;
-    }
-   }
-  } // end omp critical (InvestmentFunction)
+void InvestmentFunction::unlock_sub_block( Index i ) {
+ sub_block_pool.release( i );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::broadcast_variable_values() {
+#ifdef USE_MPI
+ if( ( ! f_distribute_scenarios ) || v_x.empty() )
+  return;
+
+ boost::mpi::communicator world;
+ if( world.size() < 2 )
+  return;
+
+ std::vector< double > values( v_x.size() );
+ for( Index i = 0 ; i < v_x.size() ; ++i )
+  values[ i ] = v_x[ i ]->get_value();
 
-  if( sub_block_index < Inf< Index >() )
-   // An unlocked sub-Block has been found. Return its index.
-   return( sub_block_index );
+ boost::mpi::broadcast( world , values.data() , int( values.size() ) , 0 );
+
+ for( Index i = 0 ; i < v_x.size() ; ++i )
+  v_x[ i ]->set_value( values[ i ] );
+#endif
+}
+
+/*--------------------------------------------------------------------------*/
+
+std::vector< Index > InvestmentFunction::sample_scenarios() {
+ const auto num_scenarios = get_number_scenarios();
+
+ std::vector< Index > scenarios( num_scenarios );
+ std::iota( scenarios.begin() , scenarios.end() , 0 );
+
+ if( ( f_current_sample_size == 0 ) ||
+     ( f_current_sample_size >= num_scenarios ) )
+  return( scenarios );  // all scenarios must be evaluated
+
+ // Select f_current_sample_size scenarios uniformly at random, by means of
+ // a partial Fisher-Yates shuffle
+
+ for( Index i = 0 ; i < f_current_sample_size ; ++i ) {
+  std::uniform_int_distribution< Index > distribution( i , num_scenarios - 1 );
+  const auto j = distribution( scenario_sample_engine );
+  std::swap( scenarios[ i ] , scenarios[ j ] );
+ }
+
+ scenarios.resize( f_current_sample_size );
+ std::sort( scenarios.begin() , scenarios.end() );
+ return( scenarios );
+}
+
+/*--------------------------------------------------------------------------*/
+
+std::vector< Index > InvestmentFunction::schedule_scenarios
+( const std::vector< Index > & scenarios , int rank , int num_ranks ) const {
+
+ std::vector< Index > order;
+ order.reserve( scenarios.size() / num_ranks + 1 );
+
+ for( Index k = rank ; k < scenarios.size() ; k += num_ranks )
+  order.push_back( k );
+
+ if( f_scenario_schedule != eCostSchedule )
+  return( order );
+
+ // Longest expected time first. The scenarios that have never been
+ // evaluated (negative time) come first; ties keep the order of the indices.
+
+ const auto expected_time = [ this , & scenarios ]( Index k ) {
+  const auto time = v_scenario_time[ scenarios[ k ] ];
+  return( time < 0 ? Inf< double >() : time );
+ };
+
+ std::stable_sort( order.begin() , order.end() ,
+                   [ & expected_time ]( Index k1 , Index k2 ) {
+                    return( expected_time( k1 ) > expected_time( k2 ) );
+                   } );
+ return( order );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::update_sample_size( double value ,
+                                             double standard_error ) {
+ const auto num_scenarios = get_number_scenarios();
+
+ auto sample_size = double( f_current_sample_size );
+
+ sample_size = std::ceil( sample_size * f_scenario_sample_growth );
+
+ if( ( f_scenario_sample_rel_error > 0 ) && ( value != 0 ) ) {
+  const auto relative_error = standard_error / std::abs( value );
+  if( relative_error > f_scenario_sample_rel_error )
+   sample_size = std::max( sample_size , std::ceil
+                           ( f_current_sample_size *
+                             std::pow( relative_error /
+                                       f_scenario_sample_rel_error , 2 ) ) );
+ }
+
+ if( sample_size >= double( num_scenarios ) )
+  f_current_sample_size = num_scenarios;
+ else
+  f_current_sample_size = Index( sample_size );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::restore_scenario_states( Index scenario ,
+                                                  Index sub_block_index ) {
+ if( ( ! f_warm_start ) || ( scenario >= v_scenario_state.size() ) )
+  return;
+
+ const auto & states = v_scenario_state[ scenario ];
+ for( Index stage = 0 ; stage < states.size() ; ++stage ) {
+  if( ! states[ stage ] )
+   continue;
+  if( auto solver = get_ucblock_solver( stage , sub_block_index ) )
+   solver->put_State( *states[ stage ] );
+ }
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::save_scenario_states( Index scenario ,
+                                               Index sub_block_index ) {
+ if( ( ! f_warm_start ) || ( scenario >= v_scenario_state.size() ) )
+  return;
+
+ const auto num_stages = get_sddp_block( sub_block_index )->get_time_horizon();
+
+ auto & states = v_scenario_state[ scenario ];
+ states.resize( num_stages );
+ for( Index stage = 0 ; stage < num_stages ; ++stage ) {
+  if( auto solver = get_ucblock_solver( stage , sub_block_index ) )
+   states[ stage ].reset( solver->get_State() );
   else
-   // No sub-Block is available. Wait.
-   std::this_thread::sleep_for
-    ( std::chrono::duration< double >( waiting_time ) );
+   states[ stage ].reset();
  }
 }
 
 /*--------------------------------------------------------------------------*/
 
-void InvestmentFunction::unlock_sub_block( Index i ) {
-#pragma omp critical (InvestmentFunction)
- {
-  is_locked[ i ] = false;
+std::pair< int , int > InvestmentFunction::get_process_rank_and_size() const {
+#ifdef USE_MPI
+ if( f_distribute_scenarios ) {
+  boost::mpi::communicator world;
+  return( { world.rank() , world.size() } );
  }
+#endif
+ return( { 0 , 1 } );
 }
 
 /*--------------------------------------------------------------------------*/
@@ -2652,6 +3297,10 @@ void InvestmentFunction::output_variable_values() const {
  if( f_output_filename.empty() )
   return;
 
+ // Only one process writes into the file
+ if( get_process_rank_and_size().first != 0 )
+  return;
+
  std::ofstream file( f_output_filename , std::ios_base::app );
 
  if( ! file.is_open() ) {
@@ -2673,6 +3322,10 @@ void InvestmentFunction::output_function_value() const {
  if( f_output_filename.empty() )
   return;
 
+ // Only one process writes into the file
+ if( get_process_rank_and_size().first != 0 )
+  return;
+
  std::ofstream file( f_output_filename , std::ios_base::app );
 
  if( ! file.is_open() ) {
@@ -2690,26 +3343,73 @@ void InvestmentFunction::output_function_value() const {
 /*--------------------------------------------------------------------------*/
 
 void InvestmentFunction::GlobalPool::resize( Index size ) {
- linearization_coefficients.resize( size , {} );
+ // the rows of the linearizations that are destroyed are given back
+ for( Index name = size ; name < this->size() ; ++name )
+  free_row( name );
+
  linearization_constants.resize( size , NaN );
- is_diagonal.resize( size );
+ is_diagonal.resize( size , 0 );
+ is_inexact.resize( size , 0 );
+ rows.resize( size , Inf< Index >() );
 }  // end( InvestmentFunction::GlobalPool::resize )
 
 /*--------------------------------------------------------------------------*/
 
 void InvestmentFunction::GlobalPool::store
-( FunctionValue constant , std::vector< FunctionValue > coefficients ,
-  Index name , bool diagonal_linearization ) {
+( FunctionValue constant , const std::vector< FunctionValue > & coefficients ,
+  Index name , bool diagonal_linearization , bool inexact ) {
  if( name >= size() )
   throw( std::invalid_argument( "InvestmentFunction::GlobalPool::store: "
                                 "invalid linearization name." ) );
- linearization_coefficients[ name ] = coefficients;
- linearization_constants[ name ] = constant;
- is_diagonal[ name ] = diagonal_linearization;
+ store_row( constant , coefficients.data() , coefficients.size() , name ,
+            diagonal_linearization , inexact );
 }  // end( InvestmentFunction::GlobalPool::store )
 
 /*--------------------------------------------------------------------------*/
 
+void InvestmentFunction::GlobalPool::store_row
+( FunctionValue constant , const FunctionValue * g , Index n , Index name ,
+  bool diagonal_linearization , bool inexact ) {
+
+ if( n != num_var ) {
+  if( free_rows.size() == num_rows ) {
+   // no row is in use: the slab is simply emptied
+   coefficients.clear();
+   free_rows.clear();
+   num_rows = 0;
+  }
+  else {
+   // the rows in use are rearranged to have length n, by either truncating
+   // or padding them with zeros
+   std::vector< FunctionValue > slab( num_rows * n , 0 );
+   const auto length = std::min( n , num_var );
+   for( Index r = 0 ; r < num_rows ; ++r )
+    std::copy_n( coefficients.data() + r * num_var , length ,
+                 slab.data() + r * n );
+   coefficients = std::move( slab );
+  }
+  num_var = n;
+ }
+
+ if( rows[ name ] == Inf< Index >() ) {
+  if( ! free_rows.empty() ) {
+   rows[ name ] = free_rows.back();
+   free_rows.pop_back();
+  }
+  else {
+   rows[ name ] = num_rows++;
+   coefficients.resize( num_rows * num_var );
+  }
+ }
+
+ std::copy_n( g , n , coefficients.data() + rows[ name ] * num_var );
+ linearization_constants[ name ] = constant;
+ is_diagonal[ name ] = diagonal_linearization ? 1 : 0;
+ is_inexact[ name ] = inexact ? 1 : 0;
+}  // end( InvestmentFunction::GlobalPool::store_row )
+
+/*--------------------------------------------------------------------------*/
+
 bool InvestmentFunction::GlobalPool::is_linearization_there( Index name )
  const {
 
@@ -2730,6 +3430,16 @@ bool InvestmentFunction::GlobalPool::is_linearization_vertical( Index name )
 
 /*--------------------------------------------------------------------------*/
 
+bool InvestmentFunction::GlobalPool::is_linearization_inexact( Index name )
+ const {
+
+ if( name >= size() || std::isnan( linearization_constants[ name ] ) )
+  return( false );
+ return( is_inexact[ name ] );
+}  // end( InvestmentFunction::GlobalPool::is_linearization_inexact )
+
+/*--------------------------------------------------------------------------*/
+
 void InvestmentFunction::GlobalPool::store_combination_of_linearizations
 ( c_LinearCombination & linear_combination , Index name ,
   FunctionValue AAccMlt ) {
@@ -2744,23 +3454,27 @@ void InvestmentFunction::GlobalPool::store_combination_of_linearizations
          ( "InvestmentFunction::GlobalPool::store_combination_of_"
            "linearizations: linear combination is empty." ) );
 
- const auto combine = []( std::vector< FunctionValue > & x ,
-                          const std::vector< FunctionValue > & y ,
-                          const FunctionValue multiplier ) {
-  assert( x.size() == y.size() );
-  for( Index i = 0 ; i < x.size() ; ++i )
-   x[ i ] += multiplier * y[ i ];
- };
-
  bool diagonal_linearization = false;
- std::vector< FunctionValue > coefficients;
+ bool inexact = false;
  FunctionValue constant = 0;
  FunctionValue coeff_sum_diagonal = 0;
 
+ // The combination is accumulated into a scratch vector (and not directly
+ // into the row of name, which may be part of the combination).
+ combination.assign( num_var , 0 );
+ const auto x = combination.data();
+
  for( const auto name_coeff : linear_combination ) {
   const auto linearization_name = name_coeff.first;
   const auto coeff = name_coeff.second;
 
+  if( linearization_name >= size() ||
+      rows[ linearization_name ] == Inf< Index >() )
+   throw( std::invalid_argument
+          ( "InvestmentFunction::GlobalPool::store_combination_of_"
+            "linearizations: linearization with name " +
+            std::to_string( linearization_name ) + " does not exist." ) );
+
   if( coeff < - AAccMlt ) {
    throw( std::invalid_argument
           ( "InvestmentFunction::GlobalPool::store_combination_of_"
@@ -2769,12 +3483,9 @@ void InvestmentFunction::GlobalPool::store_combination_of_linearizations
             std::to_string( coeff ) ) );
   }
 
-  if( coefficients.empty() )
-   coefficients.resize
-    ( linearization_coefficients[ linearization_name ].size() , 0 );
-  else
-   combine( coefficients , linearization_coefficients[ linearization_name ] ,
-            coeff );
+  const auto y = get_row( linearization_name );
+  for( Index i = 0 ; i < num_var ; ++i )
+   x[ i ] += coeff * y[ i ];
 
   constant += coeff * linearization_constants[ linearization_name ];
 
@@ -2782,6 +3493,10 @@ void InvestmentFunction::GlobalPool::store_combination_of_linearizations
    coeff_sum_diagonal += coeff;
    diagonal_linearization = true;
   }
+
+  // a combination involving an inexact linearization is inexact
+  if( is_inexact[ linearization_name ] && ( coeff != 0 ) )
+   inexact = true;
  }
 
  if( diagonal_linearization &&
@@ -2794,7 +3509,8 @@ void InvestmentFunction::GlobalPool::store_combination_of_linearizations
            "linearizations has been provided." ) );
  }
 
- this->store( constant , coefficients , name , diagonal_linearization );
+ store_row( constant , combination.data() , num_var , name ,
+            diagonal_linearization , inexact );
 
 } // end( InvestmentFunction::GlobalPool::store_combination_of_linearizations )
 
@@ -2807,7 +3523,7 @@ void InvestmentFunction::GlobalPool::delete_linearization( const Index name ) {
                                 std::to_string( name ) ) );
 
  linearization_constants[ name ] = NaN;
- linearization_coefficients[ name ] = {};
+ free_row( name );
 }  // end( InvestmentFunction::GlobalPool::delete_linearization )
 
 /*--------------------------------------------------------------------------*/
@@ -2842,8 +3558,13 @@ void InvestmentFunction::GlobalPool::deserialize
  const auto global_pool_size = gs.isNull() ? 0 : gs.getSize();
 
  linearization_constants.assign( global_pool_size , NaN );
- linearization_coefficients.resize( global_pool_size , {} );
- is_diagonal.assign( global_pool_size , true );
+ is_diagonal.assign( global_pool_size , 1 );
+ is_inexact.assign( global_pool_size , 0 );
+ rows.assign( global_pool_size , Inf< Index >() );
+ coefficients.clear();
+ free_rows.clear();
+ num_rows = 0;
+ num_var = 0;
 
  if( global_pool_size ) {
 
@@ -2863,8 +3584,6 @@ void InvestmentFunction::GlobalPool::deserialize
                                       []( FunctionValue v ) {
                                        return( ! std::isnan( v ) ); } );
 
-  Index num_var = 0;
-
   if( num_constants ) {
    // At least one linearization constant is not NaN. In this case, the
    // coefficients must be provided.
@@ -2883,23 +3602,25 @@ void InvestmentFunction::GlobalPool::deserialize
                              "incompatible dimension." ) );
 
    num_var = dim_size / num_constants;
-  }
-
-  Index coeff_start = 0;
 
-  for( Index i = 0 ; i < global_pool_size ; ++i ) {
-   int type;
-   nct.getVar( { i } , &type );
-   is_diagonal[ i ] = ( type != 0 );
+   // The coefficients are read in one go: the linearizations whose
+   // constants are not NaN get the rows of the slab in the order of their
+   // names, which is the order in which they are serialized.
+   num_rows = num_constants;
+   coefficients.resize( dim_size );
+   nc_coeff.getVar( coefficients.data() );
 
-   if( ! std::isnan( linearization_constants[ i ] ) ) {
-    // There is a linearization that is not
-    linearization_coefficients[ i ].resize( num_var );
-    nc_coeff.getVar( { coeff_start } , { num_var } ,
-                     linearization_coefficients[ i ].data() );
-    coeff_start += num_var;
-   }
+   Index r = 0;
+   for( Index i = 0 ; i < global_pool_size ; ++i )
+    if( ! std::isnan( linearization_constants[ i ] ) )
+     rows[ i ] = r++;
   }
+
+  nct.getVar( { 0 } , { global_pool_size } , is_diagonal.data() );
+
+  auto nc_inexact = group.getVar( "InvestmentFunction_Inexact" );
+  if( ! nc_inexact.isNull() )
+   nc_inexact.getVar( { 0 } , { global_pool_size } , is_inexact.data() );
  }
 
  auto nic = group.getDim( "InvestmentFunction_ImpCoeffNum" );
@@ -2939,36 +3660,47 @@ void InvestmentFunction::GlobalPool::serialize( netCDF::NcGroup & group ) const
   group.addVar( "InvestmentFunction_Constants" , netCDF::NcDouble() , size_dim ).
    putVar( linearization_constants.data() );
 
-  Index num_var = 0;
-  Index coeff_dim_size = 0;
-  for( Index i = 0 ; i < global_pool_size ; ++i )
-   if( ! std::isnan( linearization_constants[ i ] ) ) {
-    if( num_var == 0 )
-     num_var = linearization_coefficients[ i ].size();
-    assert( num_var == linearization_coefficients[ i ].size() );
-    coeff_dim_size += num_var;
-   }
+  const auto num_constants =
+   std::count_if( std::cbegin( linearization_constants ) ,
+                  std::cend( linearization_constants ) ,
+                  []( FunctionValue v ) { return( ! std::isnan( v ) ); } );
 
-  if( coeff_dim_size ) {
+  if( num_constants && num_var ) {
    auto nc_coeff_dim = group.addDim( "InvestmentFunction_Coefficients_Dim" ,
-                                     coeff_dim_size );
+                                     num_constants * num_var );
    auto nc_coeff = group.addVar( "InvestmentFunction_Coefficients" ,
                                  netCDF::NcDouble() , nc_coeff_dim );
-   Index coeff_start = 0;
-   for( Index i = 0 ; i < global_pool_size ; ++i )
-    if( ! std::isnan( linearization_constants[ i ] ) ) {
-     nc_coeff.putVar( { coeff_start } , { num_var } ,
-                      linearization_coefficients[ i ].data() );
-     coeff_start += num_var;
-    }
-  }
 
-  std::vector< int > type( global_pool_size );
-  for( Index i = 0 ; i < global_pool_size ; ++i )
-   type[ i ] = is_diagonal[ i ] ? 1 : 0;
+   // If the rows in use are already in the order of the names, the slab is
+   // written as it is (up to its first num_constants rows); otherwise, the
+   // rows are gathered in that order and written in one go.
+   bool in_order = true;
+   Index r = 0;
+   for( Index i = 0 ; ( i < global_pool_size ) && in_order ; ++i )
+    if( ! std::isnan( linearization_constants[ i ] ) )
+     in_order = ( rows[ i ] == r++ );
+
+   if( in_order )
+    nc_coeff.putVar( { 0 } , { num_constants * num_var } ,
+                     coefficients.data() );
+   else {
+    std::vector< FunctionValue > gathered( num_constants * num_var );
+    auto g = gathered.data();
+    for( Index i = 0 ; i < global_pool_size ; ++i )
+     if( ! std::isnan( linearization_constants[ i ] ) ) {
+      g = std::copy_n( get_row( i ) , num_var , g );
+     }
+    nc_coeff.putVar( gathered.data() );
+   }
+  }
 
   group.addVar( "InvestmentFunction_Type" , netCDF::NcByte() , size_dim )
-   .putVar( { 0 } , { global_pool_size } , type.data() );
+   .putVar( { 0 } , { global_pool_size } , is_diagonal.data() );
+
+  if( std::any_of( is_inexact.cbegin() , is_inexact.cend() ,
+                   []( signed char inexact ) { return( inexact ); } ) )
+   group.addVar( "InvestmentFunction_Inexact" , netCDF::NcByte() , size_dim )
+    .putVar( { 0 } , { global_pool_size } , is_inexact.data() );
  }
 
  if( ! important_linearization_lin_comb.empty() ) {
@@ -2994,24 +3726,30 @@ void InvestmentFunction::GlobalPool::serialize( netCDF::NcGroup & group ) const
 
 void InvestmentFunction::GlobalPool::clone( const GlobalPool & global_pool ) {
 
- if( this->size() < global_pool.size() ) {
-  // resize this GlobalPool to accomodate the given elements
-  this->resize( global_pool.size() );
- }
+ // The size of the GlobalPool will be at least the size it currently has.
+ const auto size = std::max( this->size() , global_pool.size() );
+
+ // All the vectors are copied as a whole, reusing the memory of this one.
 
- std::copy( global_pool.is_diagonal.cbegin() ,
-            global_pool.is_diagonal.cend() ,
-            is_diagonal.begin() );
+ is_diagonal = global_pool.is_diagonal;
+ is_inexact = global_pool.is_inexact;
 
- std::copy( global_pool.linearization_constants.cbegin() ,
-            global_pool.linearization_constants.cend() ,
-            linearization_constants.begin() );
+ linearization_constants = global_pool.linearization_constants;
 
  important_linearization_lin_comb =
   global_pool.important_linearization_lin_comb;
 
- for( Index i = 0 ; i < size() ; ++i )
-  linearization_coefficients[ i ] = global_pool.linearization_coefficients[ i ];
+ rows = global_pool.rows;
+ coefficients = global_pool.coefficients;
+ free_rows = global_pool.free_rows;
+ num_rows = global_pool.num_rows;
+ num_var = global_pool.num_var;
+
+ // Possibly resize this GlobalPool so that it has at least the same size it
+ // had before.
+
+ this->resize( size );
+
 }  // end( InvestmentFunction::GlobalPool::clone )
 
 /*--------------------------------------------------------------------------*/
@@ -3022,14 +3760,20 @@ void InvestmentFunction::GlobalPool::clone( GlobalPool && global_pool ) {
  const auto size = std::max( this->size() , global_pool.size() );
 
  is_diagonal = std::move( global_pool.is_diagonal );
+ is_inexact = std::move( global_pool.is_inexact );
 
  linearization_constants = std::move( global_pool.linearization_constants );
 
  important_linearization_lin_comb =
   std::move( global_pool.important_linearization_lin_comb );
 
- linearization_coefficients =
-  std::move( global_pool.linearization_coefficients );
+ rows = std::move( global_pool.rows );
+ coefficients = std::move( global_pool.coefficients );
+ free_rows = std::move( global_pool.free_rows );
+ num_rows = global_pool.num_rows;
+ num_var = global_pool.num_var;
+
+ global_pool.num_rows = global_pool.num_var = 0;
 
  // Possibly resize this GlobalPool so that it has at least the same size it
  // had before.
@@ -3042,16 +3786,19 @@ void InvestmentFunction::GlobalPool::clone( GlobalPool && global_pool ) {
 
 void InvestmentFunction::GlobalPool::get_linearization_coefficients
 ( FunctionValue * g , Range range , Index name ) const {
- for( Index i = range.first ; i < range.second ; ++i )
-  g[ i - range.first ] = linearization_coefficients[ name ][ i ];
+ assert( range.second <= num_var );
+ const auto row = get_row( name );
+ std::copy( row + range.first , row + range.second , g );
 }  // end( InvestmentFunction::GlobalPool::get_linearization_coefficients )
 
 /*--------------------------------------------------------------------------*/
 
 void InvestmentFunction::GlobalPool::get_linearization_coefficients
 ( SparseVector & g , Range range , Index name ) const {
+ assert( range.second <= num_var );
+ const auto row = get_row( name );
  for( Index i = range.first ; i < range.second ; ++i )
-  g.coeffRef( i ) = linearization_coefficients[ name ][ i ];
+  g.coeffRef( i ) = row[ i ];
 }  // end( InvestmentFunction::GlobalPool::get_linearization_coefficients )
 
 /*--------------------------------------------------------------------------*/
@@ -3059,9 +3806,11 @@ void InvestmentFunction::GlobalPool::get_linearization_coefficients
 void InvestmentFunction::GlobalPool::get_linearization_coefficients
 ( FunctionValue * g , c_Subset & subset , const bool ordered , Index name )
  const {
- Index k = 0;
- for( auto i : subset )
-  g[ k++ ] = linearization_coefficients[ name ][ i ];
+ const auto row = get_row( name );
+ const auto k = subset.size();
+ const auto indices = subset.data();
+ for( Index j = 0 ; j < k ; ++j )
+  g[ j ] = row[ indices[ j ] ];
 }  // end( InvestmentFunction::GlobalPool::get_linearization_coefficients )
 
 /*--------------------------------------------------------------------------*/
@@ -3069,10 +3818,169 @@ void InvestmentFunction::GlobalPool::get_linearization_coefficients
 void InvestmentFunction::GlobalPool::get_linearization_coefficients
 ( SparseVector & g , c_Subset & subset , const bool ordered , Index name )
  const {
+ const auto row = get_row( name );
  for( auto i : subset )
-  g.coeffRef( i ) = linearization_coefficients[ name ][ i ];
+  g.coeffRef( i ) = row[ i ];
 }  // end( InvestmentFunction::GlobalPool::get_linearization_coefficients )
 
+/*--------------------------------------------------------------------------*/
+/*--------------------------- SubBlockPool ---------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::SubBlockPool::resize( Index size ) {
+ std::lock_guard< std::mutex > lock( mutex );
+
+ if( in_use.size() == size && free_list.size() == size )
+  return;
+
+ in_use.assign( size , false );
+ free_list.resize( size );
+
+ // The indices are stored in decreasing order so that the sub-Blocks are
+ // handed out starting from the first one.
+ for( Index i = 0 ; i < size ; ++i )
+  free_list[ i ] = size - 1 - i;
+}  // end( InvestmentFunction::SubBlockPool::resize )
+
+/*--------------------------------------------------------------------------*/
+
+Index InvestmentFunction::SubBlockPool::acquire() {
+ std::unique_lock< std::mutex > lock( mutex );
+
+ if( in_use.empty() )
+  throw( std::logic_error( "InvestmentFunction::SubBlockPool::acquire: "
+                           "there is no sub-Block in the pool." ) );
+
+ if( free_list.empty() ) {
+  // No sub-Block is available. Wait until some sub-Block is released.
+  const auto start = std::chrono::steady_clock::now();
+  available.wait( lock , [ this ]() { return( ! free_list.empty() ); } );
+  const std::chrono::duration< double > elapsed =
+   std::chrono::steady_clock::now() - start;
+  ++number_waits;
+  total_wait_time += elapsed.count();
+  max_wait_time = std::max( max_wait_time , elapsed.count() );
+ }
+
+ const auto i = free_list.back();
+ free_list.pop_back();
+ in_use[ i ] = true;
+ ++number_acquisitions;
+ return( i );
+}  // end( InvestmentFunction::SubBlockPool::acquire )
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::SubBlockPool::release( Index i ) {
+ {
+  std::lock_guard< std::mutex > lock( mutex );
+  if( i >= in_use.size() || ( ! in_use[ i ] ) )
+   return;
+  in_use[ i ] = false;
+  free_list.push_back( i );
+ }
+ available.notify_one();
+}  // end( InvestmentFunction::SubBlockPool::release )
+
+/*--------------------------------------------------------------------------*/
+
+unsigned long InvestmentFunction::SubBlockPool::get_number_acquisitions()
+ const {
+ std::lock_guard< std::mutex > lock( mutex );
+ return( number_acquisitions );
+}
+
+/*--------------------------------------------------------------------------*/
+
+unsigned long InvestmentFunction::SubBlockPool::get_number_waits() const {
+ std::lock_guard< std::mutex > lock( mutex );
+ return( number_waits );
+}
+
+/*--------------------------------------------------------------------------*/
+
+double InvestmentFunction::SubBlockPool::get_total_wait_time() const {
+ std::lock_guard< std::mutex > lock( mutex );
+ return( total_wait_time );
+}
+
+/*--------------------------------------------------------------------------*/
+
+double InvestmentFunction::SubBlockPool::get_max_wait_time() const {
+ std::lock_guard< std::mutex > lock( mutex );
+ return( max_wait_time );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::SubBlockPool::reset_statistics() {
+ std::lock_guard< std::mutex > lock( mutex );
+ number_acquisitions = 0;
+ number_waits = 0;
+ total_wait_time = 0;
+ max_wait_time = 0;
+}  // end( InvestmentFunction::SubBlockPool::reset_statistics )
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- EvaluationCache -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::EvaluationCache::set_capacity( Index capacity ) {
+ this->capacity = capacity;
+ while( entries.size() > capacity ) {
+  index.erase( entries.back().first );
+  entries.pop_back();
+ }
+}  // end( InvestmentFunction::EvaluationCache::set_capacity )
+
+/*--------------------------------------------------------------------------*/
+
+std::vector< double > InvestmentFunction::EvaluationCache::get_key
+( std::vector< double > x ) const {
+ if( step > 0 )
+  for( auto & x_i : x )
+   x_i = step * std::round( x_i / step );
+ return( x );
+}  // end( InvestmentFunction::EvaluationCache::get_key )
+
+/*--------------------------------------------------------------------------*/
+
+const InvestmentFunction::EvaluationCache::Entry *
+InvestmentFunction::EvaluationCache::find( const std::vector< double > & key ) {
+ const auto it = index.find( key );
+ if( it == index.end() )
+  return( nullptr );
+
+ // This becomes the most recently used evaluation
+ entries.splice( entries.begin() , entries , it->second );
+ return( & entries.front().second );
+}  // end( InvestmentFunction::EvaluationCache::find )
+
+/*--------------------------------------------------------------------------*/
+
+void InvestmentFunction::EvaluationCache::insert( std::vector< double > key ,
+                                                  Entry entry ) {
+ if( capacity == 0 )
+  return;
+
+ const auto it = index.find( key );
+ if( it != index.end() ) {
+  // Replace the evaluation currently stored under this key
+  it->second->second = std::move( entry );
+  entries.splice( entries.begin() , entries , it->second );
+  return;
+ }
+
+ if( entries.size() >= capacity ) {
+  // Discard the least recently used evaluation
+  index.erase( entries.back().first );
+  entries.pop_back();
+ }
+
+ entries.emplace_front( key , std::move( entry ) );
+ index.emplace( std::move( key ) , entries.begin() );
+}  // end( InvestmentFunction::EvaluationCache::insert )
+
 /*--------------------------------------------------------------------------*/
 /*------------------------ InvestmentFunctionState -------------------------*/
 /*--------------------------------------------------------------------------*/
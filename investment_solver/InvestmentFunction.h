@@ -28,6 +28,19 @@
 #include "C05Function.h"
 #include "CDASolver.h"
 
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <tuple>
+
+class CutSet;                  // forward declaration of CutSet (CutSet.h)
+class NetCDFSolutionOutput;    // forward declaration of NetCDFSolutionOutput
+class SDDPBlockSolutionOutput; // forward declaration of SDDPBlockSolutionOutput
+class SolutionWriter;          // forward declaration of SolutionWriter
+
 /*--------------------------------------------------------------------------*/
 /*--------------------------- NAMESPACE ------------------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -98,6 +111,13 @@ class InvestmentFunction : public C05Function , public Block {
 
  enum ConstraintSide { eLHS = 0 , eRHS = 1 };
 
+ /// public enum representing the values of the intScenarioSchedule parameter
+ /** Public enum representing how the scenarios are distributed among the
+  * threads (see #intScenarioSchedule). */
+
+ enum ScenarioSchedule { eStaticSchedule = 0 , eDynamicSchedule = 1 ,
+                         eCostSchedule = 2 };
+
  /* Since InvestmentFunction is both a ThinVarDepInterface and a Block, it
   * "sees" two definitions of "Index", "Range", and "Subset". These are
   * actually the same, but compilers still don't like it. Disambiguate by
@@ -248,6 +268,100 @@ class InvestmentFunction : public C05Function , public Block {
    * while this InvestmentFunction is being compute()-ed. The default value of
    * this parameter is 0, which means that no solution is output. */
 
+  intDistributeScenarios ,
+  ///< indicates whether the scenarios must be distributed among MPI processes
+  /**< If the value for this parameter is nonzero and the code is compiled
+   * with USE_MPI, then the scenarios are distributed among the processes of
+   * the world communicator: the process of rank r evaluates the scenarios
+   * whose index is congruent to r modulo the number of processes (each
+   * process using its own sub-Blocks). At the beginning of compute(), the
+   * values of the active Variable of the process of rank 0 are broadcast to
+   * all processes and, once the scenarios have been evaluated, the function
+   * value and the linearization are reduced over all processes, so that
+   * every process ends up with the same result. This requires compute() to
+   * be called collectively by all processes. If the code is not compiled
+   * with USE_MPI, this parameter is ignored. The default value of this
+   * parameter is 0. */
+
+  intEvaluationCacheSize ,
+  ///< maximum number of evaluations kept in the evaluation cache
+  /**< InvestmentFunction can keep a cache of the most recent evaluations,
+   * i.e., of the function value, the (diagonal) linearization (if it was
+   * computed) and the value of each scenario, associated with the point at
+   * which the function was computed. If compute() is called at a point that
+   * is in the cache (see #dblEvaluationCacheStep), the scenarios are not
+   * evaluated and the cached results are used instead. This parameter is the
+   * maximum number of evaluations kept in the cache; when it is exceeded,
+   * the least recently used evaluation is discarded. The cache is emptied
+   * whenever the sub-Blocks are modified. The default value of this
+   * parameter is 0, which means that no evaluation is cached. */
+
+  intScenarioSampleSize ,
+  ///< number of scenarios sampled when the function is computed
+  /**< If this parameter has a positive value n smaller than the number N of
+   * scenarios, then compute() does not evaluate all scenarios: it evaluates
+   * a subset of n scenarios chosen uniformly at random (without
+   * replacement), and the value (and the linearization) of the function is
+   * estimated by the sample mean. The standard error of this estimate is
+   * available through get_standard_error(), and the linearizations stored
+   * in the global pool after such an evaluation are marked as inexact (see
+   * is_linearization_inexact()). The sample size may grow from one call of
+   * compute() to the next, according to #dblScenarioSampleGrowth and
+   * #dblScenarioSampleRelError, until all scenarios are evaluated. Setting
+   * this parameter restarts the sample size at the given value. The default
+   * value of this parameter is 0, which means that all scenarios are always
+   * evaluated. */
+
+  intScenarioSampleSeed ,
+  ///< seed of the random number generator used for sampling the scenarios
+  /**< Setting this parameter reseeds the random number generator used for
+   * sampling the scenarios (see #intScenarioSampleSize). The default value
+   * of this parameter is 0. */
+
+  intWarmStart ,
+  ///< indicates whether the inner Solvers must be warm started
+  /**< If the value of this parameter is nonzero, then, after a scenario has
+   * been successfully evaluated, the State of the Solver attached to the
+   * UCBlock of each stage is retrieved (by get_State()) and kept, associated
+   * with that scenario. The next time the same scenario is evaluated, these
+   * States are given (by put_State()) to the Solvers attached to the UCBlocks
+   * of the sub-Block on which the scenario is evaluated, which need not be
+   * the same sub-Block as before (all sub-Blocks being identical). Solvers
+   * that do not provide a State are simply not warm started; the States are
+   * discarded whenever the sub-Blocks are modified. The default value of
+   * this parameter is 0, which means that no State is kept. */
+
+  intKeepSolutions ,
+  ///< indicates whether the solutions must be kept instead of being output
+  /**< If the value of this parameter is nonzero and #intOutputSolution is
+   * nonzero, then the solutions of the UCBlocks for each scenario are not
+   * output while this InvestmentFunction is being compute()-ed: they are
+   * copied into a SolutionSet, which is kept until the next call to
+   * compute() (see get_kept_solutions()) and can be output later by
+   * output_solutions(). This avoids writing (and copying) the solutions of
+   * every evaluation when only the ones of a particular evaluation (e.g.,
+   * the best one) are needed, at the cost of keeping them in memory. The
+   * default value of this parameter is 0. */
+
+  intScenarioSchedule ,
+  ///< how the scenarios are distributed among the threads
+  /**< This parameter determines how the scenarios evaluated (by this
+   * process) in a call to compute() are distributed among the threads:
+   *
+   * - 0 (eStaticSchedule): the scenarios are split, in order, into blocks
+   *   of (almost) the same size, one for each thread;
+   *
+   * - 1 (eDynamicSchedule): each thread takes the next scenario, in order,
+   *   as soon as it has finished the previous one;
+   *
+   * - 2 (eCostSchedule): as 1, but the scenarios are taken in decreasing
+   *   order of the time taken by their most recent evaluation (the scenarios
+   *   that have never been evaluated come first), so that the longest
+   *   scenarios do not keep a single thread busy at the end.
+   *
+   * The time taken by each scenario is recorded whatever the value of this
+   * parameter. The default value of this parameter is 0. */
+
   intLastParInvestmentF
   ///< first allowed new int parameter for derived classes
   /**< Convenience value for easily allow derived classes to extend the set of
@@ -255,6 +369,61 @@ class InvestmentFunction : public C05Function , public Block {
 
  };  // end( int_par_type_InvestmentF )
 
+/*--------------------------------------------------------------------------*/
+ /// public enum for the double algorithmic parameters
+ /** Public enum describing the different algorithmic parameters of double
+  * type that InvestmentFunction has in addition to those of C05Function. The
+  * value dblLastParInvestmentF is provided so that the list can be easily
+  * further extended by derived classes. */
+
+ enum dbl_par_type_InvestmentF {
+
+  dblInvestmentUpdateTol = dblLastParC05F ,
+  ///< tolerance for propagating a change of investment to the sub-Blocks
+  /**< Before the scenarios are evaluated, the sub-Blocks are updated to
+   * reflect the current values of the active Variable. Each sub-Block
+   * remembers the investment that has last been applied to it, and an asset
+   * is updated only if its current investment differs from the applied one
+   * by more than this tolerance (in absolute value). The default value of
+   * this parameter is 0, which means that every change is propagated. */
+
+  dblEvaluationCacheStep ,
+  ///< quantization step for the points in the evaluation cache
+  /**< The points stored in the evaluation cache (see
+   * #intEvaluationCacheSize) are quantized: if this parameter has a positive
+   * value q, each component x_i of a point is replaced by q * round( x_i / q
+   * ), so that two points whose quantized components coincide are regarded
+   * as the same point. If this parameter is 0, points must coincide exactly.
+   * The default value of this parameter is 0. */
+
+  dblScenarioSampleGrowth ,
+  ///< growth factor of the number of sampled scenarios
+  /**< If the scenarios are sampled (see #intScenarioSampleSize), then after
+   * each call to compute() the sample size n is replaced by ceil( g * n ),
+   * where g is the value of this parameter (but never by more than the
+   * number of scenarios). The default value of this parameter is 2, so that
+   * the sample size doubles at each call until all scenarios are evaluated;
+   * with the value 1, the sample size grows only according to
+   * #dblScenarioSampleRelError (and never grows if this is 0). */
+
+  dblScenarioSampleRelError ,
+  ///< target relative standard error of the sampled function value
+  /**< If the scenarios are sampled (see #intScenarioSampleSize) and this
+   * parameter has a positive value r, then after each call to compute() the
+   * relative standard error e = get_standard_error() / | v | of the estimated
+   * value v is compared with r. If e > r, then the sample size n for the next
+   * call is increased to (at least) ceil( n * ( e / r )^2 ), which is the
+   * sample size that is expected to attain the target relative error. The
+   * default value of this parameter is 0, which means that the sample size
+   * is not adjusted in this way. */
+
+  dblLastParInvestmentF
+  ///< first allowed new double parameter for derived classes
+  /**< Convenience value for easily allow derived classes to extend the set of
+   * double algorithmic parameters. */
+
+ };  // end( dbl_par_type_InvestmentF )
+
 /*--------------------------------------------------------------------------*/
  /// public enum for the string algorithmic parameters
  /** Public enum describing the different algorithmic parameters of "string"
@@ -271,6 +440,18 @@ class InvestmentFunction : public C05Function , public Block {
    * compute()-ed. If it is empty, then the variable and function values are
    * not output. The default value for this parameter is the empty string. */
 
+  strSolutionFilename ,
+  ///< name of the netCDF file into which the solutions are output
+  /**< This is the name of the netCDF-4 file into which the solutions of the
+   * UCBlocks are output if #intOutputSolution is nonzero (see
+   * NetCDFSolutionOutput). The file is replaced every time this
+   * InvestmentFunction is compute()-ed. If the scenarios are distributed
+   * among several processes, every process writes its own file, whose name
+   * is obtained by appending "_<rank>" to the stem of the given name (see
+   * get_solution_filename()). If this parameter is empty, then the solutions
+   * are output into CSV files (see SDDPBlockSolutionOutput). The default
+   * value for this parameter is the empty string. */
+
   strLastParInvestmentF
   ///< first allowed new string parameter for derived classes
   /**< Convenience value for easily allow derived classes to extend the set of
@@ -550,6 +731,10 @@ class InvestmentFunction : public C05Function , public Block {
   v_Block.clear();
   v_Block.push_back( block );
 
+  cancel_shared_cuts();
+  clear_solution_outputs();
+  v_stage_map.clear(); // the StageMaps must be rebuilt
+
   if( block )
    block->set_f_Block( this );
 
@@ -592,6 +777,10 @@ class InvestmentFunction : public C05Function , public Block {
   v_Block.clear();
   v_Block = blocks;
 
+  cancel_shared_cuts();
+  clear_solution_outputs();
+  v_stage_map.clear(); // the StageMaps must be rebuilt
+
   for( auto block : v_Block )
    if( block )
     block->set_f_Block( this );
@@ -619,9 +808,16 @@ class InvestmentFunction : public C05Function , public Block {
   *                       parameter is nonzero, then part of the primal and
   *                       dual solutions obtained for each UCBlock for each
   *                       scenario is output while this InvestmentFunction is
-  *                       being compute()-ed. The default value of this
-  *                       parameter is 0, which means that no solution is
-  *                       output.
+  *                       being compute()-ed. The solutions are copied
+  *                       and the sub-Blocks unlocked right away, while a
+  *                       background thread (see SolutionWriter) outputs
+  *                       them. The default value of this parameter is 0,
+  *                       which means that no solution is output.
+  *
+  * - #intKeepSolutions: This parameter indicates whether the solutions must
+  *                      be kept in memory instead of being output (see
+  *                      get_kept_solutions()). The default value of this
+  *                      parameter is 0.
   *
   * Any other parameter is handled by the C05Function.
   *
@@ -639,6 +835,14 @@ class InvestmentFunction : public C05Function , public Block {
   *
   * - #dblAAccMlt
   *
+  * - #dblInvestmentUpdateTol
+  *
+  * - #dblEvaluationCacheStep
+  *
+  * - #dblScenarioSampleGrowth
+  *
+  * - #dblScenarioSampleRelError
+  *
   * @param par The parameter to be set.
   *
   * @return The value of the parameter. */
@@ -649,6 +853,34 @@ class InvestmentFunction : public C05Function , public Block {
    case( dblAAccMlt ):
     AAccMlt = value;
     break;
+   case( dblInvestmentUpdateTol ):
+    if( value < 0 )
+     throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                   "dblInvestmentUpdateTol must be "
+                                   "non-negative" ) );
+    f_investment_update_tolerance = value;
+    break;
+   case( dblEvaluationCacheStep ):
+    if( value < 0 )
+     throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                   "dblEvaluationCacheStep must be "
+                                   "non-negative" ) );
+    evaluation_cache.set_step( value );
+    break;
+   case( dblScenarioSampleGrowth ):
+    if( value < 1 )
+     throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                   "dblScenarioSampleGrowth must be at "
+                                   "least 1" ) );
+    f_scenario_sample_growth = value;
+    break;
+   case( dblScenarioSampleRelError ):
+    if( value < 0 )
+     throw( std::invalid_argument( "InvestmentFunction::set_par: "
+                                   "dblScenarioSampleRelError must be "
+                                   "non-negative" ) );
+    f_scenario_sample_rel_error = value;
+    break;
    default: C05Function::set_par( par , value );
   }
  }
@@ -660,6 +892,8 @@ class InvestmentFunction : public C05Function , public Block {
   *
   * - #strOutputFilename
   *
+  * - #strSolutionFilename
+  *
   * @param par The parameter to be set.
   *
   * @return The value of the parameter. */
@@ -669,6 +903,9 @@ class InvestmentFunction : public C05Function , public Block {
    case( strOutputFilename ):
     f_output_filename = std::move( value );
     break;
+   case( strSolutionFilename ):
+    f_solution_filename = std::move( value );
+    break;
    default: C05Function::set_par( par , value );
   }
  }
@@ -689,6 +926,17 @@ class InvestmentFunction : public C05Function , public Block {
   return( intLastParInvestmentF );
  }
 
+/*--------------------------------------------------------------------------*/
+ /// get the number of double parameters
+ /** Get the number of double parameters.
+  *
+  * @return The number of double parameters.
+  */
+
+ [[nodiscard]] idx_type get_num_dbl_par() const override {
+  return( dblLastParInvestmentF );
+ }
+
 /*--------------------------------------------------------------------------*/
  /// get the number of string parameters
  /** Get the number of string parameters.
@@ -712,6 +960,20 @@ class InvestmentFunction : public C05Function , public Block {
   *
   * - #intOutputSolution
   *
+  * - #intDistributeScenarios
+  *
+  * - #intEvaluationCacheSize
+  *
+  * - #intScenarioSampleSize
+  *
+  * - #intScenarioSampleSeed
+  *
+  * - #intWarmStart
+  *
+  * - #intKeepSolutions
+  *
+  * - #intScenarioSchedule
+  *
   * Any other parameter is handled by the C05Function.
   *
   * @param par The parameter whose value is desired.
@@ -723,6 +985,13 @@ class InvestmentFunction : public C05Function , public Block {
    case( intGPMaxSz ): return( global_pool.size() );
    case( intComputeLinearization ): return( f_compute_linearization );
    case( intOutputSolution ): return( f_output_solution );
+   case( intDistributeScenarios ): return( f_distribute_scenarios );
+   case( intEvaluationCacheSize ): return( evaluation_cache.get_capacity() );
+   case( intScenarioSampleSize ): return( f_scenario_sample_size );
+   case( intScenarioSampleSeed ): return( f_scenario_sample_seed );
+   case( intWarmStart ): return( f_warm_start );
+   case( intKeepSolutions ): return( f_keep_solutions );
+   case( intScenarioSchedule ): return( f_scenario_schedule );
   }
   return( C05Function::get_int_par( par ) );
  }
@@ -734,6 +1003,14 @@ class InvestmentFunction : public C05Function , public Block {
   *
   * - #dblAAccMlt
   *
+  * - #dblInvestmentUpdateTol
+  *
+  * - #dblEvaluationCacheStep
+  *
+  * - #dblScenarioSampleGrowth
+  *
+  * - #dblScenarioSampleRelError
+  *
   * Any other parameter is handled by the C05Function.
   *
   * @param par The parameter whose value is desired.
@@ -743,6 +1020,10 @@ class InvestmentFunction : public C05Function , public Block {
  [[nodiscard]] double get_dbl_par( idx_type par ) const override {
   switch( par ) {
    case( dblAAccMlt ): return( AAccMlt );
+   case( dblInvestmentUpdateTol ): return( f_investment_update_tolerance );
+   case( dblEvaluationCacheStep ): return( evaluation_cache.get_step() );
+   case( dblScenarioSampleGrowth ): return( f_scenario_sample_growth );
+   case( dblScenarioSampleRelError ): return( f_scenario_sample_rel_error );
   }
 
   return( C05Function::get_dbl_par( par ) );
@@ -762,6 +1043,7 @@ class InvestmentFunction : public C05Function , public Block {
  const std::string & get_str_par( const idx_type par ) const override {
   switch( par ) {
    case( strOutputFilename ): return( f_output_filename );
+   case( strSolutionFilename ): return( f_solution_filename );
   }
   return( C05Function::get_str_par( par ) );
  }
@@ -773,9 +1055,37 @@ class InvestmentFunction : public C05Function , public Block {
    return( 1 );
   if( par == intOutputSolution )
    return( 0 );
+  if( par == intDistributeScenarios )
+   return( 0 );
+  if( par == intEvaluationCacheSize )
+   return( 0 );
+  if( par == intScenarioSampleSize )
+   return( 0 );
+  if( par == intScenarioSampleSeed )
+   return( 0 );
+  if( par == intWarmStart )
+   return( 0 );
+  if( par == intKeepSolutions )
+   return( 0 );
+  if( par == intScenarioSchedule )
+   return( eStaticSchedule );
   return( C05Function::get_dflt_int_par( par ) );
  }
 
+/*--------------------------------------------------------------------------*/
+
+ [[nodiscard]] double get_dflt_dbl_par( idx_type par ) const override {
+  if( par == dblInvestmentUpdateTol )
+   return( 0 );
+  if( par == dblEvaluationCacheStep )
+   return( 0 );
+  if( par == dblScenarioSampleGrowth )
+   return( 2 );
+  if( par == dblScenarioSampleRelError )
+   return( 0 );
+  return( C05Function::get_dflt_dbl_par( par ) );
+ }
+
 /*--------------------------------------------------------------------------*/
 
  /// get the default value of a string parameter
@@ -790,7 +1100,7 @@ class InvestmentFunction : public C05Function , public Block {
  [[nodiscard]] const std::string & get_dflt_str_par( const idx_type par )
   const override {
 
-  static const std::vector< std::string > default_values = { "" };
+  static const std::vector< std::string > default_values = { "" , "" };
 
   if( par >= str_par_type_C05F::strLastParC05F &&
       par < str_par_type_InvestmentF::strLastParInvestmentF )
@@ -807,9 +1117,38 @@ class InvestmentFunction : public C05Function , public Block {
    return( intComputeLinearization );
   if( name == "intOutputSolution" )
    return( intOutputSolution );
+  if( name == "intDistributeScenarios" )
+   return( intDistributeScenarios );
+  if( name == "intEvaluationCacheSize" )
+   return( intEvaluationCacheSize );
+  if( name == "intScenarioSampleSize" )
+   return( intScenarioSampleSize );
+  if( name == "intScenarioSampleSeed" )
+   return( intScenarioSampleSeed );
+  if( name == "intWarmStart" )
+   return( intWarmStart );
+  if( name == "intKeepSolutions" )
+   return( intKeepSolutions );
+  if( name == "intScenarioSchedule" )
+   return( intScenarioSchedule );
   return( C05Function::int_par_str2idx( name ) );
  }
 
+/*--------------------------------------------------------------------------*/
+
+ [[nodiscard]] idx_type dbl_par_str2idx( const std::string & name )
+  const override {
+  if( name == "dblInvestmentUpdateTol" )
+   return( dblInvestmentUpdateTol );
+  if( name == "dblEvaluationCacheStep" )
+   return( dblEvaluationCacheStep );
+  if( name == "dblScenarioSampleGrowth" )
+   return( dblScenarioSampleGrowth );
+  if( name == "dblScenarioSampleRelError" )
+   return( dblScenarioSampleRelError );
+  return( C05Function::dbl_par_str2idx( name ) );
+ }
+
 /*--------------------------------------------------------------------------*/
 
  /// returns the index of the string parameter with given string name
@@ -824,6 +1163,7 @@ class InvestmentFunction : public C05Function , public Block {
  [[nodiscard]] idx_type str_par_str2idx( const std::string & name )
   const override {
   if( name == "strOutputFilename" ) return( strOutputFilename );
+  if( name == "strSolutionFilename" ) return( strSolutionFilename );
   return( C05Function::str_par_str2idx( name ) );
  }
 
@@ -832,12 +1172,31 @@ class InvestmentFunction : public C05Function , public Block {
  [[nodiscard]] const std::string & int_par_idx2str( idx_type idx )
   const override {
   static const std::vector< std::string > pars = { "intComputeLinearization" ,
-                                                   "intOutputSolution" };
+                                                   "intOutputSolution" ,
+                                                   "intDistributeScenarios" ,
+                                                   "intEvaluationCacheSize" ,
+                                                   "intScenarioSampleSize" ,
+                                                   "intScenarioSampleSeed" ,
+                                                   "intWarmStart" ,
+                                                   "intKeepSolutions" ,
+                                                   "intScenarioSchedule" };
   if( ( idx >= intComputeLinearization ) && ( idx < intLastParInvestmentF ) )
    return( pars[ idx - intComputeLinearization ] );
   return( C05Function::int_par_idx2str( idx ) );
  }
 
+/*--------------------------------------------------------------------------*/
+
+ [[nodiscard]] const std::string & dbl_par_idx2str( idx_type idx )
+  const override {
+  static const std::vector< std::string > pars =
+   { "dblInvestmentUpdateTol" , "dblEvaluationCacheStep" ,
+     "dblScenarioSampleGrowth" , "dblScenarioSampleRelError" };
+  if( ( idx >= dblInvestmentUpdateTol ) && ( idx < dblLastParInvestmentF ) )
+   return( pars[ idx - dblInvestmentUpdateTol ] );
+  return( C05Function::dbl_par_idx2str( idx ) );
+ }
+
 /*--------------------------------------------------------------------------*/
 
  /// returns the string name of the string parameter with given index
@@ -852,7 +1211,7 @@ class InvestmentFunction : public C05Function , public Block {
  const std::string & str_par_idx2str( const idx_type idx ) const override {
 
   static const std::vector< std::string > parameter_names =
-   { "strOutputFilename" };
+   { "strOutputFilename" , "strSolutionFilename" };
 
   if( idx >= str_par_type_C05F::strLastParC05F &&
       idx < str_par_type_InvestmentF::strLastParInvestmentF )
@@ -1122,6 +1481,27 @@ class InvestmentFunction : public C05Function , public Block {
   f_num_sub_blocks = n;
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// makes the sub-Blocks share the cuts of the given one
+ /** This function takes a copy of the cuts of every PolyhedralFunction of
+  * the \p source sub-Block (see CutSet), which is then shared (read-only)
+  * by all sub-Blocks, and removes the cuts of all the other sub-Blocks. A
+  * sub-Block receives its own copy of the shared cuts only when it is used
+  * for the first time by compute(), so that the sub-Blocks that are never
+  * used (e.g., because there are more sub-Blocks than threads, or than
+  * scenarios to be evaluated by this process) do not hold any cut. The
+  * shared copy is released as soon as every sub-Block has received it.
+  *
+  * This relies on the sub-Blocks being identical (as they are after
+  * deserialize()): each of them loses its own cuts, which are replaced by
+  * those of the \p source sub-Block. Setting new sub-Blocks (see
+  * set_inner_blocks()) cancels the sharing.
+  *
+  * @param source The index of the sub-Block whose cuts are shared. */
+
+ void share_cuts( Index source = 0 );
+
 /** @} ---------------------------------------------------------------------*/
 /*----------- METHODS FOR Saving THE DATA OF THE InvestmentFunction --------*/
 /*--------------------------------------------------------------------------*/
@@ -1334,6 +1714,18 @@ class InvestmentFunction : public C05Function , public Block {
   return( global_pool.is_linearization_vertical( name ) );
  }
 
+/*--------------------------------------------------------------------------*/
+ /// tells whether the linearization with the given name is inexact
+ /** Returns true if the linearization in the global pool with the given
+  * name has been computed from a sample of the scenarios (see
+  * #intScenarioSampleSize), or is a combination involving such a
+  * linearization. An inexact linearization is only an estimate: it is not
+  * guaranteed to be a valid linearization of the function. */
+
+ bool is_linearization_inexact( Index name ) const {
+  return( global_pool.is_linearization_inexact( name ) );
+ }
+
 /*--------------------------------------------------------------------------*/
  /// stores a combination of the given linearizations
  /** This method creates a combination of the given set of linearizations,
@@ -1500,6 +1892,118 @@ class InvestmentFunction : public C05Function , public Block {
 
  SDDPBlock * get_sddp_block( Index i ) const;
 
+/*--------------------------------------------------------------------------*/
+
+ /// returns the name of the netCDF file into which this process outputs
+ /** This function returns the name of the netCDF file into which this
+  * process outputs the solutions of the UCBlocks (see
+  * #strSolutionFilename). If the scenarios are distributed among more than
+  * one process, then "_<rank>" is appended to the stem of the name given by
+  * #strSolutionFilename, where <rank> is the rank of this process (e.g.,
+  * "solution.nc4" becomes "solution_1.nc4" for the process of rank 1). An
+  * empty string is returned if #strSolutionFilename is empty.
+  *
+  * @return The name of the netCDF file of the solutions of this process. */
+
+ std::string get_solution_filename() const;
+
+/*--------------------------------------------------------------------------*/
+
+ /// the solutions of the scenarios evaluated in a call to compute()
+ /** A SolutionSet holds a copy of the solutions of the UCBlocks for each
+  * scenario evaluated (by this process) in a call to compute(). Its
+  * definition is private to InvestmentFunction: it can only be kept (see
+  * get_kept_solutions()) and output (see output_solutions()). */
+
+ class SolutionSet;
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the solutions kept in the most recent call to compute()
+ /** If #intOutputSolution and #intKeepSolutions are nonzero, this function
+  * returns the SolutionSet holding the solutions of the scenarios evaluated
+  * by this process in the most recent call to compute() that evaluated
+  * them. Otherwise, it returns nullptr. The returned SolutionSet is not
+  * modified by the following calls to compute(), which use a new one while
+  * it is shared; keeping it is therefore as cheap as copying a pointer.
+  *
+  * @return The solutions kept in the most recent call to compute(). */
+
+ std::shared_ptr< const SolutionSet > get_kept_solutions() const {
+  return( f_kept_solutions );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// outputs the given solutions
+ /** This function outputs the given solutions exactly as compute() would
+  * have output them if #intKeepSolutions were zero: into the netCDF file
+  * given by get_solution_filename(), if it is not empty, or into CSV files
+  * (see SDDPBlockSolutionOutput) otherwise. If the scenarios are
+  * distributed among several processes, each process outputs the solutions
+  * of its own scenarios.
+  *
+  * @param solutions The solutions to be output. */
+
+ void output_solutions( const SolutionSet & solutions ) const;
+
+/*--------------------------------------------------------------------------*/
+ /// returns the value of each scenario in the most recent call to compute()
+ /** This function returns a vector whose i-th element is the value of the
+  * i-th scenario (i.e., the optimal value of the problem associated with
+  * that scenario, without considering the investment costs) that was
+  * obtained in the most recent call to compute() that evaluated the
+  * scenarios (or that found them in the evaluation cache). */
+
+ const std::vector< double > & get_scenario_values() const {
+  return( v_scenario_value );
+ }
+
+/*--------------------------------------------------------------------------*/
+ /// returns the standard error of the most recently computed function value
+ /** If the scenarios were sampled in the most recent call to compute() (see
+  * #intScenarioSampleSize), the function value is an estimate given by the
+  * mean of the values of the sampled scenarios. This function returns the
+  * standard error of this estimate (which includes the finite population
+  * correction). If all scenarios were evaluated, it returns 0. */
+
+ double get_standard_error() const { return( f_standard_error ); }
+
+/*--------------------------------------------------------------------------*/
+ /// returns the number of scenarios evaluated in the most recent compute()
+
+ Index get_number_sampled_scenarios() const {
+  return( f_number_sampled_scenarios );
+ }
+
+/*--------------------------------------------------------------------------*/
+ /// returns the statistics about the waits for a sub-Block
+ /** While computing the function, each scenario is evaluated by a thread
+  * that must first acquire one of the sub-Blocks of this InvestmentFunction.
+  * If there are more threads than sub-Blocks, a thread may have to wait
+  * until some sub-Block becomes available. This function returns, in this
+  * order, the number of times a sub-Block has been acquired, the number of
+  * times a thread had to wait for a sub-Block, the total time (in seconds)
+  * spent waiting, and the longest single wait (in seconds). These
+  * statistics are accumulated over all calls to compute() since the
+  * construction of this InvestmentFunction or since the last call to
+  * reset_sub_block_wait_statistics(). */
+
+ std::tuple< unsigned long , unsigned long , double , double >
+ get_sub_block_wait_statistics() const {
+  return( std::make_tuple( sub_block_pool.get_number_acquisitions() ,
+                           sub_block_pool.get_number_waits() ,
+                           sub_block_pool.get_total_wait_time() ,
+                           sub_block_pool.get_max_wait_time() ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+ /// resets the statistics about the waits for a sub-Block
+
+ void reset_sub_block_wait_statistics() {
+  sub_block_pool.reset_statistics();
+ }
+
 /** @} ---------------------------------------------------------------------*/
 /*-------------------- Methods for handling Modification -------------------*/
 /*--------------------------------------------------------------------------*/
@@ -1556,9 +2060,15 @@ class InvestmentFunction : public C05Function , public Block {
  bool f_output_solution = false;
  ///< indicates whether the solution of each UCBlock must be output
 
+ bool f_distribute_scenarios = false;
+ ///< indicates whether the scenarios are distributed among MPI processes
+
  FunctionValue AAccMlt;
  ///< maximum absolute error in the multipliers of a linear combination
 
+ double f_investment_update_tolerance = 0;
+ ///< tolerance for propagating a change of investment to the sub-Blocks
+
  bool f_ignore_modifications = false; ///< ignore any Modification
 
  bool f_reformulated_bounds = false;
@@ -1609,6 +2119,94 @@ class InvestmentFunction : public C05Function , public Block {
  std::vector< double > v_linearization;
  ///< linearization associated with the most recent call to compute()
 
+ std::vector< std::vector< double > > v_sub_block_linearization;
+ ///< the linearization accumulated by each sub-Block during compute()
+
+ std::vector< double > v_scenario_value;
+ ///< the value of each scenario in the most recent call to compute()
+ /**< The value of a scenario that was not sampled is NaN. */
+
+ Index f_scenario_sample_size = 0;
+ ///< the value of the #intScenarioSampleSize parameter
+
+ int f_scenario_sample_seed = 0;
+ ///< the value of the #intScenarioSampleSeed parameter
+
+ double f_scenario_sample_growth = 2;
+ ///< the value of the #dblScenarioSampleGrowth parameter
+
+ double f_scenario_sample_rel_error = 0;
+ ///< the value of the #dblScenarioSampleRelError parameter
+
+ Index f_current_sample_size = 0;
+ ///< the number of scenarios to be sampled in the next call to compute()
+
+ Index f_number_sampled_scenarios = 0;
+ ///< the number of scenarios evaluated in the most recent call to compute()
+
+ bool f_linearization_is_sampled = false;
+ ///< whether the current linearization was computed from a sample
+
+ double f_standard_error = 0;
+ ///< the standard error of the most recently computed function value
+
+ std::mt19937 scenario_sample_engine;
+ ///< the random number generator used for sampling the scenarios
+
+ bool f_warm_start = false;
+ ///< indicates whether the inner Solvers must be warm started
+
+ bool f_keep_solutions = false;
+ ///< indicates whether the solutions must be kept instead of being output
+
+ int f_scenario_schedule = eStaticSchedule;
+ ///< how the scenarios are distributed among the threads
+
+ std::vector< double > v_scenario_time;
+ ///< the time (in seconds) taken by the most recent evaluation of each scenario
+ /**< v_scenario_time[ s ] is the number of seconds taken by solving
+  * scenario s the last time it was evaluated, or a negative value if it has
+  * never been evaluated (see #intScenarioSchedule). */
+
+ std::shared_ptr< SolutionSet > f_kept_solutions;
+ ///< the solutions kept in the most recent call to compute()
+
+ std::vector< std::vector< std::unique_ptr< State > > > v_scenario_state;
+ ///< the States of the Solvers of the UCBlocks for each scenario
+ /**< If #intWarmStart is nonzero, v_scenario_state[ s ][ t ] is the State
+  * of the Solver attached to the UCBlock of stage t obtained the last time
+  * scenario s was evaluated (or nullptr if it is not available). */
+
+ std::vector< std::vector< double > > v_applied_investment;
+ ///< the investment (per asset) that was last applied to each sub-Block
+ /**< For each sub-Block i, v_applied_investment[ i ][ j ] is the value of
+  * the investment in the j-th asset that was last applied to that
+  * sub-Block. An empty vector means that this is not known, in which case
+  * all assets of that sub-Block must be updated. */
+
+ std::unique_ptr< NetCDFSolutionOutput > f_netcdf_output;
+ ///< the netCDF file into which the solutions are output by compute()
+
+ std::unique_ptr< SolutionWriter > f_solution_writer;
+ ///< the writer of the solutions, kept from one call to compute() to the next
+
+ Index f_solution_writer_capacity = 0;
+ ///< the capacity of #f_solution_writer (the number of sub-Blocks)
+
+ std::shared_ptr< const CutSet > f_shared_cuts;
+ ///< the cuts that the sub-Blocks receive when they are first used
+
+ std::vector< unsigned char > v_has_shared_cuts;
+ ///< whether each sub-Block has received #f_shared_cuts
+ /**< This is not a std::vector< bool >, since the entry of a sub-Block is
+  * written by the thread that holds it, concurrently with the others. */
+
+ std::vector< std::unique_ptr< SDDPBlockSolutionOutput > > v_solution_output;
+ ///< the SDDPBlockSolutionOutput taking the snapshots of each sub-Block
+ /**< They are kept from one call to compute() to the next, so that the
+  * buffers and the names of the columns they cache are reused; they are
+  * forgotten when the sub-Blocks are changed. */
+
  std::vector< double > v_cost;
  ///< the cost of investing in one unit of each asset
 
@@ -1618,15 +2216,6 @@ class InvestmentFunction : public C05Function , public Block {
  std::vector< double > v_installed_quantity;
  ///< amount of each asset currently installed in the system
 
- std::vector< std::vector< std::vector< Index > > > generator_node_map;
- ///< maps the index of a generator to the node it belongs to
- /**< This vector maps a generator to the node it belongs to. The generator is
-  * identified by a triplet (stage, unit_block_index, generator_index), where
-  * stage indicates the stage (between 0 and SDDPBlock::get_time_horizon() -
-  * 1), unit_block_index identifies the UnitBlock to which the generator
-  * belongs (and index between 0 and v_block_indices.size() - 1) and
-  * generator_index is the index of the generator within its UnitBlock. */
-
  std::vector< double > v_lower_bound;
  ///< lower bound on the value of the active variables
 
@@ -1645,6 +2234,9 @@ class InvestmentFunction : public C05Function , public Block {
  std::string f_output_filename;
  ///< name of the file into which the variable and function values are output
 
+ std::string f_solution_filename;
+ ///< name of the netCDF file into which the solutions are output
+
  std::vector< std::vector< EventHandler > > v_events;
  ///< container of event handlers
  /**< v_events[ h ][ i ] contains the event handler of ID i for the event type
@@ -1661,6 +2253,16 @@ class InvestmentFunction : public C05Function , public Block {
 /*--------------------------------------------------------------------------*/
 
  /// A convenience class for representing the global pool of linearizations
+ /** The coefficients of the linearizations are stored, row by row, into a
+  * single contiguous slab whose rows all have the same length (the number
+  * of coefficients of a linearization), while the constants and the types
+  * are indexed over the names. A linearization that is deleted gives its
+  * row back to a list of free rows, which are reused by the following
+  * linearizations before the slab is enlarged; hence, storing and deleting
+  * linearizations does not allocate memory once the slab is large enough,
+  * and combining, extracting, copying or serializing the linearizations
+  * works on contiguous memory. */
+
  class GlobalPool {
 
  public:
@@ -1707,6 +2309,13 @@ class InvestmentFunction : public C05Function , public Block {
    *   diagonal. This variable is optional only if InvestmentFunction_MaxGlob
    *   == 0.
    *
+   * - The variable "InvestmentFunction_Inexact", of type netCDF::NcByte and
+   *   indexed over the dimension InvestmentFunction_MaxGlob, whose i-th
+   *   element is nonzero if the i-th linearization is inexact (see
+   *   is_linearization_inexact()). This variable is optional: if it is not
+   *   present, then all linearizations are exact (it is only written if
+   *   some of them is inexact).
+   *
    * - The variable "InvestmentFunction_Constants", of type netCDF::NcDouble
    *   and indexed over the dimension InvestmentFunction_MaxGlob, which
    *   contains the constants of the linearizations. This variable is optional
@@ -1800,11 +2409,14 @@ class InvestmentFunction : public C05Function , public Block {
    *
    * @param name the name under which the linearization will be stored.
    *
-   * @param diagonal indicates whether the linearization is a diagonal one. */
+   * @param diagonal indicates whether the linearization is a diagonal one.
+   *
+   * @param inexact indicates whether the linearization is inexact (see
+   *        is_linearization_inexact()). */
 
   void store( FunctionValue constant ,
-              std::vector< FunctionValue > coefficients ,
-              Index name , bool diagonal );
+              const std::vector< FunctionValue > & coefficients ,
+              Index name , bool diagonal , bool inexact = false );
 
 /*--------------------------------------------------------------------------*/
   /// tells if there is a linearization in this GlobalPool with the given name
@@ -1820,6 +2432,15 @@ class InvestmentFunction : public C05Function , public Block {
 
   bool is_linearization_vertical( Index name ) const;
 
+/*--------------------------------------------------------------------------*/
+  /// tells if the linearization in this GlobalPool with that name is inexact
+  /** This method returns true if \p name is the index (name) of an inexact
+   * linearization currently in this GlobalPool, i.e., one that has been
+   * computed from a sample of the scenarios (or a combination involving
+   * one), which is only an estimate of a linearization of the function. */
+
+  bool is_linearization_inexact( Index name ) const;
+
 /*--------------------------------------------------------------------------*/
   /// returns the linearization constant stored under the given name
   /** This function returns the value of the linearization constant that is
@@ -1950,20 +2571,338 @@ class InvestmentFunction : public C05Function , public Block {
 
  private:
 
+/*--------------------------------------------------------------------------*/
+  /// returns the row of the slab holding the given linearization
+  /** Returns a pointer to the first coefficient of the linearization with
+   * the given \p name, which must have a row. */
+
+  const FunctionValue * get_row( Index name ) const {
+   assert( name < size() );
+   assert( rows[ name ] != Inf< Index >() );
+   return( coefficients.data() + rows[ name ] * num_var );
+  }
+
+/*--------------------------------------------------------------------------*/
+  /// stores the given linearization into the row of the given name
+  /** Stores the given \p n coefficients into the row of the given \p name,
+   * which is taken out of the free rows (or appended to the slab) if the
+   * name has no row yet. If \p n differs from the current length of the
+   * rows, the slab is first rearranged to have rows of length \p n. */
+
+  void store_row( FunctionValue constant , const FunctionValue * g ,
+                  Index n , Index name , bool diagonal , bool inexact );
+
+/*--------------------------------------------------------------------------*/
+  /// gives the row of the given name (if any) back to the free rows
+
+  void free_row( Index name ) {
+   if( rows[ name ] == Inf< Index >() )
+    return;
+   free_rows.push_back( rows[ name ] );
+   rows[ name ] = Inf< Index >();
+  }
+
+/*--------------------------------------------------------------------------*/
+
   std::vector< FunctionValue > linearization_constants;
-  ///< linearization constants
+  ///< linearization constants, indexed over the names
+
+  std::vector< signed char > is_diagonal;
+  ///< indicates whether a linearization is diagonal, indexed over the names
+
+  std::vector< signed char > is_inexact;
+  ///< indicates whether a linearization is inexact, indexed over the names
+
+  std::vector< Index > rows;
+  ///< the row of the slab of each name (Inf< Index >() if it has none)
+
+  std::vector< FunctionValue > coefficients;
+  ///< the slab of the coefficients: num_rows rows of num_var coefficients
 
-  std::vector< std::vector< FunctionValue > > linearization_coefficients;
-  ///< linearization coefficients
+  Index num_var = 0;
+  ///< the number of coefficients of each linearization (length of a row)
+
+  Index num_rows = 0;
+  ///< the number of rows in the slab, either in use or free
+
+  std::vector< Index > free_rows;
+  ///< the rows of the slab that are not in use
+
+  std::vector< FunctionValue > combination;
+  ///< scratch for store_combination_of_linearizations()
 
   LinearCombination important_linearization_lin_comb;
   ///< the linear combination of the important linearization
 
-  std::vector< bool > is_diagonal;
-  ///< indicates whether a linearization is diagonal
-
  }; // end( class( GlobalPool ) )
 
+/*--------------------------------------------------------------------------*/
+
+ /// A convenience class for representing the pool of sub-Blocks
+ /** The SubBlockPool hands out the indices of the sub-Blocks (the SDDPBlock
+  * replicas) of the InvestmentFunction to the threads that evaluate the
+  * scenarios. The indices of the sub-Blocks that are currently available are
+  * kept in a free list, which is protected by a mutex that is not shared with
+  * anything else. A thread that requests a sub-Block when none is available
+  * is suspended on a condition variable until another thread releases one;
+  * no polling is performed. The SubBlockPool also keeps some statistics
+  * about the time the threads have been waiting for a sub-Block. */
+
+ class SubBlockPool {
+
+ public:
+
+  SubBlockPool() = default;
+
+/*--------------------------------------------------------------------------*/
+
+  virtual ~SubBlockPool() {}
+
+/*--------------------------------------------------------------------------*/
+  /// resizes the pool so that it manages the given number of sub-Blocks
+  /** Resize the pool so that it manages \p size sub-Blocks, whose indices
+   * are 0, ..., \p size - 1. If the pool already has the given \p size,
+   * nothing is done. Otherwise, all sub-Blocks are marked as available. This
+   * function must not be called while some sub-Block is acquired.
+   *
+   * @param size The number of sub-Blocks. */
+
+  void resize( Index size );
+
+/*--------------------------------------------------------------------------*/
+  /// returns the number of sub-Blocks managed by this pool
+
+  Index size() const { return( in_use.size() ); }
+
+/*--------------------------------------------------------------------------*/
+  /// acquires an available sub-Block and returns its index
+  /** This function removes the index of an available sub-Block from the free
+   * list and returns it. If no sub-Block is available, the calling thread is
+   * suspended until some sub-Block is released. If the pool is empty, an
+   * exception is thrown. */
+
+  Index acquire();
+
+/*--------------------------------------------------------------------------*/
+  /// releases the i-th sub-Block
+  /** This function makes the i-th sub-Block available again and wakes up a
+   * thread that may be waiting for a sub-Block. Releasing a sub-Block that
+   * is already available has no effect. */
+
+  void release( Index i );
+
+/*--------------------------------------------------------------------------*/
+  /// returns the number of times a sub-Block has been acquired
+
+  unsigned long get_number_acquisitions() const;
+
+/*--------------------------------------------------------------------------*/
+  /// returns the number of times a thread had to wait for a sub-Block
+
+  unsigned long get_number_waits() const;
+
+/*--------------------------------------------------------------------------*/
+  /// returns the total time (in seconds) spent waiting for a sub-Block
+
+  double get_total_wait_time() const;
+
+/*--------------------------------------------------------------------------*/
+  /// returns the longest time (in seconds) spent waiting for a sub-Block
+
+  double get_max_wait_time() const;
+
+/*--------------------------------------------------------------------------*/
+  /// resets the wait-time statistics of this pool
+
+  void reset_statistics();
+
+/*--------------------------------------------------------------------------*/
+
+ private:
+
+  mutable std::mutex mutex;
+  ///< the mutex protecting the free list and the statistics
+
+  std::condition_variable available;
+  ///< signalled whenever a sub-Block is released
+
+  std::vector< Index > free_list;
+  ///< the indices of the sub-Blocks that are currently available
+
+  std::vector< bool > in_use;
+  ///< indicates whether each sub-Block is currently acquired
+
+  unsigned long number_acquisitions = 0;
+  ///< number of times a sub-Block has been acquired
+
+  unsigned long number_waits = 0;
+  ///< number of times a thread had to wait for a sub-Block
+
+  double total_wait_time = 0;
+  ///< total time (in seconds) spent waiting for a sub-Block
+
+  double max_wait_time = 0;
+  ///< longest time (in seconds) spent waiting for a sub-Block
+
+ }; // end( class( SubBlockPool ) )
+
+/*--------------------------------------------------------------------------*/
+
+ /// A convenience class for representing the cache of evaluations
+ /** The EvaluationCache stores, for a limited number of (quantized) points,
+  * the results of the evaluation of the InvestmentFunction at those points:
+  * the function value, the linearization (if any), and the value of each
+  * scenario. When the number of stored evaluations exceeds the capacity of
+  * the cache, the least recently used one is discarded. */
+
+ class EvaluationCache {
+
+ public:
+
+  /// the results of an evaluation
+  struct Entry {
+   double value;                        ///< the function value
+   bool has_linearization;              ///< whether linearization is valid
+   std::vector< double > linearization; ///< the linearization
+   std::vector< double > scenario_value; ///< the value of each scenario
+  };
+
+/*--------------------------------------------------------------------------*/
+
+  EvaluationCache() = default;
+
+/*--------------------------------------------------------------------------*/
+
+  virtual ~EvaluationCache() {}
+
+/*--------------------------------------------------------------------------*/
+  /// sets the maximum number of evaluations in the cache
+  /** Sets the maximum number of evaluations that can be stored in the cache.
+   * If the cache currently contains more evaluations than the given \p
+   * capacity, the least recently used ones are discarded. */
+
+  void set_capacity( Index capacity );
+
+/*--------------------------------------------------------------------------*/
+  /// returns the maximum number of evaluations in the cache
+
+  Index get_capacity() const { return( capacity ); }
+
+/*--------------------------------------------------------------------------*/
+  /// sets the quantization step (see #dblEvaluationCacheStep)
+
+  void set_step( double step ) {
+   if( step != this->step ) {
+    this->step = step;
+    clear();  // the keys of the stored evaluations are no longer valid
+   }
+  }
+
+/*--------------------------------------------------------------------------*/
+  /// returns the quantization step
+
+  double get_step() const { return( step ); }
+
+/*--------------------------------------------------------------------------*/
+  /// returns the key under which the evaluation at point \p x is stored
+
+  std::vector< double > get_key( std::vector< double > x ) const;
+
+/*--------------------------------------------------------------------------*/
+  /// returns a pointer to the evaluation stored under the given key
+  /** If an evaluation is stored under the given \p key, it becomes the most
+   * recently used one and a pointer to it is returned. Otherwise, nullptr
+   * is returned. */
+
+  const Entry * find( const std::vector< double > & key );
+
+/*--------------------------------------------------------------------------*/
+  /// stores the given evaluation under the given key
+
+  void insert( std::vector< double > key , Entry entry );
+
+/*--------------------------------------------------------------------------*/
+  /// removes all evaluations from the cache
+
+  void clear() {
+   entries.clear();
+   index.clear();
+  }
+
+/*--------------------------------------------------------------------------*/
+
+ private:
+
+  using EntryList = std::list< std::pair< std::vector< double > , Entry > >;
+
+  Index capacity = 0;
+  ///< maximum number of evaluations in the cache
+
+  double step = 0;
+  ///< the quantization step
+
+  EntryList entries;
+  ///< the evaluations, ordered from the most to the least recently used
+
+  std::map< std::vector< double > , EntryList::iterator > index;
+  ///< map from the key of an evaluation to its position in entries
+
+ }; // end( class( EvaluationCache ) )
+
+/*--------------------------------------------------------------------------*/
+
+ /// the structure of the UCBlock of a stage seen by update_linearization()
+ /** A StageMap holds, for the UCBlock of a given stage, the part of its
+  * structure that update_linearization() needs and that does not change
+  * between two nuclear modifications: the kind of each UnitBlock subject to
+  * investment, the node of each of their generators, and the zones to which
+  * each of these generators belongs. All UCBlocks of the same stage (in the
+  * different sub-Blocks) are assumed to have the same structure.
+  *
+  * The StageMap is stored in compressed form: the data of the i-th UnitBlock
+  * asset (in the order of #v_unit_assets) is found between positions
+  * start[ i ] and start[ i + 1 ] of the corresponding vector. Hence, the
+  * contribution of a scenario to the linearization is computed by a single
+  * pass over these vectors, instead of checking for each time instant, zone,
+  * node and generator whether the generator belongs to the zone. */
+
+ struct StageMap {
+
+  /// the kind of a UnitBlock subject to investment
+  enum UnitKind : unsigned char {
+   eThermal ,      ///< a ThermalUnitBlock
+   eBattery ,      ///< a BatteryUnitBlock
+   eIntermittent , ///< an IntermittentUnitBlock
+   eUnknown        ///< any other UnitBlock
+  };
+
+  /// the generators of the UnitBlock assets in the zones of one type
+  struct ZoneMap {
+
+   std::vector< Index > start;
+   ///< the first entry of each UnitBlock asset (plus the total number)
+
+   std::vector< std::pair< Index , Index > > entries;
+   ///< the pairs (zone, generator), ordered by zone, node and generator
+  };
+
+  std::vector< UnitKind > unit_kind;
+  ///< the kind of each UnitBlock asset
+
+  std::vector< Index > generator_start;
+  ///< the first generator of each UnitBlock asset in generator_node
+
+  std::vector< Index > generator_node;
+  ///< the node to which each generator of the UnitBlock assets belongs
+
+  ZoneMap primary_zones;    ///< the generators in each primary zone
+
+  ZoneMap secondary_zones;  ///< the generators in each secondary zone
+
+  ZoneMap inertia_zones;    ///< the generators in each inertia zone
+
+ }; // end( struct( StageMap ) )
+
 /*--------------------------------------------------------------------------*/
 /*-------------------------- PRIVATE METHODS -------------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -2017,7 +2956,10 @@ class InvestmentFunction : public C05Function , public Block {
 
  /// update the sub-Block of the UCBlock
  /** This function updates the sub-Block of the UCBlock to reflect the current
-  * values of the x variables. */
+  * values of the x variables. If the sub-Blocks are known to be up to date
+  * with respect to the investment that was last applied to them, only the
+  * assets whose investment has changed by more than #dblInvestmentUpdateTol
+  * are updated. Otherwise, all assets of every sub-Block are updated. */
 
  void update_blocks();
 
@@ -2139,28 +3081,34 @@ class InvestmentFunction : public C05Function , public Block {
 /*--------------------------------------------------------------------------*/
 
  /// updates the linearization to reflect the most recent scenario considered
- /** This function updates the linearization to reflect the most recent
-  * scenario considered, whose subproblem was solved by the Solver attached to
-  * the sub-Block whose index is \p sub_block_index.
+ /** This function adds to the given \p linearization the contribution of the
+  * most recent scenario considered, whose subproblem was solved by the Solver
+  * attached to the sub-Block whose index is \p sub_block_index. Only data
+  * belonging to that sub-Block is accessed, so that this function can be
+  * called concurrently for different sub-Blocks (and different buffers).
   *
   * @param sub_block_index The index of the sub-Block which will be used to
-  *        update the linearization. */
+  *        update the linearization.
+  *
+  * @param linearization The vector (whose size is the number of active
+  *        Variable) to which the contribution of the scenario is added. */
 
- void update_linearization( Index sub_block_index );
+ void update_linearization( Index sub_block_index ,
+                            std::vector< double > & linearization );
 
 /*--------------------------------------------------------------------------*/
 
  /// updates the linearization with respect to the set of UnitBlock
  void update_linearization_unit_blocks
  ( Index stage , Index sub_block_index ,
-   const std::vector< std::pair< Index , Index > > & block_indices );
+   std::vector< double > & linearization );
 
 /*--------------------------------------------------------------------------*/
 
  /// updates the linearization with respect to the set of NetworkBlock
  void update_linearization_network_blocks
  ( Index stage , Index sub_block_index ,
-   const std::vector< std::pair< Index , Index > > & line_indices );
+   std::vector< double > & linearization );
 
 /*--------------------------------------------------------------------------*/
 
@@ -2169,8 +3117,17 @@ class InvestmentFunction : public C05Function , public Block {
 
 /*--------------------------------------------------------------------------*/
 
- /// builds the mapping between generator and the node it belongs to
- void build_generator_node_map();
+ /// builds the StageMaps and the lists of assets of each type
+ /** This function builds #v_unit_assets, #v_line_assets, #v_block_indices_map
+  * and the StageMap of each stage (see #v_stage_map). It is called by
+  * compute() whenever #v_stage_map is empty. These data depend on the types
+  * of the assets and on the structure of the sub-Blocks, so #v_stage_map is
+  * cleared whenever any of them may change: when the active Variable or the
+  * assets are set, deserialized or removed, when the sub-Blocks are set
+  * (set_inner_block() and set_inner_blocks()), and by any nuclear
+  * modification (e.g., a Modification coming from a sub-Block). */
+
+ void build_stage_maps();
 
 /*--------------------------------------------------------------------------*/
 
@@ -2264,9 +3221,23 @@ class InvestmentFunction : public C05Function , public Block {
  /// returns the number of stages
  Index get_number_stages() const;
 
+/*--------------------------------------------------------------------------*/
+
+ /// forgets the cuts shared by the sub-Blocks (see share_cuts())
+ void cancel_shared_cuts();
+
+/*--------------------------------------------------------------------------*/
+
+ /// forgets the SDDPBlockSolutionOutput of the sub-Blocks
+ void clear_solution_outputs();
+
 /*--------------------------------------------------------------------------*/
 
  /// locks a(n unlocked) sub-Block and returns its index
+ /** This function locks a sub-Block that is not currently locked and returns
+  * its index. If all sub-Blocks are locked, the calling thread blocks until
+  * one of them is unlocked (see SubBlockPool). */
+
  Index lock_sub_block();
 
 /*--------------------------------------------------------------------------*/
@@ -2278,6 +3249,86 @@ class InvestmentFunction : public C05Function , public Block {
 
  void handle_events( int type ) const;
 
+/*--------------------------------------------------------------------------*/
+
+ /// broadcasts the values of the active Variable from the process of rank 0
+ /** If #intDistributeScenarios is nonzero and the code is compiled with
+  * USE_MPI, this function sets the values of the active Variable of this
+  * InvestmentFunction in every process to those in the process of rank 0.
+  * Otherwise, it does nothing. */
+
+ void broadcast_variable_values();
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the indices of the scenarios to be evaluated by compute()
+ /** This function returns the (sorted) indices of the scenarios that must
+  * be evaluated in the current call to compute(): either all scenarios or a
+  * random sample of them (see #intScenarioSampleSize). */
+
+ std::vector< Index > sample_scenarios();
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the order in which the sampled scenarios must be evaluated
+ /** This function returns the positions, in the given vector of \p
+  * scenarios (see sample_scenarios()), of the scenarios that must be
+  * evaluated by the process of rank \p rank out of \p num_ranks, in the
+  * order in which they must be handed out to the threads (see
+  * #intScenarioSchedule). */
+
+ std::vector< Index > schedule_scenarios
+ ( const std::vector< Index > & scenarios , int rank , int num_ranks ) const;
+
+/*--------------------------------------------------------------------------*/
+
+ /// updates the sample size for the next call to compute()
+ /** Given the mean \p value and the standard error \p standard_error
+  * of the sampled scenario values, this function computes the number of
+  * scenarios that must be sampled in the next call to compute(), according
+  * to #dblScenarioSampleGrowth and #dblScenarioSampleRelError. */
+
+ void update_sample_size( double value , double standard_error );
+
+/*--------------------------------------------------------------------------*/
+
+ /// gives the kept States of the given scenario to the Solvers of a sub-Block
+ /** If #intWarmStart is nonzero, this function puts the States that have
+  * been kept for the given \p scenario (if any) into the Solvers attached to
+  * the UCBlocks of the given sub-Block.
+  *
+  * @param scenario The index of a scenario.
+  *
+  * @param sub_block_index The index of the sub-Block on which the \p
+  *        scenario is about to be evaluated. */
+
+ void restore_scenario_states( Index scenario , Index sub_block_index );
+
+/*--------------------------------------------------------------------------*/
+
+ /// keeps the States of the Solvers of a sub-Block for the given scenario
+ /** If #intWarmStart is nonzero, this function retrieves the States of the
+  * Solvers attached to the UCBlocks of the given sub-Block, on which the
+  * given \p scenario has just been evaluated, and keeps them for the next
+  * evaluation of that \p scenario.
+  *
+  * @param scenario The index of a scenario.
+  *
+  * @param sub_block_index The index of the sub-Block on which the \p
+  *        scenario has been evaluated. */
+
+ void save_scenario_states( Index scenario , Index sub_block_index );
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the rank of this process and the number of processes
+ /** If #intDistributeScenarios is nonzero and the code is compiled with
+  * USE_MPI, this function returns the rank of this process in the world
+  * communicator and the size of this communicator. Otherwise, it returns
+  * the pair (0, 1). */
+
+ std::pair< int , int > get_process_rank_and_size() const;
+
 /*--------------------------------------------------------------------------*/
 
  SMSpp_insert_in_factory_h; // insert InvestmentFunction in the Block factory
@@ -2286,15 +3337,27 @@ class InvestmentFunction : public C05Function , public Block {
 /*---------------------------- PRIVATE FIELDS  -----------------------------*/
 /*--------------------------------------------------------------------------*/
 
- /// It indicates whether each sub-Block is locked
- std::vector< bool > is_locked;
+ /// Pool of the sub-Blocks that are available for evaluating the scenarios
+ SubBlockPool sub_block_pool;
 
- /// This is the waiting time before trying to acquire the lock again
- double waiting_time = 1e-4;
+ /// Cache of the most recent evaluations
+ EvaluationCache evaluation_cache;
 
  /// Global pool of linearizations
  GlobalPool global_pool;
 
+ /// the StageMap of each stage (empty if they must be built)
+ /** This, #v_unit_assets and #v_line_assets are a cache of the structure
+  * of the assets and of the sub-Blocks (see build_stage_maps()), which is
+  * invalidated by clearing #v_stage_map. */
+ std::vector< StageMap > v_stage_map;
+
+ /// the indices of the UnitBlock assets and the indices of their Variables
+ std::vector< std::pair< Index , Index > > v_unit_assets;
+
+ /// the indices of the line assets and the indices of their Variables
+ std::vector< std::pair< Index , Index > > v_line_assets;
+
  /// Name of the netCDF sub-group containing the description of the inner Block
  inline static const std::string BLOCK_NAME = "SDDPBlock";
 
@@ -0,0 +1,285 @@
+/*--------------------------------------------------------------------------*/
+/*------------------------ File StateCheckpointer.h ------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of StateCheckpointer, a class that writes the States of a
+ * Solver into a netCDF file in a background thread.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __StateCheckpointer
+#define __StateCheckpointer
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include "State.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <netcdf>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ CLASS StateCheckpointer -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// writes the States of a Solver into a netCDF file in a background thread
+/** The StateCheckpointer class decouples taking the State of a Solver from
+ * writing it. The State is taken (see Solver::get_State()) by the thread
+ * running the Solver, typically in an event handler, and handed over with
+ * push(); a single background thread then serializes it into a temporary
+ * file, which is renamed to the given name once it is complete. Hence, the
+ * file with the given name, if any, always contains a complete State, even
+ * if the program is interrupted while writing.
+ *
+ * At most one State is waiting to be written: a State that is pushed while
+ * another one is waiting replaces (and destroys) the latter. Since taking a
+ * State costs a copy, is_due() tells whether a new State should be taken at
+ * all, i.e., whether the given interval has elapsed since the last State
+ * was pushed and the previous State has been written.
+ *
+ * If writing a State throws an exception, the following States are
+ * discarded and the exception is rethrown by close(). */
+
+class StateCheckpointer {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// starts the thread that writes the States into the file with that name
+ /** Starts the background thread, which writes each pushed State into the
+  * file with the given name. A new State is due (see is_due()) when at
+  * least \p interval seconds have elapsed since the last State was pushed
+  * (if \p interval <= 0, it is always due, unless the previous State is
+  * still being written). */
+
+ StateCheckpointer( std::string filename , double interval = 0 )
+  : filename( std::move( filename ) ) , interval( interval ) ,
+    last_push( std::chrono::steady_clock::now() ) {
+  thread = std::thread( [ this ]() { run(); } );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ StateCheckpointer( const StateCheckpointer & ) = delete;
+
+ StateCheckpointer & operator=( const StateCheckpointer & ) = delete;
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the State that is waiting (if any) and stops the thread
+ ~StateCheckpointer() {
+  try {
+   close();
+  }
+  catch( ... ) {}
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether a new State should be taken and pushed
+ /** Returns true if the interval has elapsed since the last State was
+  * pushed (or since the construction) and no State is waiting or being
+  * written. */
+
+ bool is_due() const {
+  std::lock_guard< std::mutex > lock( mutex );
+  if( pending || writing || error || closing )
+   return( false );
+  if( interval <= 0 )
+   return( true );
+  const std::chrono::duration< double > elapsed =
+   std::chrono::steady_clock::now() - last_push;
+  return( elapsed.count() >= interval );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// hands the given State over to the background thread
+ /** The given State replaces the one waiting to be written, if any. If
+  * writing has failed or close() has been called, the State is simply
+  * destroyed (and so is a null State). */
+
+ void push( std::unique_ptr< State > state ) {
+  if( ! state )
+   return;
+  {
+   std::lock_guard< std::mutex > lock( mutex );
+   if( error || closing )
+    return;
+   pending = std::move( state );
+   last_push = std::chrono::steady_clock::now();
+  }
+  not_empty.notify_one();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the State that is waiting (if any) and stops the thread
+ /** Nothing can be pushed afterwards. If writing a State has thrown an
+  * exception, it is rethrown (once). */
+
+ void close() {
+  {
+   std::lock_guard< std::mutex > lock( mutex );
+   closing = true;
+  }
+  not_empty.notify_one();
+
+  if( thread.joinable() )
+   thread.join();
+
+  if( error ) {
+   auto e = error;
+   error = nullptr;
+   std::rethrow_exception( e );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of States that have been written
+ unsigned long get_number_written() const {
+  std::lock_guard< std::mutex > lock( mutex );
+  return( number_written );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// writes the given State into a temporary file and renames it
+ void write( const State & state ) const {
+  const std::string temporary = filename + ".tmp";
+  {
+   netCDF::NcFile file( temporary , netCDF::NcFile::replace );
+   state.serialize( file );
+  }
+  std::filesystem::rename( temporary , filename );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// the loop of the background thread
+ void run() {
+  std::unique_lock< std::mutex > lock( mutex );
+  while( true ) {
+   not_empty.wait( lock , [ this ]() { return( pending || closing ); } );
+
+   if( ! pending )
+    return;  // closing and nothing left to write
+
+   auto state = std::move( pending );
+   writing = true;
+   lock.unlock();
+
+   std::exception_ptr exception;
+   try {
+    write( *state );
+   }
+   catch( ... ) {
+    exception = std::current_exception();
+   }
+   state.reset();
+
+   lock.lock();
+   writing = false;
+
+   if( exception ) {
+    error = exception;
+    pending.reset();
+    return;
+   }
+
+   ++number_written;
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ std::string filename;
+ ///< the name of the file into which the States are written
+
+ double interval;
+ ///< the minimum number of seconds between two States
+
+ mutable std::mutex mutex;
+ ///< the mutex protecting everything below
+
+ std::condition_variable not_empty;
+ ///< signalled when a State is pushed or the checkpointer is closed
+
+ std::unique_ptr< State > pending;
+ ///< the State waiting to be written, if any
+
+ std::chrono::steady_clock::time_point last_push;
+ ///< the time at which the last State was pushed
+
+ bool writing = false;
+ ///< whether a State is being written
+
+ bool closing = false;
+ ///< whether close() has been called
+
+ std::exception_ptr error;
+ ///< the exception thrown while writing, if any
+
+ unsigned long number_written = 0;
+ ///< number of States that have been written
+
+ std::thread thread;
+ ///< the background thread
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class StateCheckpointer )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* StateCheckpointer.h included */
+
+/*--------------------------------------------------------------------------*/
+/*---------------------- End File StateCheckpointer.h ----------------------*/
+/*--------------------------------------------------------------------------*/
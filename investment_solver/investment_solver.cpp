@@ -7,8 +7,10 @@
  * InvestmentBlock. The description of the InvestmentBlock must be given in a
  * netCDF file. This tool can be executed as follows:
  *
- *   ./investment_solver [-s] [-e] [-o] [-l FILE] [-n NUMBER] [-B FILE]
- *                       [-p PATH] [-c PATH] [-x FILE ] -S FILE <nc4-file>
+ *   ./investment_solver [-s] [-e] [-o] [-O FILE] [-l FILE] [-n NUMBER]
+ *                       [-B FILE] [-p PATH] [-c PATH] [-x FILE ] [-P FILE]
+ *                       [-a PREFIX [-i SECONDS]] [-b FILE]
+ *                       -S FILE <nc4-file>
  *
  * The only mandatory arguments are the netCDF file containing the description
  * of the InvestmentBlock and the solver configuration file indicated by the
@@ -45,7 +47,15 @@
  * If the -o option is used, then part of the primal and dual solutions of
  * every UCBlock for each scenario is output while the investment function is
  * computed. Typically, one may want the solutions to be output in simulation
- * mode (i.e., when the -s option is used).
+ * mode (i.e., when the -s option is used). When the investment problem is
+ * solved, the solutions associated with the best investment found are kept
+ * in memory and they are only output once the problem has been solved. The
+ * solutions are output into CSV files unless the -O option is used, in which
+ * case they are written into the given netCDF-4 file (see
+ * NetCDFSolutionOutput); the -O option implies the -o option. If the
+ * scenarios are distributed among several processes, every process writes
+ * its own netCDF file, whose name is obtained by appending "_<rank>" to the
+ * stem of the given name.
  *
  * The -n option specifies the number of sub-Blocks of SDDPBlock that must be
  * constructed for each stage. By default, SDDPBlock contains a single
@@ -73,14 +83,46 @@
  * ..., a_k are the coefficients of the cut, and b is the constant term of the
  * cut.
  *
+ * The file given to the -l option can also be a binary cut archive (see
+ * CutArchive), which is recognized by its content, as written by the -b
+ * option of sddp_solver.
+ *
  * As a preprocessing, given redundant cuts can be removed by using the -e
  * option. Notice that all cuts will be subject to being removed, whether they
- * are provided in a netCDF file or by the -l option.
+ * are provided in a netCDF file or by the -l option. If there are many
+ * sub-Blocks (-n option), the cuts are only loaded and eliminated in the
+ * first one, and then shared by all of them: each sub-Block receives a copy
+ * of the cuts only when it is first used. The sub-Blocks must have the same
+ * cuts (as they do when they are replicas of the same SDDPBlock), which is
+ * checked.
  *
  * There are a few ways to specify the initial state for the first stage
  * subproblem. This can be done by setting the initial state variable of
  * SDDPBlock or by setting the initial state parameter of SDDPGreedySolver.
  *
+ * The State of the Solver of the InvestmentBlock can be saved by using the
+ * -a option, which must be followed by a PREFIX: the State is written into
+ * the file PREFIX.nc4. The State is taken at the end of an iteration of the
+ * Solver and written by a background thread into a temporary file, which
+ * then replaces PREFIX.nc4, so that the Solver does not wait for the file
+ * to be written and PREFIX.nc4 always contains a complete State (see
+ * StateCheckpointer). A new State is taken at the end of the first
+ * iteration at which at least the number of seconds given to the -i option
+ * (by default, 0) have elapsed since the last one, and the previous State
+ * has been written; the final State is always written. If there are many
+ * MPI processes, only the first one saves the State. A State saved in this
+ * way can be loaded by using the -b option.
+ *
+ * The -P option enables the Profiler: the time spent in each phase of the
+ * computation of the investment function (e.g., updating the sub-Blocks,
+ * waiting for a sub-Block, solving each scenario, computing the
+ * linearization, outputting the solutions), in loading and eliminating the
+ * cuts and in solving the problem, as well as a few counters, are written
+ * into the given file at the end, per thread and per scenario, in JSON
+ * format if its extension is ".json" and in CSV format otherwise (see
+ * Profiler). If there are many MPI processes, "_<rank>" is appended to the
+ * name of the file of each process.
+ *
  * \author Rafael Durbano Lobato \n
  *         Dipartimento di Informatica \n
  *         Universita' di Pisa \n
@@ -108,10 +150,16 @@
 #include <ThermalUnitBlock.h>
 #include <UCBlock.h>
 
+#include "CutArchive.h"
+#include "CutFileReader.h"
 #include "CutProcessing.h"
+#include "CutSet.h"
 #include "InvestmentBlock.h"
 #include "InvestmentFunction.h"
+#include "Profiler.h"
 #include "SDDPBlockSolutionOutput.h"
+#include "StageLinkingPlan.h"
+#include "StateCheckpointer.h"
 
 #ifdef USE_MPI
 #include <boost/mpi/environment.hpp>
@@ -136,11 +184,19 @@ std::string solver_state_input_filename{};
 // InvestmentBlock Solver
 std::string solver_state_output_filename{};
 
+// Minimum number of seconds between two saved States of the InvestmentBlock
+// Solver
+double solver_state_interval = 0;
+std::string solution_filename{};
+std::string profile_filename{};
+
 const std::string best_solution_filename = "Solution_OUT.csv";
 
 long num_sub_blocks_per_stage = 1;
+long cut_processing_threads = 1;
 
 bool eliminate_redundant_cuts = false;
+bool distribute_scenarios = false;
 bool simulate_investment = false;
 bool single_scenario = false;
 bool output_solution = false;
@@ -182,12 +238,17 @@ void print_help() {
            << "  -B, --blockcfg <file>           Block configuration.\n"
            << "  -b, --load-state <file>         Load a state for the InvestmentBlock solver.\n"
            << "  -c, --configdir <path>          The prefix for all config filenames.\n"
+           << "  -d, --distribute-scenarios      Distribute the scenarios among MPI processes.\n"
            << "  -e, --eliminate-redundant-cuts  Eliminate given redundant cuts.\n"
            << "  -h, --help                      Print this help.\n"
+           << "  -i, --save-state-interval <s>   Seconds between two saved states.\n"
+           << "  -j, --cut-threads <number>      Threads for eliminating redundant cuts.\n"
            << "  -l, --load-cuts <file>          Load cuts from a file.\n"
            << "  -n, --num-blocks <number>       Number of sub-Blocks per stage.\n"
            << "  -o, --output-solution           Output the solutions.\n"
+           << "  -O, --netcdf-solution <file>    Output the solutions into a netCDF file.\n"
            << "  -p, --prefix <path>             The prefix for all Block filenames.\n"
+           << "  -P, --profile <file>            Write the timings into a file.\n"
            << "  -S, --solvercfg <file>          Solver configuration.\n"
            << "  -s, --simulate                  Simulate the given investment.\n"
            << "  -x, --initial-investment <file> Initial investment."
@@ -196,6 +257,15 @@ void print_help() {
 
 /*--------------------------------------------------------------------------*/
 
+// Returns the CutProcessing used to eliminate redundant cuts
+CutProcessing get_cut_processing() {
+ CutProcessing cut_processing;
+ cut_processing.set_number_threads( cut_processing_threads );
+ return( cut_processing );
+}
+
+/*--------------------------------------------------------------------------*/
+
 long get_long_option() {
  char * end = nullptr;
  errno = 0;
@@ -217,18 +287,23 @@ void process_args( int argc , char ** argv ) {
   exit( 1 );
  }
 
- const char * const short_opts = "a:B:b:c:hel:n:op:rS:sx:";
+ const char * const short_opts = "a:B:b:c:dhei:j:l:n:oO:p:P:rS:sx:";
  const option long_opts[] = {
   { "save-state" ,               required_argument , nullptr , 'a' } ,
   { "blockcfg" ,                 required_argument , nullptr , 'B' } ,
   { "load-state" ,               required_argument , nullptr , 'b' } ,
   { "configdir" ,                required_argument , nullptr , 'c' } ,
+  { "distribute-scenarios" ,     no_argument ,       nullptr , 'd' } ,
   { "help" ,                     no_argument ,       nullptr , 'h' } ,
   { "eliminate-redundant-cuts" , no_argument ,       nullptr , 'e' } ,
+  { "save-state-interval" ,      required_argument , nullptr , 'i' } ,
+  { "cut-threads" ,              required_argument , nullptr , 'j' } ,
   { "load-cuts" ,                required_argument , nullptr , 'l' } ,
   { "num-blocks" ,               required_argument , nullptr , 'n' } ,
   { "output-solution" ,          no_argument ,       nullptr , 'o' } ,
+  { "netcdf-solution" ,          required_argument , nullptr , 'O' } ,
   { "prefix" ,                   required_argument , nullptr , 'p' } ,
+  { "profile" ,                  required_argument , nullptr , 'P' } ,
   { "relax" ,                    no_argument ,       nullptr , 'r' } ,
   { "solvercfg" ,                required_argument , nullptr , 'S' } ,
   { "simulate" ,                 no_argument ,       nullptr , 's' } ,
@@ -259,9 +334,31 @@ void process_args( int argc , char ** argv ) {
     config_filename_prefix = std::string( optarg );
     Configuration::set_filename_prefix( std::string( optarg ) );
     break;
+   case 'd':
+    distribute_scenarios = true;
+    break;
    case 'e':
     eliminate_redundant_cuts = true;
     break;
+   case 'i': {
+    char * end = nullptr;
+    solver_state_interval = std::strtod( optarg , &end );
+    if( ( end && *end ) || ( ! ( solver_state_interval >= 0 ) ) ) {
+     std::cout << "The number of seconds between two saved states must be "
+               << "a nonnegative number." << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
+   case 'j': {
+    cut_processing_threads = get_long_option();
+    if( cut_processing_threads < 0 ) {
+     std::cout << "The number of threads for eliminating redundant cuts must "
+               << "be a nonnegative integer." << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
    case 'l':
     cuts_filename = std::string( optarg );
     break;
@@ -277,9 +374,17 @@ void process_args( int argc , char ** argv ) {
    case 'o':
     output_solution = true;
     break;
+   case 'O':
+    output_solution = true;
+    solution_filename = std::string( optarg );
+    break;
    case 'p':
     Block::set_filename_prefix( std::string( optarg ) );
     break;
+   case 'P':
+    profile_filename = std::string( optarg );
+    Profiler::enable();
+    break;
    case 'r':
     std::cout << "The -r option no longer exists. In order relax the "
               << "integrality constraints,\nplease properly configure the "
@@ -321,237 +426,12 @@ void process_args( int argc , char ** argv ) {
 
 /*--------------------------------------------------------------------------*/
 
-Block * get_uc_block( const SDDPBlock * sddp_block , const Index stage ) {
-
- auto benders_block = static_cast< BendersBlock * >
-  ( sddp_block->get_sub_Block( stage )->get_inner_block() );
-
- auto objective = static_cast< FRealObjective * >
-  ( benders_block->get_objective() );
-
- auto benders_function = static_cast< BendersBFunction * >
-  ( objective->get_function() );
-
- return( benders_function->get_inner_block() );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_hydro_unit( Block * previous_block , Block * block ,
-                        const Index stage ) {
- auto unit = dynamic_cast< HydroUnitBlock * >( block );
- auto previous_unit = dynamic_cast< HydroUnitBlock * >( previous_block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- auto number_generators = previous_unit->get_number_generators();
-
- if( number_generators != unit->get_number_generators() )
-  throw( std::logic_error
-         ( "sddp_solver: HydroUnitBlock at stage " +
-           std::to_string( stage - 1 ) + " has " +
-           std::to_string( number_generators ) +
-           ", but corresponding HydroUnitBlock at stage " +
-           std::to_string( stage ) + " has " +
-           std::to_string( unit->get_number_generators() ) ) );
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > flow_rate( number_generators );
-
- for( Index g = 0 ; g < number_generators ; ++g )
-  flow_rate[ g ] =
-   previous_unit->get_flow_rate( g , time_horizon - 1 )->get_value();
-
- unit->set_initial_flow_rate( flow_rate.cbegin() );
-
- return( true );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_battery_unit( Block * previous_block , Block * block ,
-                          const Index stage ) {
- auto unit = dynamic_cast< BatteryUnitBlock * >( block );
- auto previous_unit = dynamic_cast< BatteryUnitBlock * >( previous_block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > initial_power_data =
-  { ( previous_unit->get_active_power( 0 ) + time_horizon - 1 )->get_value() };
-
- unit->set_initial_power( initial_power_data.cbegin() );
-
- std::vector< double > initial_storage_data =
-  { previous_unit->get_storage_level()[ time_horizon - 1 ].get_value() };
-
- unit->set_initial_storage( initial_storage_data.cbegin() );
-
- return( true );
-}
-
-/*--------------------------------------------------------------------------*/
-
-int compute_init_up_down_time( const SDDPBlock * sddp_block ,
-                               ThermalUnitBlock * previous_unit ,
-                               ThermalUnitBlock * unit , const Index stage ) {
-
- auto time_horizon = previous_unit->get_time_horizon();
- auto commitment = previous_unit->get_commitment( 0 ) + time_horizon - 1;
-
- auto shutdown = previous_unit->get_shut_down( time_horizon - 1 );
- if( shutdown && shutdown->get_value() >= 0.5 ) {
-  return( 0 );
- }
-
- int init_up_down_time = 0;
- const bool on = commitment->get_value() >= 0.5;
- if( on )
-  init_up_down_time = 1;
- else
-  init_up_down_time = -1;
-
- AbstractPath path;
-
- for( Index outer_t = 0 ; outer_t < stage ; ++outer_t ) {
-
-  for( Index t = 1 ; t < time_horizon ; ++t , --commitment ) {
-   if( std::abs( commitment->get_value() -
-                 ( commitment - 1 )->get_value() ) > 0.5 )
-    return( init_up_down_time );
-   if( on ) ++init_up_down_time;
-   else --init_up_down_time;
-  }
-
-  if( outer_t == stage - 1 )
-   break;
-
-  if( path.empty() ) {
-   auto uc_block = get_uc_block( sddp_block , stage );
-   path.build( unit , uc_block );
-  }
-
-  auto previous_uc_block = get_uc_block( sddp_block , stage - outer_t - 2 );
-  previous_unit = dynamic_cast< ThermalUnitBlock * >
-   ( path.get_element< Block >( previous_uc_block ) );
-
-  time_horizon = previous_unit->get_time_horizon();
-
-  if( ! previous_unit )
-   throw( std::logic_error
-          ( "sddp_solver::update_thermal_block: ThermalUnitBlock not found "
-            "at stage " + std::to_string( stage - outer_t - 2 ) ) );
-
-  commitment = previous_unit->get_commitment( 0 ) + time_horizon - 1;
-
-  if( on ) {
-   if( commitment->get_value() >= 0.5 ) ++init_up_down_time;
-   else break;
-  }
-  else {
-   if( commitment->get_value() < 0.5 ) --init_up_down_time;
-   else break;
-  }
- }
-
- return( init_up_down_time );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_thermal_unit( const SDDPBlock * sddp_block ,
-                          Block * previous_block , Block * block ,
-                          const Index stage ) {
-
- auto previous_unit = dynamic_cast< ThermalUnitBlock * >( previous_block );
- auto unit = dynamic_cast< ThermalUnitBlock * >( block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- if( simulate_investment && single_scenario ) {
-  // One case where we can safely update the initial up and downtime is when
-  // we are simulating a single scenario considering the simulation-based
-  // investment function.
-  auto init_up_down_time = compute_init_up_down_time
-   ( sddp_block , previous_unit , unit , stage );
-
-  std::vector< int > init_up_down_time_data = { init_up_down_time };
-  unit->set_init_updown_time( init_up_down_time_data.cbegin() );
- }
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > active_power_data =
-  { ( previous_unit->get_active_power( 0 ) + time_horizon - 1 )->get_value() };
- unit->set_initial_power( active_power_data.cbegin() );
-
- return( true );
-}
-
-/*--------------------------------------------------------------------------*/
-
-void callback( SDDPBlock * sddp_block , Block::Index stage ) {
-
- if( stage == 0 )
-  return;
-
- auto previous_uc_block = get_uc_block( sddp_block , stage - 1 );
- auto uc_block = get_uc_block( sddp_block , stage );
-
- std::queue< Block * > blocks;
- blocks.push( uc_block );
-
- std::queue< Block * > previous_blocks;
- previous_blocks.push( previous_uc_block );
-
- while( ! blocks.empty() ) {
-  auto block = blocks.front();
-  blocks.pop();
-
-  auto previous_block = previous_blocks.front();
-  previous_blocks.pop();
-
-  auto n = block->get_number_nested_Blocks();
-
-  if( n != previous_block->get_number_nested_Blocks() ) {
-   throw( std::logic_error
-          ("sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-  }
-
-  for( decltype( n ) i = 0 ; i < n ; ++i ) {
-   blocks.push( block->get_nested_Block( i ) );
-   previous_blocks.push( previous_block->get_nested_Block( i ) );
-  }
-
-  update_hydro_unit( previous_block , block , stage )
-   || update_thermal_unit( sddp_block , previous_block , block , stage )
-   || update_battery_unit( previous_block , block , stage );
- }
+// Links the UCBlock of the given stage to that of the previous stage (see
+// StageLinkingPlan). One case where we can safely update the initial up and
+// downtime is when we are simulating a single scenario considering the
+// simulation-based investment function.
+void callback( StageLinkingPlan & plan , Block::Index stage ) {
+ plan.link( stage , simulate_investment && single_scenario );
 }
 
 /*--------------------------------------------------------------------------*/
@@ -658,6 +538,13 @@ void invest( InvestmentBlock * investment_block ) {
  investment_function->
   set_par( InvestmentFunction::intOutputSolution , output_solution );
 
+ investment_function->set_par( InvestmentFunction::strSolutionFilename ,
+                               std::string( solution_filename ) );
+
+ // Possibly distribute the scenarios among the MPI processes
+ investment_function->
+  set_par( InvestmentFunction::intDistributeScenarios , distribute_scenarios );
+
  for( Index i = 0 ; i < investment_function->get_number_nested_Blocks() ;
       ++i ) {
 
@@ -677,26 +564,52 @@ void invest( InvestmentBlock * investment_block ) {
    throw( std::logic_error( "The Solver for the SDDPBlock must be an "
                             "SDDPGreedySolver." ) );
 
-  sddp_solver->set_callback( [ sddp_block ]( Index stage ) {
-   callback( sddp_block , stage );
-  } );
+  sddp_solver->set_callback
+   ( [ plan = std::make_shared< StageLinkingPlan >( sddp_block ) ]
+     ( Index stage ) {
+    callback( *plan , stage );
+   } );
 
   // Check whether there is a single scenario
 
   single_scenario = ( sddp_block->get_scenario_set().size() == 1 );
+ }
 
-  // Load possibly given cuts
+ // The cuts are loaded (and possibly pruned) in the first sub-Block only,
+ // and then shared (read-only) by all sub-Blocks, each of which receives a
+ // copy of them only when it is first used (see
+ // InvestmentFunction::share_cuts()). This relies on the sub-Blocks being
+ // identical, since their own cuts are replaced by those of the first one:
+ // this is checked here, so that no cut is silently lost.
+
+ auto first_sddp_block =
+  static_cast< SDDPBlock * >( investment_function->get_nested_Block( 0 ) );
+
+ for( Index i = 1 ; i < investment_function->get_number_nested_Blocks() ;
+      ++i )
+  if( ! CutSet::have_same_cuts
+      ( first_sddp_block , static_cast< SDDPBlock * >
+        ( investment_function->get_nested_Block( i ) ) ) )
+   throw( std::logic_error( "The sub-Block " + std::to_string( i ) +
+                            " of the InvestmentBlock does not have the same "
+                            "cuts as the first one." ) );
+
+ // Load possibly given cuts
+
+ if( ! cuts_filename.empty() ) {
+  Profiler::ScopedTimer timer( "load_cuts" );
+  if( CutArchive::is_cut_archive( cuts_filename ) )
+   CutArchive::load( first_sddp_block , cuts_filename );
+  else
+   CutFileReader::load( first_sddp_block , cuts_filename );
+ }
 
-  if( ! cuts_filename.empty() ) {
-   sddp_solver->set_par( SDDPGreedySolver::strLoadCuts , cuts_filename );
-   sddp_solver->set_par( SDDPGreedySolver::intLoadCutsOnce , 1 );
-  }
+ // Eliminate redundant cuts if it is desired
 
-  // Eliminate redundant cuts if it is desired
+ if( eliminate_redundant_cuts )
+  get_cut_processing().remove_redundant_cuts( first_sddp_block );
 
-  if( eliminate_redundant_cuts )
-   CutProcessing().remove_redundant_cuts( sddp_block );
- }
+ investment_function->share_cuts( 0 );
 
  // Solve
 
@@ -730,7 +643,9 @@ void invest( InvestmentBlock * investment_block ) {
   // Simulate
   auto objective =
    static_cast< FRealObjective * >( investment_block->get_objective() );
+  Profiler::ScopedTimer compute_timer( "simulate" );
   objective->compute();
+  compute_timer.stop();
 
   const auto value = objective->value();
   std::cout << "Value: " << std::setprecision( 20 ) << value << std::endl;
@@ -766,19 +681,30 @@ void invest( InvestmentBlock * investment_block ) {
    }
   }
 
-  if( ! solver_state_output_filename.empty() ) {
-   // Register an event to save the State of the Solver
+  bool save_state = ! solver_state_output_filename.empty();
+#ifdef USE_MPI
+  // The State is the same in every process: only the first one saves it
+  save_state = save_state && ( boost::mpi::communicator().rank() == 0 );
+#endif
+
+  std::unique_ptr< StateCheckpointer > checkpointer;
+
+  if( save_state ) {
+   // Register an event to save the State of the Solver. The State is only
+   // copied here, and it is written by the StateCheckpointer.
+
+   checkpointer = std::make_unique< StateCheckpointer >
+    ( solver_state_output_filename + ".nc4" , solver_state_interval );
 
    investment_solver->set_par( ThinComputeInterface::intEverykIt , 1 );
    investment_solver->set_event_handler
     ( ThinComputeInterface::eEverykIteration ,
-      [ investment_solver ]() {
-       static int i = 0;
-       std::string filename =
-        solver_state_output_filename + std::to_string( i++ ) + ".nc4";
-       i %= 2;
-       netCDF::NcFile file( filename , netCDF::NcFile::replace );
-       investment_solver->serialize_State( file );
+      [ investment_solver , checkpointer = checkpointer.get() ]() {
+       if( checkpointer->is_due() ) {
+        Profiler::ScopedTimer timer( "get_State" );
+        checkpointer->push( std::unique_ptr< State >
+                            ( investment_solver->get_State() ) );
+       }
        return( ThinComputeInterface::eContinue );
       } );
   }
@@ -788,6 +714,14 @@ void invest( InvestmentBlock * investment_block ) {
 
   std::vector< double > best_solution;
 
+  // The solutions of the UCBlocks associated with the best solution are kept
+  // in memory and only output at the end
+
+  std::shared_ptr< const InvestmentFunction::SolutionSet > best_solutions;
+
+  if( output_solution )
+   investment_function->set_par( InvestmentFunction::intKeepSolutions , 1 );
+
   const auto objective_sense =
    get_objective_sense( investment_function->get_sddp_block( 0 ) );
 
@@ -799,7 +733,7 @@ void invest( InvestmentBlock * investment_block ) {
   investment_function->set_event_handler
    ( ThinComputeInterface::eBeforeTermination ,
      [ investment_block , investment_function , &best_solution_value ,
-       &best_solution , objective_sense ]() {
+       &best_solution , &best_solutions , objective_sense ]() {
 
       auto solution_improved = [ investment_function , &best_solution_value ,
                                  objective_sense ]() {
@@ -834,10 +768,9 @@ void invest( InvestmentBlock * investment_block ) {
         best_solution_file << std::setprecision( 20 ) << value << std::endl;
        }
 
-       // Possibly output information associated with the solution
+       // Possibly keep the information associated with the solution
        if( output_solution )
-        SDDPBlockSolutionOutput().copy
-         ( investment_function->get_sddp_block( 0 ) , ".best" , true );
+        best_solutions = investment_function->get_kept_solutions();
       }
 
       return( ThinComputeInterface::eContinue );
@@ -845,19 +778,36 @@ void invest( InvestmentBlock * investment_block ) {
 
   // Solve the investment problem
 
+  Profiler::ScopedTimer compute_timer( "solve" );
   investment_solver->compute();
+  compute_timer.stop();
+
+  if( checkpointer ) {
+   // The final State is always saved
+   checkpointer->push( std::unique_ptr< State >
+                       ( investment_solver->get_State() ) );
+   try {
+    Profiler::ScopedTimer timer( "save_State" );
+    checkpointer->close();
+   }
+   catch( const std::exception & e ) {
+    std::cout << "Warning: It was not possible to save the Solver State: '"
+              << e.what() << "'." << std::endl;
+   }
+  }
+
+  // Every process outputs the solutions of its own scenarios
+
+  if( best_solutions ) {
+   Profiler::ScopedTimer timer( "output_solutions" );
+   investment_function->output_solutions( *best_solutions );
+  }
 
 #ifdef USE_MPI
   boost::mpi::communicator world;
   if( world.rank() == 0 ) {
 #endif
 
-   // Rename the output files if necessary
-
-   if( output_solution )
-    SDDPBlockSolutionOutput().rename
-     ( investment_function->get_sddp_block( 0 ) , ".best" , true );
-
    // Output solution information
 
    if( best_solution_value == worst_value )
@@ -1020,11 +970,6 @@ void process_prob_file( const netCDF::NcFile & file ) {
    // Set the output stream for the log of the inner Solvers
 
    set_log( sddp_block , &std::cout );
-
-   // Eliminate redundant cuts if it is desired
-
-   if( eliminate_redundant_cuts )
-    CutProcessing().remove_redundant_cuts( sddp_block );
   }
 
   // Configure block
@@ -1721,11 +1666,6 @@ void process_block_file( const netCDF::NcFile & file ) {
    // Set the output stream for the log of the inner Solvers
 
    set_log( sddp_block , &std::cout );
-
-   // Eliminate redundant cuts if it is desired
-
-   if( eliminate_redundant_cuts )
-    CutProcessing().remove_redundant_cuts( sddp_block );
   }
 
   // Configure the SDDPBlock
@@ -1896,5 +1836,26 @@ int main( int argc , char ** argv ) {
  }
 
  file.close();
+
+ // Possibly write the timings and counters of this process
+
+ if( ! profile_filename.empty() ) {
+  int rank = 0;
+  int size = 1;
+#ifdef USE_MPI
+  boost::mpi::communicator world;
+  rank = world.rank();
+  size = world.size();
+#endif
+  try {
+   Profiler::write_report( Profiler::get_filename( profile_filename , rank ,
+                                                   size ) );
+  }
+  catch( const std::exception & e ) {
+   std::cerr << e.what() << std::endl;
+   exit( 1 );
+  }
+ }
+
  return( 0 );
 }
@@ -0,0 +1,431 @@
+/*--------------------------------------------------------------------------*/
+/*--------------------------- File CutArchive.h ----------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of CutArchive, a class for writing and reading the cuts of an
+ * SDDPBlock in a binary file.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __CutArchive
+#define __CutArchive
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <PolyhedralFunction.h>
+#include <SDDPBlock.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- CLASS CutArchive ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// a binary file containing the cuts of an SDDPBlock
+/** The CutArchive class writes and reads the cuts of the PolyhedralFunction
+ * of each stage of an SDDPBlock to and from a binary file. It is a lossless
+ * (and much more compact and faster) alternative to the CSV file written by
+ * SDDPBlockSolutionOutput::print_cuts() and read by the -l option of the
+ * tools. All values are stored in little-endian byte order, regardless of
+ * the platform, and the file has the following layout:
+ *
+ * - the 8 characters "SMSCUTS1" (see is_cut_archive());
+ *
+ * - the number T of stages (uint64_t);
+ *
+ * - an index with T entries, one per stage, each one made of the number of
+ *   cuts m, the number of coefficients n of each cut, and the offset (from
+ *   the beginning of the file) of the data of the stage (three uint64_t);
+ *
+ * - the data of each stage: m rows of n + 1 doubles, each row containing the
+ *   coefficients a_0, ..., a_{n-1} of a cut followed by its constant term b.
+ *
+ * Thanks to the index, the cuts of a single stage can be read without
+ * reading the whole file (see read_stage()). */
+
+class CutArchive {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// opens the given CutArchive and reads its index
+
+ explicit CutArchive( const std::string & filename ) : filename( filename ) {
+
+  file.open( filename , std::ios::in | std::ios::binary );
+
+  if( ! file.is_open() )
+   throw( std::runtime_error( "It was not possible to open the file \"" +
+                              filename + "\"." ) );
+
+  char header[ magic_size ];
+  if( ! file.read( header , magic_size ) ||
+      std::memcmp( header , magic , magic_size ) != 0 )
+   throw( std::logic_error( "File \"" + filename + "\" is not a cut "
+                            "archive." ) );
+
+  const auto num_stages = read_uint64();
+
+  v_stage.resize( num_stages );
+  for( auto & stage : v_stage ) {
+   stage.num_cuts = read_uint64();
+   stage.num_var = read_uint64();
+   stage.offset = read_uint64();
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of stages in the archive
+
+ Index get_num_stages() const { return( v_stage.size() ); }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of cuts of the given stage
+
+ Index get_num_cuts( Index stage ) const {
+  return( v_stage.at( stage ).num_cuts );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of coefficients of the cuts of the given stage
+
+ Index get_num_var( Index stage ) const {
+  return( v_stage.at( stage ).num_var );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// reads the cuts of the given stage
+ /** Reads the cuts of the given stage, which are appended to \p A (the
+  * coefficients) and \p b (the constant terms). Only the data of this stage
+  * is read from the file. */
+
+ void read_stage( Index stage , PolyhedralFunction::MultiVector & A ,
+                  PolyhedralFunction::RealVector & b ) {
+
+  if( stage >= v_stage.size() )
+   throw( std::logic_error( "File \"" + filename + "\" does not contain "
+                            "stage " + std::to_string( stage ) + "." ) );
+
+  const auto & info = v_stage[ stage ];
+  const std::size_t row_size = info.num_var + 1;
+
+  std::vector< double > buffer( info.num_cuts * row_size );
+
+  file.clear();
+  file.seekg( info.offset );
+  if( ! file.read( reinterpret_cast< char * >( buffer.data() ) ,
+                   buffer.size() * sizeof( double ) ) )
+   throw( std::logic_error( "File \"" + filename + "\" is truncated or "
+                            "corrupted (stage " + std::to_string( stage ) +
+                            ")." ) );
+
+  if( ! is_little_endian() )
+   for( auto & value : buffer )
+    swap_bytes( value );
+
+  A.reserve( A.size() + info.num_cuts );
+  b.reserve( b.size() + info.num_cuts );
+
+  for( std::size_t i = 0 ; i < info.num_cuts ; ++i ) {
+   const auto row = buffer.data() + i * row_size;
+   A.emplace_back( row , row + info.num_var );
+   b.push_back( row[ info.num_var ] );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// adds the cuts in the given CutArchive to the given SDDPBlock
+ /** Adds the cuts of each stage of the CutArchive with the given name to the
+  * PolyhedralFunction of that stage in every sub-Block of \p sddp_block
+  * (assuming there is only one PolyhedralFunction per stage). The stages are
+  * read one at a time, and the cuts of a stage are moved into its last
+  * sub-Block, so that at most one copy of the cuts of a single stage is
+  * held besides those stored in the PolyhedralFunction. */
+
+ static void load( SDDPBlock * sddp_block , const std::string & filename ) {
+
+  CutArchive archive( filename );
+
+  const auto time_horizon = sddp_block->get_time_horizon();
+
+  if( archive.get_num_stages() > time_horizon )
+   throw( std::logic_error( "File \"" + filename + "\" contains an invalid"
+                            " stage: " + std::to_string( time_horizon ) +
+                            "." ) );
+
+  const auto num_sub_blocks_per_stage =
+   sddp_block->get_num_sub_blocks_per_stage();
+
+  for( Index stage = 0 ; stage < archive.get_num_stages() ; ++stage ) {
+
+   if( archive.get_num_cuts( stage ) == 0 )
+    continue; // no cut for this stage
+
+   if( archive.get_num_var( stage ) !=
+       sddp_block->get_polyhedral_function( stage )->get_num_active_var() )
+    throw( std::logic_error( "File \"" + filename + "\" contains invalid "
+                             "cuts for stage " + std::to_string( stage ) +
+                             "." ) );
+
+   PolyhedralFunction::MultiVector A;
+   PolyhedralFunction::RealVector b;
+   archive.read_stage( stage , A , b );
+
+   for( Index sub_block_index = 0 ;
+        sub_block_index < num_sub_blocks_per_stage ; ++sub_block_index ) {
+
+    auto polyhedral_function =
+     sddp_block->get_polyhedral_function( stage , 0 , sub_block_index );
+
+    if( sub_block_index + 1 == num_sub_blocks_per_stage ) {
+     // The last replica takes the A matrix of this stage
+     polyhedral_function->add_rows( std::move( A ) , b );
+     continue;
+    }
+
+    // Copy the A matrix for this stage so that it can be moved
+    auto A_stage = A;
+
+    polyhedral_function->add_rows( std::move( A_stage ) , b );
+   }
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the cuts of the given SDDPBlock into a CutArchive
+ /** Writes the cuts of the PolyhedralFunction of each stage of the given
+  * SDDPBlock (see SDDPBlock::get_polyhedral_function()) into the file with
+  * the given name. */
+
+ static void write( SDDPBlock * block , const std::string & filename ) {
+  std::vector< PolyhedralFunction * > functions( block->get_time_horizon() );
+  for( Index stage = 0 ; stage < functions.size() ; ++stage )
+   functions[ stage ] = block->get_polyhedral_function( stage );
+  write( functions , filename );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the cuts of the given PolyhedralFunction into a CutArchive
+ /** Writes the cuts of the given PolyhedralFunction into the file with the
+  * given name, the i-th PolyhedralFunction being that of stage i. */
+
+ static void write( const std::vector< PolyhedralFunction * > & functions ,
+                    const std::string & filename ) {
+
+  std::ofstream output( filename , std::ios::out | std::ios::binary );
+
+  if( ! output.is_open() )
+   throw( std::runtime_error( "It was not possible to open the file \"" +
+                              filename + "\"." ) );
+
+  const std::uint64_t num_stages = functions.size();
+
+  output.write( magic , magic_size );
+  write_uint64( output , num_stages );
+
+  // The index
+
+  std::uint64_t offset = magic_size + sizeof( std::uint64_t ) *
+   ( 1 + 3 * num_stages );
+
+  for( Index stage = 0 ; stage < num_stages ; ++stage ) {
+   const auto function = functions[ stage ];
+   const std::uint64_t num_cuts = function->get_nrows();
+   const std::uint64_t num_var = function->get_num_active_var();
+   write_uint64( output , num_cuts );
+   write_uint64( output , num_var );
+   write_uint64( output , offset );
+   offset += num_cuts * ( num_var + 1 ) * sizeof( double );
+  }
+
+  // The data of each stage
+
+  std::vector< double > buffer;
+
+  for( Index stage = 0 ; stage < num_stages ; ++stage ) {
+   const auto function = functions[ stage ];
+   const auto & A = function->get_A();
+   const auto & b = function->get_b();
+   const std::size_t num_var = function->get_num_active_var();
+
+   buffer.clear();
+   buffer.reserve( b.size() * ( num_var + 1 ) );
+   for( Index i = 0 ; i < b.size() ; ++i ) {
+    if( A[ i ].size() != num_var )
+     throw( std::logic_error( "CutArchive::write: invalid cut " +
+                              std::to_string( i ) + " at stage " +
+                              std::to_string( stage ) + "." ) );
+    buffer.insert( buffer.end() , A[ i ].begin() , A[ i ].end() );
+    buffer.push_back( b[ i ] );
+   }
+
+   if( ! is_little_endian() )
+    for( auto & value : buffer )
+     swap_bytes( value );
+
+   output.write( reinterpret_cast< const char * >( buffer.data() ) ,
+                 buffer.size() * sizeof( double ) );
+  }
+
+  if( ! output )
+   throw( std::runtime_error( "It was not possible to write the file \"" +
+                              filename + "\"." ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether the given file is a CutArchive
+ /** Returns true if and only if the file with the given name exists and
+  * starts with the characters identifying a CutArchive. */
+
+ static bool is_cut_archive( const std::string & filename ) {
+  std::ifstream input( filename , std::ios::in | std::ios::binary );
+  char header[ magic_size ];
+  return( input.read( header , magic_size ) &&
+          ( std::memcmp( header , magic , magic_size ) == 0 ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether the given filename has the extension of a CutArchive
+
+ static bool has_archive_extension( const std::string & filename ) {
+  return( ( filename.size() >= extension.size() ) &&
+          ( filename.compare( filename.size() - extension.size() ,
+                              extension.size() , extension ) == 0 ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// the extension of the name of a CutArchive
+ static inline const std::string extension = ".bin";
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ struct StageInfo {
+  std::uint64_t num_cuts;  ///< number of cuts of the stage
+  std::uint64_t num_var;   ///< number of coefficients of each cut
+  std::uint64_t offset;    ///< offset of the data of the stage in the file
+ };
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- PRIVATE METHODS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ static bool is_little_endian() {
+  const std::uint16_t one = 1;
+  unsigned char first_byte;
+  std::memcpy( & first_byte , & one , 1 );
+  return( first_byte == 1 );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ template< class T >
+ static void swap_bytes( T & value ) {
+  unsigned char bytes[ sizeof( T ) ];
+  std::memcpy( bytes , & value , sizeof( T ) );
+  for( std::size_t i = 0 ; i < sizeof( T ) / 2 ; ++i )
+   std::swap( bytes[ i ] , bytes[ sizeof( T ) - 1 - i ] );
+  std::memcpy( & value , bytes , sizeof( T ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ std::uint64_t read_uint64() {
+  std::uint64_t value;
+  if( ! file.read( reinterpret_cast< char * >( & value ) , sizeof( value ) ) )
+   throw( std::logic_error( "File \"" + filename + "\" is truncated or "
+                            "corrupted." ) );
+  if( ! is_little_endian() )
+   swap_bytes( value );
+  return( value );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ static void write_uint64( std::ofstream & output , std::uint64_t value ) {
+  if( ! is_little_endian() )
+   swap_bytes( value );
+  output.write( reinterpret_cast< const char * >( & value ) ,
+                sizeof( value ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ static constexpr std::size_t magic_size = 8;
+
+ static constexpr char magic[ magic_size + 1 ] = "SMSCUTS1";
+
+ std::string filename;
+
+ std::ifstream file;
+
+ std::vector< StageInfo > v_stage;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class CutArchive )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* CutArchive.h included */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ End File CutArchive.h ---------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -0,0 +1,519 @@
+/*--------------------------------------------------------------------------*/
+/*------------------------- File CutFileReader.h ---------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of CutFileReader, a class for reading the CSV file containing
+ * the cuts of an SDDPBlock.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __CutFileReader
+#define __CutFileReader
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <PolyhedralFunction.h>
+#include <SDDPBlock.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*------------------------- CLASS CutFileReader ----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// a reader for the CSV file containing the cuts of an SDDPBlock
+/** The CutFileReader class reads the CSV file containing the cuts of an
+ * SDDPBlock, as written by SDDPBlockSolutionOutput::print_cuts(). The first
+ * line of this file contains a header and its content is ignored. Each of
+ * the following lines represent a cut and has the following format:
+ *
+ *     t, a_0, a_1, ..., a_k, b
+ *
+ * where t is a stage (an integer between 0 and time horizon minus 1), a_0,
+ * ..., a_k are the coefficients of the cut, and b is the constant term of the
+ * cut. Reading stops at the first line that does not start with a stage
+ * (e.g., an empty line).
+ *
+ * The file is memory-mapped and split into chunks made of whole lines, which
+ * are parsed concurrently (with std::from_chars). The cuts of each stage are
+ * then merged in the order in which they appear in the file. Errors are
+ * reported with the number of the line at which they occur (the first line
+ * after the header being line 1). */
+
+class CutFileReader {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// reads the cuts in the given file
+ /** Reads the cuts in the file with the given name. The size of \p num_var
+  * is the number of stages and num_var[ t ] is the number of coefficients
+  * of each cut of stage t. After this function returns, A[ t ] and b[ t ]
+  * contain the coefficients and the constant terms of the cuts of stage t.
+  *
+  * @param num_threads The maximum number of threads used to parse the file.
+  *        If it is zero, get_default_number_threads() is used. At most one
+  *        thread per megabyte of the file is used. */
+
+ static void read( const std::string & filename ,
+                   const std::vector< Index > & num_var ,
+                   std::vector< PolyhedralFunction::MultiVector > & A ,
+                   std::vector< PolyhedralFunction::RealVector > & b ,
+                   unsigned int num_threads = 0 ) {
+
+  const auto num_stages = num_var.size();
+
+  A.assign( num_stages , PolyhedralFunction::MultiVector{} );
+  b.assign( num_stages , PolyhedralFunction::RealVector{} );
+
+  MappedFile file( filename );
+
+  const char * const begin = file.data;
+  const char * const end = file.data + file.size;
+
+  // Skip the first line containing the header
+
+  auto data = static_cast< const char * >
+   ( std::memchr( begin , '\n' , end - begin ) );
+  if( ! data )
+   return;
+  ++data;
+
+  // Split the file into chunks made of whole lines
+
+  if( num_threads == 0 )
+   num_threads = get_default_number_threads();
+
+  const std::size_t size = end - data;
+  const std::size_t num_chunks =
+   std::max( std::size_t( 1 ) ,
+             std::min( std::size_t( num_threads ) , size >> 20 ) );
+
+  std::vector< const char * > chunk_begin( num_chunks + 1 , end );
+  chunk_begin[ 0 ] = data;
+  for( std::size_t k = 1 ; k < num_chunks ; ++k ) {
+   auto p = std::max( chunk_begin[ k - 1 ] ,
+                      data + ( size * k ) / num_chunks );
+   if( p < end && p != data && *( p - 1 ) != '\n' ) {
+    p = static_cast< const char * >( std::memchr( p , '\n' , end - p ) );
+    p = p ? p + 1 : end;
+   }
+   chunk_begin[ k ] = p;
+  }
+
+  // Parse the chunks
+
+  std::vector< Chunk > chunks( num_chunks );
+
+  if( num_chunks == 1 )
+   parse( data , end , num_var , chunks[ 0 ] );
+  else {
+   std::vector< std::thread > threads;
+   threads.reserve( num_chunks );
+   for( std::size_t k = 0 ; k < num_chunks ; ++k )
+    threads.emplace_back( [ & , k ]() {
+     parse( chunk_begin[ k ] , chunk_begin[ k + 1 ] , num_var ,
+            chunks[ k ] );
+    } );
+   for( auto & thread : threads )
+    thread.join();
+  }
+
+  // Merge the cuts of each stage in file order
+
+  std::size_t first_line = 0;
+
+  for( auto & chunk : chunks ) {
+
+   if( ! chunk.error.empty() )
+    throw( std::logic_error( "File \"" + filename + "\" " + chunk.error +
+                             " at line " +
+                             std::to_string( first_line + chunk.error_line )
+                             + "." ) );
+
+   for( Index stage = 0 ; stage < num_stages ; ++stage ) {
+    if( A[ stage ].empty() ) {
+     A[ stage ] = std::move( chunk.A[ stage ] );
+     b[ stage ] = std::move( chunk.b[ stage ] );
+    }
+    else {
+     A[ stage ].insert( A[ stage ].end() ,
+                        std::make_move_iterator( chunk.A[ stage ].begin() ) ,
+                        std::make_move_iterator( chunk.A[ stage ].end() ) );
+     b[ stage ].insert( b[ stage ].end() , chunk.b[ stage ].begin() ,
+                        chunk.b[ stage ].end() );
+    }
+   }
+
+   if( chunk.stopped )
+    break;
+
+   first_line += chunk.num_lines;
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of threads used to parse a file if none is given
+ /** Returns the number of concurrent threads supported by the hardware.
+  * When the code is compiled with MPI (USE_MPI) and MPI is running, every
+  * process may be reading its cut file at the same time, so this number
+  * is divided by the number of processes running on the same node. That
+  * number is taken from the environment set by the launcher (Open MPI's
+  * OMPI_COMM_WORLD_LOCAL_SIZE or MPICH's MPI_LOCALNRANKS), since a
+  * collective call cannot be made here; if it is not known, a single
+  * thread is used. At least one thread is always used. */
+
+ static unsigned int get_default_number_threads() {
+  const auto num_threads =
+   std::max( 1u , std::thread::hardware_concurrency() );
+
+#ifdef USE_MPI
+  int initialized = 0;
+  int finalized = 0;
+  MPI_Initialized( & initialized );
+  MPI_Finalized( & finalized );
+  if( initialized && ( ! finalized ) ) {
+   unsigned long local_size = 0;
+   for( const auto name : { "OMPI_COMM_WORLD_LOCAL_SIZE" ,
+                            "MPI_LOCALNRANKS" } )
+    if( const auto value = std::getenv( name ) ) {
+     local_size = std::strtoul( value , nullptr , 10 );
+     if( local_size > 0 )
+      break;
+    }
+   if( local_size == 0 )
+    return( 1 );
+   return( std::max( 1u , unsigned( num_threads / local_size ) ) );
+  }
+#endif
+
+  return( num_threads );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// adds the cuts in the given file to the given SDDPBlock
+ /** Adds the cuts in the file with the given name to the PolyhedralFunction
+  * of the corresponding stage in every sub-Block of \p sddp_block (assuming
+  * there is only one PolyhedralFunction per stage). The cuts of each stage
+  * are moved into its last sub-Block and released as soon as they have been
+  * added to all of them. */
+
+ static void load( SDDPBlock * sddp_block , const std::string & filename ,
+                   unsigned int num_threads = 0 ) {
+
+  const auto time_horizon = sddp_block->get_time_horizon();
+
+  std::vector< Index > num_var( time_horizon );
+  for( Index stage = 0 ; stage < time_horizon ; ++stage )
+   num_var[ stage ] =
+    sddp_block->get_polyhedral_function( stage )->get_num_active_var();
+
+  std::vector< PolyhedralFunction::MultiVector > A;
+  std::vector< PolyhedralFunction::RealVector > b;
+
+  read( filename , num_var , A , b , num_threads );
+
+  // Now, add the cuts to all PolyhedralFunctions
+
+  const auto num_sub_blocks_per_stage =
+   sddp_block->get_num_sub_blocks_per_stage();
+
+  for( Index stage = 0 ; stage < time_horizon ; ++stage ) {
+
+   if( b[ stage ].empty() )
+    continue; // no cut for this stage
+
+   for( Index sub_block_index = 0 ;
+        sub_block_index < num_sub_blocks_per_stage ; ++sub_block_index ) {
+
+    auto polyhedral_function =
+     sddp_block->get_polyhedral_function( stage , 0 , sub_block_index );
+
+    if( sub_block_index + 1 == num_sub_blocks_per_stage ) {
+     // The last replica takes the A matrix of this stage
+     polyhedral_function->add_rows( std::move( A[ stage ] ) , b[ stage ] );
+     continue;
+    }
+
+    // Copy the A matrix for this stage so that it can be moved
+    auto A_stage = A[ stage ];
+
+    polyhedral_function->add_rows( std::move( A_stage ) , b[ stage ] );
+   }
+
+   // Release the memory of this stage as soon as it is no longer needed
+   PolyhedralFunction::MultiVector().swap( A[ stage ] );
+   PolyhedralFunction::RealVector().swap( b[ stage ] );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// a read-only memory-mapped file
+
+ struct MappedFile {
+
+  explicit MappedFile( const std::string & filename ) {
+   descriptor = ::open( filename.c_str() , O_RDONLY );
+   if( descriptor < 0 )
+    throw( std::runtime_error( "It was not possible to open the file \"" +
+                               filename + "\"." ) );
+
+   struct stat status;
+   if( ::fstat( descriptor , & status ) != 0 ) {
+    ::close( descriptor );
+    throw( std::runtime_error( "It was not possible to open the file \"" +
+                               filename + "\"." ) );
+   }
+
+   size = status.st_size;
+   if( size == 0 ) {
+    data = "";
+    return;
+   }
+
+   auto address = ::mmap( nullptr , size , PROT_READ , MAP_PRIVATE ,
+                          descriptor , 0 );
+   if( address == MAP_FAILED ) {
+    ::close( descriptor );
+    throw( std::runtime_error( "It was not possible to map the file \"" +
+                               filename + "\"." ) );
+   }
+
+   ::madvise( address , size , MADV_SEQUENTIAL );
+   mapped = true;
+   data = static_cast< const char * >( address );
+  }
+
+  ~MappedFile() {
+   if( mapped )
+    ::munmap( const_cast< char * >( data ) , size );
+   ::close( descriptor );
+  }
+
+  MappedFile( const MappedFile & ) = delete;
+  MappedFile & operator=( const MappedFile & ) = delete;
+
+  int descriptor = -1;         ///< the file descriptor
+  bool mapped = false;         ///< whether the file has been mapped
+  const char * data = nullptr; ///< the content of the file
+  std::size_t size = 0;        ///< the size of the file
+ };
+
+/*--------------------------------------------------------------------------*/
+
+ /// the result of parsing a chunk of the file
+
+ struct Chunk {
+  std::vector< PolyhedralFunction::MultiVector > A; ///< cuts of each stage
+  std::vector< PolyhedralFunction::RealVector > b;  ///< constant terms
+  std::size_t num_lines = 0;  ///< number of lines parsed
+  bool stopped = false;       ///< whether a line without a stage was found
+  std::string error;          ///< description of the error (if any)
+  std::size_t error_line = 0; ///< line of the error (within the chunk)
+ };
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- PRIVATE METHODS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ static bool is_blank( char c ) {
+  return( ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) ||
+          ( c == '\v' ) || ( c == '\f' ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// parses a double in [ p , end ), advancing p if it succeeds
+
+ static bool parse_double( const char * & p , const char * end ,
+                           double & value ) {
+#if defined( __cpp_lib_to_chars ) && ( __cpp_lib_to_chars >= 201611L )
+  const auto result = std::from_chars( p , end , value );
+  if( result.ec == std::errc() ) {
+   p = result.ptr;
+   return( true );
+  }
+  // values that from_chars() does not accept (e.g., subnormal values or
+  // values with a leading '+') are left to strtod() below
+#endif
+  char token[ 64 ];
+  std::size_t length = 0;
+  while( ( p + length < end ) && ( length < sizeof( token ) - 1 ) &&
+         ( p[ length ] != ',' ) && ( p[ length ] != '\n' ) &&
+         ( ! is_blank( p[ length ] ) ) ) {
+   token[ length ] = p[ length ];
+   ++length;
+  }
+  token[ length ] = '\0';
+  char * token_end = nullptr;
+  value = std::strtod( token , & token_end );
+  if( token_end == token )
+   return( false );
+  p += token_end - token;
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// parses the lines in [ begin , end ) into the given Chunk
+
+ static void parse( const char * begin , const char * end ,
+                    const std::vector< Index > & num_var , Chunk & chunk ) {
+
+  const auto num_stages = num_var.size();
+
+  chunk.A.resize( num_stages );
+  chunk.b.resize( num_stages );
+
+  for( auto line = begin ; line < end ; ) {
+
+   auto line_end = static_cast< const char * >
+    ( std::memchr( line , '\n' , end - line ) );
+   if( ! line_end )
+    line_end = end;
+
+   ++chunk.num_lines;
+
+   auto p = line;
+   while( ( p < line_end ) && is_blank( * p ) )
+    ++p;
+
+   // Try to read the stage
+
+   Index stage;
+   const auto stage_result = std::from_chars( p , line_end , stage );
+   if( stage_result.ec != std::errc() ) {
+    chunk.stopped = true;
+    return;
+   }
+   p = stage_result.ptr;
+
+   if( stage >= num_stages ) {
+    chunk.error = "contains an invalid stage: " + std::to_string( stage );
+    chunk.error_line = chunk.num_lines;
+    return;
+   }
+
+   if( ( p == line_end ) || ( * p != ',' ) ) {
+    chunk.error = "has an invalid format";
+    chunk.error_line = chunk.num_lines;
+    return;
+   }
+   ++p;
+
+   // Read the cut
+
+   const auto num_active_var = num_var[ stage ];
+   PolyhedralFunction::RealVector a( num_active_var );
+   double constant_term = 0;
+
+   Index i = 0;
+   double value;
+   while( true ) {
+    while( ( p < line_end ) && is_blank( * p ) )
+     ++p;
+
+    if( ! parse_double( p , line_end , value ) )
+     break;
+
+    if( i > num_active_var ) {
+     chunk.error = "contains an invalid cut";
+     chunk.error_line = chunk.num_lines;
+     return;
+    }
+
+    if( i < num_active_var )
+     a[ i ] = value;
+    else
+     constant_term = value;
+
+    ++i;
+
+    if( ( p < line_end ) && ( * p == ',' ) )
+     ++p;
+   }
+
+   if( i <= num_active_var ) {
+    chunk.error = "contains an invalid cut";
+    chunk.error_line = chunk.num_lines;
+    return;
+   }
+
+   chunk.A[ stage ].push_back( std::move( a ) );
+   chunk.b[ stage ].push_back( constant_term );
+
+   line = line_end + 1;
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class CutFileReader )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* CutFileReader.h included */
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- End File CutFileReader.h -------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -27,8 +27,17 @@
 #include <SDDPBlock.h>
 
 #include "CutProcessing.h"
+#include "Profiler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 /*--------------------------------------------------------------------------*/
@@ -182,6 +191,123 @@ namespace {
 
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /** It returns true if and only if the two given rows (of size \p n) are
+  * parallel, i.e., if for every component j
+  *
+  *     | a_j - c_j | <= error
+  *
+  * and
+  *
+  *     | a_j - c_j | <= relative_error * max{ | a_j | , | c_j | }.
+  *
+  * The components are tested in blocks without branching inside a block, so
+  * that each block can be vectorized by the compiler.
+  */
+ bool are_parallel( const double * a , const double * c , Index n ,
+                    double error , double relative_error ) {
+
+  constexpr Index block_size = 8;
+
+  Index j = 0;
+  for( ; j + block_size <= n ; j += block_size ) {
+   bool not_parallel = false;
+   for( Index l = j ; l < j + block_size ; ++l ) {
+    const auto difference = std::abs( a[ l ] - c[ l ] );
+    not_parallel |= ( difference > error ) |
+     ( difference > relative_error *
+       std::max( std::abs( a[ l ] ) , std::abs( c[ l ] ) ) );
+   }
+   if( not_parallel )
+    return( false );
+  }
+
+  for( ; j < n ; ++j ) {
+   const auto difference = std::abs( a[ j ] - c[ j ] );
+   if( ( difference > error ) ||
+       ( difference > relative_error *
+         std::max( std::abs( a[ j ] ) , std::abs( c[ j ] ) ) ) )
+    return( false );
+  }
+
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /** Given a PolyhedralFunction and a point x (of size equal to the number of
+  * active variables of the function), it marks as active (in \p is_active)
+  * every cut k for which it can be certified at x that the LP of
+  * build_lp() for k (i.e., when k is in the objective) has an optimal value
+  * that is not less than s * b_k + error or not less than s * b_k +
+  * relative_error * max( | objective_value | , | b_k | ). These cuts are not
+  * redundant and need not be checked by solving that LP.
+  *
+  * Let w_i = - s * ( a_i x + b_i ). The value of the LP for cut k is at least
+  * s * b_k + w_k - max{ w_i : i != k }, i.e., s * b_k plus the margin by
+  * which cut k is the active one at x (which can be negative). Since
+  * removing other cuts can only increase this margin, the certificate is
+  * also valid for the LPs in which some of the other cuts have been
+  * removed. Notice that the relative condition is only used for
+  * relative_error < 1, for which the test is monotone in the value of the
+  * LP. The vector \p values is used as workspace.
+  */
+ void mark_active_cuts( PolyhedralFunction * function ,
+                        const std::vector< double > & x ,
+                        double error , double relative_error ,
+                        std::vector< bool > & is_active ,
+                        std::vector< double > & values ) {
+
+  const auto & A = function->get_A();
+  const auto & b = function->get_b();
+  const auto num_rows = A.size();
+  const auto sign = get_sign( function );
+
+  values.resize( num_rows );
+
+  // w_i for all cuts (a matrix-vector product), and the two largest values
+
+  Index best = 0;
+  auto best_value = - Inf< double >();
+  auto second_best_value = - Inf< double >();
+
+  for( Index i = 0 ; i < num_rows ; ++i ) {
+   const auto & a = A[ i ];
+   double value = b[ i ];
+   for( Index j = 0 ; j < a.size() ; ++j )
+    value += a[ j ] * x[ j ];
+   values[ i ] = - sign * value;
+
+   if( values[ i ] > best_value ) {
+    second_best_value = best_value;
+    best_value = values[ i ];
+    best = i;
+   }
+   else if( values[ i ] > second_best_value )
+    second_best_value = values[ i ];
+  }
+
+  for( Index k = 0 ; k < num_rows ; ++k ) {
+   if( is_active[ k ] )
+    continue;
+
+   const auto margin = values[ k ] -
+    ( k == best ? second_best_value : best_value );
+
+   if( std::isnan( margin ) )
+    continue;
+
+   const auto lower_bound = sign * b[ k ] + margin;
+
+   if( ( margin >= error ) ||
+       ( ( relative_error < 1 ) &&
+         ( lower_bound >= sign * b[ k ] + relative_error *
+           std::max( std::abs( lower_bound ) , std::abs( b[ k ] ) ) ) ) )
+    is_active[ k ] = true;
+  }
+ }
+
 }  // end( unnamed namespace )
 
 /*--------------------------------------------------------------------------*/
@@ -191,6 +317,8 @@ namespace {
 void CutProcessing::remove_parallel_cuts( PolyhedralFunction * function )
  const {
 
+ Profiler::ScopedTimer timer( "remove_parallel_cuts" );
+
  const auto & A = function->get_A();
 
  if( A.empty() )
@@ -201,58 +329,165 @@ void CutProcessing::remove_parallel_cuts( PolyhedralFunction * function )
  assert( A.size() == b.size() );
 
  const auto sign = get_sign( function );
+ const Index num_rows = A.size();
+ const Index num_var = A.front().size();
+
+ // Copy the rows into a contiguous (row-major) buffer
+
+ std::vector< double > rows( std::size_t( num_rows ) * num_var );
+ for( Index i = 0 ; i < num_rows ; ++i ) {
+  assert( A[ i ].size() == num_var );
+  std::copy( A[ i ].cbegin() , A[ i ].cend() ,
+             rows.begin() + std::size_t( i ) * num_var );
+ }
+
+ /* Two rows can only be parallel if they differ by at most parallel_error
+  * in every component and, in particular, in a "key" component. The rows are
+  * sorted by the value of their key component, so that the candidates to be
+  * parallel to a given row can be found by binary search. The key component
+  * is the one whose values have the largest range, which is the most
+  * selective one. Rows whose key value is NaN are always candidates (as NaN
+  * differences pass the parallel test).
+  *
+  * The candidates of a row must be compared with it in the order of their
+  * indices. They are sorted if there are few of them; otherwise, all the
+  * following rows are scanned in order and those outside the window are
+  * skipped, so that the search costs O( min{ w log w , m } ) for a window of
+  * w rows out of m. Hence, the worst case (e.g., when most cuts share the
+  * same key value) is that of comparing every pair of rows, i.e., O( m^2 n )
+  * for m rows of n components, while well-spread keys give
+  * O( m log m + m w n ). */
+
+ Index key = 0;
+ double largest_range = -1;
+ for( Index j = 0 ; j < num_var ; ++j ) {
+  double min = Inf< double >();
+  double max = -Inf< double >();
+  for( Index i = 0 ; i < num_rows ; ++i ) {
+   const auto value = rows[ std::size_t( i ) * num_var + j ];
+   if( std::isnan( value ) ) continue;
+   min = std::min( min , value );
+   max = std::max( max , value );
+  }
+  const auto range = ( min <= max ) ? max - min : 0;
+  if( range > largest_range ) {
+   largest_range = range;
+   key = j;
+  }
+ }
+
+ const auto key_value = [ & ]( Index i ) {
+  return( num_var > 0 ? rows[ std::size_t( i ) * num_var + key ] : 0.0 );
+ };
+
+ // The rows sorted by key value, with the NaN ones at the end
+
+ std::vector< Index > order( num_rows );
+ std::iota( order.begin() , order.end() , 0 );
+ const auto nan_begin = std::partition
+  ( order.begin() , order.end() ,
+    [ & ]( Index i ) { return( ! std::isnan( key_value( i ) ) ); } );
+ std::sort( order.begin() , nan_begin , [ & ]( Index i , Index k ) {
+  return( key_value( i ) < key_value( k ) ); } );
+
+ std::vector< double > sorted_keys;
+ sorted_keys.reserve( nan_begin - order.begin() );
+ for( auto it = order.begin() ; it != nan_begin ; ++it )
+  sorted_keys.push_back( key_value( *it ) );
 
  Subset rows_to_remove;
- std::vector< bool > remove( A.size() , false );
+ std::vector< bool > remove( num_rows , false );
+ std::vector< Index > candidates;
 
- for( Index i = 0 ; i < A.size() ; ++i ) {
+ for( Index i = 0 ; i < num_rows ; ++i ) {
   if( remove[ i ] ) continue;
 
-  for( Index k = i + 1 ; k < A.size() ; ++k ) {
-   if( remove[ k ] ) continue;
+  // Find the candidates, i.e., the rows k > i (not yet removed) whose key
+  // value is within parallel_error of that of row i
+
+  candidates.clear();
+
+  // Without a window (NaN key value, no variable or infinite error), every
+  // row is a candidate
+
+  auto first = order.begin();
+  auto last = order.end();
+  auto lower = - Inf< double >();
+  auto upper = Inf< double >();
+
+  const auto value = key_value( i );
+  const bool has_window = ( ! std::isnan( value ) ) && ( num_var > 0 ) &&
+   ( parallel_error < Inf< double >() );
+
+  if( has_window ) {
+   // The window is slightly enlarged so that no candidate is missed due to
+   // rounding; the exact test is performed by are_parallel() anyway.
+   const auto slack = std::isfinite( value ) ?
+    1e-12 * ( std::abs( value ) + parallel_error ) : 0.0;
+   lower = value - parallel_error - slack;
+   upper = value + parallel_error + slack;
+   first += std::lower_bound( sorted_keys.cbegin() , sorted_keys.cend() ,
+                              lower ) - sorted_keys.cbegin();
+   last = order.begin() +
+    ( std::upper_bound( sorted_keys.cbegin() , sorted_keys.cend() ,
+                        upper ) - sorted_keys.cbegin() );
+  }
+
+  const std::size_t window = ( last - first ) +
+   ( has_window ? order.end() - nan_begin : 0 );
 
-   assert( A[ i ].size() == A[ k ].size() );
+  // The candidates are considered in the order of their indices, so that
+  // the result is the same as comparing row i with all rows k > i.
 
-   bool parallel = true;
+  if( double( window ) * std::log2( double( window ) + 1 ) <
+      double( num_rows - i ) ) {
+   for( auto it = first ; it != last ; ++it )
+    if( ( *it > i ) && ( ! remove[ *it ] ) )
+     candidates.push_back( *it );
 
-   for( Index j = 0 ; j < A[ i ].size() ; ++j ) {
-    if( ( std::abs( A[ i ][ j ] - A[ k ][ j ] ) > parallel_error ) ||
-        ( std::abs( A[ i ][ j ] - A[ k ][ j ] ) > parallel_relative_error *
-          std::max( std::abs( A[ i ][ j ] ) , std::abs( A[ k ][ j ] ) ) ) ) {
-     parallel = false;
-     break;
-    }
+   if( has_window )
+    for( auto it = nan_begin ; it != order.end() ; ++it )
+     if( ( *it > i ) && ( ! remove[ *it ] ) )
+      candidates.push_back( *it );
+
+   std::sort( candidates.begin() , candidates.end() );
+  }
+  else
+   for( Index k = i + 1 ; k < num_rows ; ++k ) {
+    if( remove[ k ] )
+     continue;
+    const auto key_k = key_value( k );
+    if( ( ! has_window ) || std::isnan( key_k ) ||
+        ( ( key_k >= lower ) && ( key_k <= upper ) ) )
+     candidates.push_back( k );
    }
 
-   if( parallel ) {
-    if( sign * b[ i ] > sign * b[ k ] ) {
-     remove[ i ] = true;
-     rows_to_remove.push_back( i );
-     break;
-    }
-    else {
-     remove[ k ] = true;
-     rows_to_remove.push_back( k );
-    }
+  for( auto k : candidates ) {
+
+   if( ! ::are_parallel( rows.data() + std::size_t( i ) * num_var ,
+                         rows.data() + std::size_t( k ) * num_var , num_var ,
+                         parallel_error , parallel_relative_error ) )
+    continue;
+
+   if( sign * b[ i ] > sign * b[ k ] ) {
+    remove[ i ] = true;
+    rows_to_remove.push_back( i );
+    break;
+   }
+   else {
+    remove[ k ] = true;
+    rows_to_remove.push_back( k );
    }
   }
  }
 
+ Profiler::count( "parallel_cuts" , rows_to_remove.size() );
  function->delete_rows( std::move( rows_to_remove ) );
 }
 
 /*--------------------------------------------------------------------------*/
 
-void CutProcessing::remove_redundant_cuts( PolyhedralFunction * function )
- const {
-
- auto num_rows = function->get_nrows();
-
- if( num_rows <= 1 )
-  return;
-
- auto lp = ::build_lp( function );
-
+BlockSolverConfig * CutProcessing::get_solver_config() const {
  if( config_filename.empty() ) {
   auto bsc = new BlockSolverConfig();
   auto cc = new ComputeConfig();
@@ -260,18 +495,74 @@ void CutProcessing::remove_redundant_cuts( PolyhedralFunction * function )
   cc->set_par( "dblFAccSol" , double( 1.0e-15 ) );
   cc->set_par( "dblRelAcc" , double( 1.0e-15 ) );
   bsc->add_ComputeConfig( "CPXMILPSolver" , cc );
-  bsc->apply( lp );
+  return( bsc );
  }
- else {
-  auto solver_config = dynamic_cast< BlockSolverConfig * >
-   ( BlockSolverConfig::new_Configuration( config_filename ) );
-  if( ! solver_config )
-   throw( std::logic_error("CutProcessing::remove_redundant_cuts: invalid or "
+
+ auto configuration = Configuration::new_Configuration( config_filename );
+ auto solver_config = dynamic_cast< BlockSolverConfig * >( configuration );
+ if( ! solver_config ) {
+  delete( configuration );
+  throw( std::logic_error( "CutProcessing::remove_redundant_cuts: invalid or "
                            "inexistent configuration file: " +
                            config_filename ) );
-  solver_config->apply( lp );
+ }
+ return( solver_config );
+}
+
+/*--------------------------------------------------------------------------*/
+
+Subset CutProcessing::find_inactive_cuts
+( PolyhedralFunction * function ,
+  const std::vector< std::vector< double > > * points ,
+  BlockSolverConfig * solver_config ) const {
+
+ Profiler::ScopedTimer timer( "find_inactive_cuts" );
+
+ auto num_rows = function->get_nrows();
+
+ if( num_rows <= 1 )
+  return( {} );
+
+ // Level-of-dominance pre-filter: the cuts that are active at the current
+ // point or at any of the given sample points are certainly kept, so that
+ // the LP only needs to be solved for the remaining ones
+
+ const auto num_var = function->get_num_active_var();
+
+ std::vector< bool > is_active( num_rows , false );
+ std::vector< double > values;
+
+ std::vector< double > current_point( num_var );
+ for( Index j = 0 ; j < num_var ; ++j )
+  current_point[ j ] = static_cast< ColVariable * >
+   ( function->get_active_var( j ) )->get_value();
+
+ ::mark_active_cuts( function , current_point , optimization_error ,
+                     optimization_relative_error , is_active , values );
+
+ if( points )
+  for( const auto & point : * points ) {
+   if( point.size() != num_var )
+    throw( std::invalid_argument( "CutProcessing::remove_redundant_cuts: "
+                                  "invalid size of a sample point" ) );
+   ::mark_active_cuts( function , point , optimization_error ,
+                       optimization_relative_error , is_active , values );
+  }
+
+ if( std::all_of( is_active.begin() , is_active.end() ,
+                  []( bool active ) { return( active ); } ) )
+  return( {} );
+
+ std::unique_ptr< BlockSolverConfig > own_solver_config;
+ if( ! solver_config ) {
+  own_solver_config.reset( get_solver_config() );
+  solver_config = own_solver_config.get();
  }
 
+ auto lp = ::build_lp( function );
+ solver_config->apply( lp );
+ own_solver_config.reset();
+
  auto solver = lp->get_registered_solvers().front();
 
  num_rows = function->get_nrows();
@@ -286,7 +577,7 @@ void CutProcessing::remove_redundant_cuts( PolyhedralFunction * function )
 
   bool remove = false;
 
-  if( solver->compute() == Solver::kOK ) {
+  if( ( ! is_active[ i ] ) && ( solver->compute() == Solver::kOK ) ) {
    const auto objective_value = solver->get_var_value();
    if( ( objective_value < sign * b[ i ] + optimization_error ) &&
        ( objective_value < sign * b[ i ] + optimization_relative_error *
@@ -300,10 +591,20 @@ void CutProcessing::remove_redundant_cuts( PolyhedralFunction * function )
    ::update_lp( lp , function , i , ! remove );
  }
 
- function->delete_rows( std::move( rows_to_remove ) );
-
  delete( solver );
  delete( lp );
+
+ Profiler::count( "inactive_cuts" , rows_to_remove.size() );
+ return( rows_to_remove );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void CutProcessing::remove_redundant_cuts( PolyhedralFunction * function )
+ const {
+ auto rows_to_remove = find_inactive_cuts( function );
+ if( ! rows_to_remove.empty() )
+  function->delete_rows( std::move( rows_to_remove ) );
 }
 
 /*--------------------------------------------------------------------------*/
@@ -318,10 +619,92 @@ void CutProcessing::remove_parallel_cuts( SDDPBlock * sddp_block ) const {
 /*--------------------------------------------------------------------------*/
 
 void CutProcessing::remove_redundant_cuts( SDDPBlock * sddp_block ) const {
+ Profiler::ScopedTimer timer( "remove_redundant_cuts" );
  auto functions = sddp_block->get_polyhedral_functions();
- for( auto function : functions ) {
+
+ const auto num_threads = std::min( std::size_t( number_threads ) ,
+                                    functions.size() );
+
+ // The configuration of the Solver is read once, by the calling thread
+ // (reading a netCDF file is not thread-safe), and each thread is given
+ // its own copy of it
+
+ const std::unique_ptr< BlockSolverConfig > solver_config
+  ( get_solver_config() );
+
+ if( num_threads <= 1 ) {
+  for( Index i = 0 ; i < functions.size() ; ++i ) {
+   remove_parallel_cuts( functions[ i ] );
+   auto rows_to_remove = find_inactive_cuts( functions[ i ] ,
+                                             get_sample_points( i ) ,
+                                             solver_config.get() );
+   if( ! rows_to_remove.empty() )
+    functions[ i ]->delete_rows( std::move( rows_to_remove ) );
+  }
+  return;
+ }
+
+ // The parallel cuts are removed by the calling thread, as well as the
+ // inactive ones after they have been identified, since deleting rows from
+ // a PolyhedralFunction may issue Modification to its (shared) ancestors.
+ // The threads only read the PolyhedralFunction and work on their own LPs.
+
+ for( auto function : functions )
   remove_parallel_cuts( function );
-  remove_redundant_cuts( function );
+
+ std::vector< Subset > rows_to_remove( functions.size() );
+ std::atomic< std::size_t > next_function( 0 );
+ std::exception_ptr exception;
+ std::mutex exception_mutex;
+
+ std::vector< std::unique_ptr< BlockSolverConfig > > solver_configs;
+ for( std::size_t t = 0 ; t < num_threads ; ++t )
+  solver_configs.emplace_back( solver_config->clone() );
+
+ auto worker = [ & ]( BlockSolverConfig * config ) {
+  for( auto i = next_function++ ; i < functions.size() ;
+       i = next_function++ ) {
+   try {
+    rows_to_remove[ i ] = find_inactive_cuts( functions[ i ] ,
+                                              get_sample_points( i ) ,
+                                              config );
+   }
+   catch( ... ) {
+    std::lock_guard< std::mutex > guard( exception_mutex );
+    if( ! exception )
+     exception = std::current_exception();
+    next_function = functions.size();
+   }
+  }
+ };
+
+ std::vector< std::thread > threads;
+ threads.reserve( num_threads - 1 );
+ for( std::size_t t = 1 ; t < num_threads ; ++t )
+  threads.emplace_back( worker , solver_configs[ t ].get() );
+ worker( solver_configs.front().get() );
+ for( auto & thread : threads )
+  thread.join();
+
+ if( exception )
+  std::rethrow_exception( exception );
+
+ for( std::size_t i = 0 ; i < functions.size() ; ++i )
+  if( ! rows_to_remove[ i ].empty() )
+   functions[ i ]->delete_rows( std::move( rows_to_remove[ i ] ) );
+}
+
+/*--------------------------------------------------------------------------*/
+
+void CutProcessing::add_sample_points( SDDPBlock * sddp_block ) {
+ auto functions = sddp_block->get_polyhedral_functions();
+ for( Index i = 0 ; i < functions.size() ; ++i ) {
+  const auto function = functions[ i ];
+  std::vector< double > point( function->get_num_active_var() );
+  for( Index j = 0 ; j < point.size() ; ++j )
+   point[ j ] = static_cast< ColVariable * >
+    ( function->get_active_var( j ) )->get_value();
+  add_sample_point( i , std::move( point ) );
  }
 }
 
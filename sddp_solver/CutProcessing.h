@@ -23,9 +23,14 @@
 /*------------------------------ INCLUDES ----------------------------------*/
 /*--------------------------------------------------------------------------*/
 
+#include <BlockSolverConfig.h>
 #include <PolyhedralFunction.h>
 #include <SDDPBlock.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 /*--------------------------------------------------------------------------*/
 /*--------------------------- NAMESPACE ------------------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -94,6 +99,29 @@ using namespace SMSpp_di_unipi_it;
  * name of the configuration file can be specified by the function
  * set_config_filename(). If no configuration file is provided, then a
  * CPXMILPSolver is used to solve that problem.
+ *
+ * When the cuts of an SDDPBlock are processed, the PolyhedralFunction of
+ * each stage is independent from the others. Therefore, the inactive cuts
+ * of different PolyhedralFunction can be identified concurrently. The number
+ * of threads used for this purpose can be specified by the function
+ * set_number_threads(). Each thread builds its own linear programming
+ * problem and its own Solver (configured by a copy of the configuration,
+ * which is read only once by the calling thread), while the deletion of the
+ * rows of each PolyhedralFunction is always performed by the calling
+ * thread.
+ *
+ * Before solving the linear programming problem above for a cut k, a cheaper
+ * ("level-of-dominance") test is performed: if there is a point x at which
+ * cut k exceeds (in the convex case; is exceeded by, in the concave case)
+ * all the other cuts by a margin that makes the value of that problem not
+ * less than s * b_k + optimization_error (or than the relative threshold),
+ * then cut k is certainly not redundant and the problem is not solved. The
+ * points that are tested are the current values of the active variables of
+ * the PolyhedralFunction and, for the PolyhedralFunction of an SDDPBlock,
+ * the sample points given by add_sample_point() or add_sample_points()
+ * (for instance, the trial points of previous simulations). Only distinct
+ * sample points are kept, and at most the most recent
+ * set_max_number_sample_points() of them for each PolyhedralFunction.
  */
 
 class CutProcessing {
@@ -152,12 +180,135 @@ public:
   config_filename = filename;
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// sets the number of threads used by remove_redundant_cuts( SDDPBlock * )
+ /** Sets the maximum number of threads that can be used to identify the
+  * inactive cuts of the PolyhedralFunction of an SDDPBlock. If \p n is
+  * zero, the number of concurrent threads supported by the hardware is
+  * used. The default value is 1, in which case all the PolyhedralFunction
+  * are processed sequentially by the calling thread. */
+
+ void set_number_threads( unsigned int n ) {
+  number_threads = n;
+  if( number_threads == 0 )
+   number_threads = std::max( 1u , std::thread::hardware_concurrency() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// sets the maximum number of sample points of each PolyhedralFunction
+ /** Sets the maximum number of sample points (see add_sample_point()) that
+  * are kept for each PolyhedralFunction: once it is reached, adding a new
+  * point discards the oldest one, since the most recent (trial) points are
+  * the most likely to certify the cuts that are currently active. Each
+  * sample point costs a product of the matrix of the cuts by the point in
+  * every call to remove_redundant_cuts( SDDPBlock * ). If \p n is zero, no
+  * sample point is kept. The default value is #default_max_sample_points. */
+
+ void set_max_number_sample_points( std::size_t n ) {
+  max_number_sample_points = n;
+  for( auto & points : sample_points )
+   if( points.size() > n )
+    points.erase( points.begin() , points.end() - n );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// adds a sample point for the i-th PolyhedralFunction of an SDDPBlock
+ /** Adds the given point to the set of sample points that are used by
+  * remove_redundant_cuts( SDDPBlock * ) to identify the cuts that are
+  * certainly not redundant for the \p i-th PolyhedralFunction of the
+  * SDDPBlock (in the order given by SDDPBlock::get_polyhedral_functions()).
+  * The size of \p point must be equal to the number of active variables of
+  * this PolyhedralFunction. A point that is equal to one of the sample
+  * points of this PolyhedralFunction is not added again (the same trial
+  * point is often found by many iterations), and the oldest point is
+  * discarded if the maximum number of sample points (see
+  * set_max_number_sample_points()) would be exceeded. */
+
+ void add_sample_point( Block::Index i , std::vector< double > point ) {
+  if( max_number_sample_points == 0 )
+   return;
+  if( i >= sample_points.size() )
+   sample_points.resize( i + 1 );
+  auto & points = sample_points[ i ];
+  if( std::find( points.cbegin() , points.cend() , point ) != points.cend() )
+   return;
+  if( points.size() >= max_number_sample_points )
+   points.erase( points.begin() ,
+                 points.end() - ( max_number_sample_points - 1 ) );
+  points.push_back( std::move( point ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// adds the current values of the variables of the cuts as sample points
+ /** For each PolyhedralFunction of the given SDDPBlock, adds the current
+  * values of its active variables as a sample point (see add_sample_point()).
+  * This can be used, for instance, after the solution of a simulation has
+  * been written into the SDDPBlock, so that its trial points are used for
+  * the cuts of the following ones. */
+
+ void add_sample_points( SDDPBlock * sddp_block );
+
+/*--------------------------------------------------------------------------*/
+
+ /// removes all the sample points
+
+ void clear_sample_points() {
+  sample_points.clear();
+ }
+
 /*--------------------------------------------------------------------------*/
 /*---------------------- PROTECTED PART OF THE CLASS -----------------------*/
 /*--------------------------------------------------------------------------*/
 
 protected:
 
+/*--------------------------------------------------------------------------*/
+/*-------------------- PROTECTED METHODS OF THE CLASS ----------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// returns the indices of the inactive rows of the given function
+ /** Returns the (ordered) indices of the rows of the given PolyhedralFunction
+  * that are inactive, without modifying the PolyhedralFunction. The linear
+  * programming problem and the Solver that are used for this purpose are
+  * created and destroyed by this function, so that it can be concurrently
+  * invoked on different PolyhedralFunction. If \p points is not nullptr,
+  * the cuts that are active at some of these points are not checked by
+  * solving the linear programming problem. The Solver is configured by
+  * \p solver_config, which must not be shared by concurrent invocations;
+  * if it is nullptr, the configuration is obtained by get_solver_config()
+  * (and then destroyed). */
+
+ Block::Subset find_inactive_cuts
+ ( PolyhedralFunction * function ,
+   const std::vector< std::vector< double > > * points = nullptr ,
+   BlockSolverConfig * solver_config = nullptr ) const;
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns a new configuration of the Solver of the linear programs
+ /** Returns a new BlockSolverConfig (to be destroyed by the caller), read
+  * out of the configuration file (see set_config_filename()) or, if there
+  * is none, one for a CPXMILPSolver. A std::logic_error is thrown if the
+  * file does not contain a valid BlockSolverConfig. Since the file may be a
+  * netCDF one, this must not be called by concurrent threads. */
+
+ BlockSolverConfig * get_solver_config() const;
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the sample points of the i-th PolyhedralFunction (or nullptr)
+
+ const std::vector< std::vector< double > > * get_sample_points
+ ( Block::Index i ) const {
+  if( i >= sample_points.size() )
+   return( nullptr );
+  return( & sample_points[ i ] );
+ }
+
 /*--------------------------------------------------------------------------*/
 /*--------------------- PROTECTED FIELDS OF THE CLASS ----------------------*/
 /*--------------------------------------------------------------------------*/
@@ -172,6 +323,19 @@ protected:
 
  std::string config_filename;
 
+ unsigned int number_threads = 1;
+
+ /// the default maximum number of sample points of each PolyhedralFunction
+ static constexpr std::size_t default_max_sample_points = 64;
+
+ /// the maximum number of sample points of each PolyhedralFunction
+ std::size_t max_number_sample_points = default_max_sample_points;
+
+ /// the sample points of each PolyhedralFunction of an SDDPBlock
+ /** The points of each PolyhedralFunction are distinct and ordered from the
+  * oldest to the most recent. */
+ std::vector< std::vector< std::vector< double > > > sample_points;
+
 };
 
 /*--------------------------------------------------------------------------*/
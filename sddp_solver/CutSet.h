@@ -0,0 +1,215 @@
+/*--------------------------------------------------------------------------*/
+/*----------------------------- File CutSet.h ------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of CutSet, a class that holds a copy of the cuts of every
+ * PolyhedralFunction of an SDDPBlock, so that they can be given to other
+ * SDDPBlocks with the same structure.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __CutSet
+#define __CutSet
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <PolyhedralFunction.h>
+#include <SDDPBlock.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- CLASS CutSet ---------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// the cuts (A and b) of every PolyhedralFunction of an SDDPBlock
+/** The CutSet class keeps a copy of the rows of every PolyhedralFunction of
+ * an SDDPBlock, in the order given by SDDPBlock::get_polyhedral_functions().
+ * A CutSet is never modified once it has been taken, so it can be shared
+ * (e.g., through a std::shared_ptr< const CutSet >) by many threads, each
+ * giving its cuts to a different SDDPBlock with apply_to(). This is meant
+ * for SDDPBlocks with the same structure, such as the replicas of an
+ * SDDPBlock or the same SDDPBlock at different times: apply_to() replaces
+ * all the rows of the SDDPBlock it is applied to. */
+
+class CutSet {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// constructs an empty CutSet
+ CutSet() = default;
+
+/*--------------------------------------------------------------------------*/
+
+ /// takes a copy of the cuts of every PolyhedralFunction of the SDDPBlock
+ explicit CutSet( SDDPBlock * block ) {
+  for( auto function : block->get_polyhedral_functions() )
+   v_cuts.emplace_back( function->get_A() , function->get_b() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of PolyhedralFunction
+ Index size() const { return( v_cuts.size() ); }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the total number of cuts
+ Index get_number_cuts() const {
+  Index number_cuts = 0;
+  for( const auto & cuts : v_cuts )
+   number_cuts += cuts.second.size();
+  return( number_cuts );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// replaces the cuts of every PolyhedralFunction of the given SDDPBlock
+ /** Replaces the rows of the i-th PolyhedralFunction of \p block by a copy
+  * of the i-th cuts of this CutSet. A std::logic_error is thrown if the
+  * SDDPBlock does not have as many PolyhedralFunction as this CutSet or if
+  * the number of active variables of some of them does not match the size
+  * of the cuts. This CutSet is not modified, so that many threads can apply
+  * it to different SDDPBlocks at the same time. */
+
+ void apply_to( SDDPBlock * block ) const {
+  auto functions = block->get_polyhedral_functions();
+
+  if( functions.size() != v_cuts.size() )
+   throw( std::logic_error( "CutSet::apply_to: the SDDPBlock has " +
+                            std::to_string( functions.size() ) +
+                            " PolyhedralFunction, but " +
+                            std::to_string( v_cuts.size() ) +
+                            " were expected." ) );
+
+  for( Index i = 0 ; i < functions.size() ; ++i ) {
+   const auto & A = v_cuts[ i ].first;
+   if( ( ! A.empty() ) &&
+       ( A.front().size() != functions[ i ]->get_num_active_var() ) )
+    throw( std::logic_error( "CutSet::apply_to: the PolyhedralFunction " +
+                             std::to_string( i ) + " of the SDDPBlock has "
+                             "the wrong number of active variables." ) );
+  }
+
+  for( Index i = 0 ; i < functions.size() ; ++i ) {
+   const auto function = functions[ i ];
+
+   remove_rows( function );
+
+   if( ! v_cuts[ i ].second.empty() ) {
+    auto A = v_cuts[ i ].first;
+    function->add_rows( std::move( A ) , v_cuts[ i ].second );
+   }
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// removes the cuts of every PolyhedralFunction of the given SDDPBlock
+ static void remove_cuts( SDDPBlock * block ) {
+  for( auto function : block->get_polyhedral_functions() )
+   remove_rows( function );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether two SDDPBlocks have exactly the same cuts
+ /** Returns true if the two SDDPBlocks have the same number of
+  * PolyhedralFunction and if the i-th PolyhedralFunction of both has the
+  * same number of active variables and the same rows, for every i. No copy
+  * of the cuts is made. */
+
+ static bool have_same_cuts( SDDPBlock * block , SDDPBlock * other ) {
+  const auto functions = block->get_polyhedral_functions();
+  const auto other_functions = other->get_polyhedral_functions();
+
+  if( functions.size() != other_functions.size() )
+   return( false );
+
+  for( Index i = 0 ; i < functions.size() ; ++i ) {
+   if( ( functions[ i ]->get_num_active_var() !=
+         other_functions[ i ]->get_num_active_var() ) ||
+       ( functions[ i ]->get_b() != other_functions[ i ]->get_b() ) ||
+       ( functions[ i ]->get_A() != other_functions[ i ]->get_A() ) )
+    return( false );
+  }
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// removes all the rows of the given PolyhedralFunction
+ static void remove_rows( PolyhedralFunction * function ) {
+  if( const auto num_rows = function->get_nrows() ) {
+   Block::Subset rows( num_rows );
+   std::iota( rows.begin() , rows.end() , 0 );
+   function->delete_rows( std::move( rows ) );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ std::vector< std::pair< PolyhedralFunction::MultiVector ,
+                         PolyhedralFunction::RealVector > > v_cuts;
+ ///< the cuts (A and b) of each PolyhedralFunction
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class CutSet )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* CutSet.h included */
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- End File CutSet.h ----------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -0,0 +1,374 @@
+/*--------------------------------------------------------------------------*/
+/*----------------------- File NetCDFSolutionOutput.h ----------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of NetCDFSolutionOutput, a class for writing the solutions of
+ * (the UCBlocks of) an SDDPBlock into a single netCDF-4 file.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __NetCDFSolutionOutput
+#define __NetCDFSolutionOutput
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include "SDDPBlock.h"
+#include "SDDPBlockSolutionOutput.h"
+#include "UCBlockSolutionOutput.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <netcdf>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*---------------------- CLASS NetCDFSolutionOutput ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// writes the solutions of an SDDPBlock into a single netCDF-4 file
+/** The NetCDFSolutionOutput class writes the same data that
+ * UCBlockSolutionOutput writes into (many) CSV files, for every scenario and
+ * every stage, into a single netCDF-4 file. Each quantity (see
+ * UCBlockSolutionOutput::Table) is a variable whose name is the prefix of the
+ * name of the corresponding CSV file (e.g., "ActivePower" or "Flows") and
+ * whose dimensions are
+ *
+ *   ( scenario , stage , time , column )
+ *
+ * where "scenario" and "stage" are unlimited dimensions, "time" is the time
+ * horizon of the UCBlocks, and column is a dimension describing the columns
+ * of the quantity, e.g., "generator", "storage", "line", "node" or
+ * "primary_zone" (for the maximum pollutant emission constraints, the
+ * dimensions are "pollutant" and "pollutant_zone" instead of "time" and a
+ * column dimension). For each column dimension <dim>, the string variable
+ * <dim>_name( <dim> ) holds the names of the columns (see
+ * UCBlockSolutionOutput). The values that are not written are NaN.
+ *
+ * The scenarios are stored densely: the i-th scenario written into the file
+ * (in the order in which they are first written) has index i along the
+ * "scenario" dimension, and the coordinate variable scenario( scenario )
+ * holds its actual index. Hence, a file in which only some of the scenarios
+ * are written (e.g., by an MPI process, or with a sample of the scenarios)
+ * has no row for the others.
+ *
+ * The size of the "time" and column dimensions is given by the first UCBlock
+ * that is written: all UCBlocks are supposed to have the same structure (and
+ * an exception is thrown if a UCBlock has more rows or columns). Every
+ * variable is chunked by ( scenario , stage ), so that the solution of a
+ * scenario at a stage can be read (or written) at once, and compressed with
+ * the given deflate level.
+ *
+ * Since netCDF is not thread-safe, a NetCDFSolutionOutput must not be used
+ * concurrently by different threads. */
+
+class NetCDFSolutionOutput {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ NetCDFSolutionOutput() = default;
+
+/*--------------------------------------------------------------------------*/
+
+ /// creates the file with the given name (see open())
+ explicit NetCDFSolutionOutput( const std::string & filename ,
+                                int deflate_level = 4 )
+  : deflate_level( deflate_level ) {
+  open( filename );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ NetCDFSolutionOutput( const NetCDFSolutionOutput & ) = delete;
+
+ NetCDFSolutionOutput & operator=( const NetCDFSolutionOutput & ) = delete;
+
+/*--------------------------------------------------------------------------*/
+
+ /// creates the file with the given name
+ /** Creates the netCDF-4 file with the given name, replacing it if it
+  * already exists. A std::runtime_error is thrown if the file cannot be
+  * created. */
+
+ void open( const std::string & filename ) {
+  close();
+  try {
+   file.open( filename , netCDF::NcFile::replace , netCDF::NcFile::nc4 );
+  }
+  catch( netCDF::exceptions::NcException & e ) {
+   throw( std::runtime_error( "NetCDFSolutionOutput: it was not possible to "
+                              "create the file \"" + filename + "\": " +
+                              e.what() ) );
+  }
+  scenario_dimension = file.addDim( "scenario" );
+  stage_dimension = file.addDim( "stage" );
+  scenario_variable = file.addVar( "scenario" , netCDF::ncUint ,
+                                   scenario_dimension );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// closes the file (if it is open)
+ void close() {
+  if( file.isNull() )
+   return;
+  file.close();
+  dimensions.clear();
+  variables.clear();
+  scenario_indices.clear();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns true if and only if a file is open
+ bool is_open() const { return( ! file.isNull() ); }
+
+/*--------------------------------------------------------------------------*/
+
+ /// sets the deflate level (0, i.e., no compression, to 9) of new variables
+ void set_deflate_level( int deflate_level ) {
+  this->deflate_level = deflate_level;
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the solution of the given UCBlock for a scenario and a stage
+ void print( UCBlock * uc_block , Index scenario , Index stage ) {
+
+  if( file.isNull() )
+   throw( std::logic_error( "NetCDFSolutionOutput::print: the file is not "
+                            "open." ) );
+
+  solution_output.for_each_table
+   ( uc_block , [ this , scenario , stage ]
+     ( const UCBlockSolutionOutput::Table & table ) {
+     print( table , scenario , stage );
+    } );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the solution of the given SDDPBlock for a scenario
+ /** Writes the solution of the UCBlock of each stage of the given SDDPBlock
+  * (up to the one before \p fault_stage) for the given scenario. As for
+  * SDDPBlockSolutionOutput::print( block , scenario , append ), the
+  * solutions are written as they are currently found in the UCBlocks. */
+
+ void print( SDDPBlock * block , Index scenario ,
+             Index fault_stage = Inf< Index >() ) {
+  const auto num_stages = std::min( block->get_time_horizon() , fault_stage );
+  for( Index stage = 0 ; stage < num_stages ; ++stage )
+   print( SDDPBlockSolutionOutput::get_UCBlock( block , stage ) , scenario ,
+          stage );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the given snapshot of a solution
+ /** Writes the given Solution (see SDDPBlockSolutionOutput::snapshot()) for
+  * its scenario. The stages are the ones of its Tables. */
+
+ void print( const SDDPBlockSolutionOutput::Solution & solution ) {
+
+  if( file.isNull() )
+   throw( std::logic_error( "NetCDFSolutionOutput::print: the file is not "
+                            "open." ) );
+
+  for( Index i = 0 ; i < solution.number_tables ; ++i )
+   print( solution.tables[ i ] , solution.scenario , solution.stages[ i ] );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// returns the dimension with the given name and (at least) the given size
+ /** Returns the dimension with the given name, which is created with the
+  * given size if it does not exist yet. In this case, if \p names is not
+  * nullptr, the variable <name>_name holding the given names is also
+  * created. A std::logic_error is thrown if the dimension exists and is
+  * smaller than \p size. */
+
+ netCDF::NcDim get_dimension( const std::string & name , Index size ,
+                              const std::vector< std::string > * names ) {
+
+  auto it = dimensions.find( name );
+  if( it != dimensions.end() ) {
+   if( it->second.getSize() < size )
+    throw( std::logic_error( "NetCDFSolutionOutput: the size of the "
+                             "dimension \"" + name + "\" would be " +
+                             std::to_string( size ) + " but it is " +
+                             std::to_string( it->second.getSize() ) + "." ) );
+   return( it->second );
+  }
+
+  auto dimension = file.addDim( name , size );
+  dimensions.emplace( name , dimension );
+
+  if( names ) {
+   auto variable = file.addVar( name + "_name" , netCDF::ncString ,
+                                dimension );
+   for( Index i = 0 ; i < size ; ++i )
+    variable.putVar( { std::size_t( i ) } , ( *names )[ i ] );
+  }
+
+  return( dimension );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the variable for the given Table, which is created if needed
+ netCDF::NcVar get_variable( const UCBlockSolutionOutput::Table & table ) {
+
+  const auto name = solution_output.get_table_name( table );
+
+  auto it = variables.find( name );
+  if( it != variables.end() ) {
+   for( Index d = 2 ; d < 4 ; ++d ) {
+    const auto size = d == 2 ? table.rows : table.columns;
+    if( it->second.getDim( d ).getSize() < size )
+     throw( std::logic_error( "NetCDFSolutionOutput: the variable \"" + name
+                              + "\" has more values than the size of the "
+                              "dimension \"" + it->second.getDim( d ).getName()
+                              + "\"." ) );
+   }
+   return( it->second );
+  }
+
+  const auto row_dimension =
+   get_dimension( table.row_dimension , table.rows , nullptr );
+  const auto column_dimension =
+   get_dimension( table.column_dimension , table.columns ,
+                  table.column_names );
+
+  auto variable = file.addVar( name , netCDF::ncDouble ,
+                               { scenario_dimension , stage_dimension ,
+                                 row_dimension , column_dimension } );
+
+  std::vector< std::size_t > chunk_sizes = { 1 , 1 , row_dimension.getSize() ,
+                                             column_dimension.getSize() };
+  variable.setChunking( netCDF::NcVar::nc_CHUNKED , chunk_sizes );
+  if( deflate_level > 0 )
+   variable.setCompression( true , true , deflate_level );
+  variable.setFill( true , std::numeric_limits< double >::quiet_NaN() );
+
+  variables.emplace( name , variable );
+  return( variable );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the index of the given scenario in the file
+ /** Returns the index along the "scenario" dimension of the given scenario,
+  * which is given the next index (and written into the coordinate variable)
+  * if it has not been written yet. */
+
+ std::size_t get_scenario_index( Index scenario ) {
+  const auto [ it , inserted ] =
+   scenario_indices.emplace( scenario , scenario_indices.size() );
+  if( inserted )
+   scenario_variable.putVar( { it->second } , scenario );
+  return( it->second );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ void print( const UCBlockSolutionOutput::Table & table , Index scenario ,
+             Index stage ) {
+
+  // A quantity that is not defined (or empty) is not written, since a
+  // dimension of size 0 would be unlimited.
+
+  if( ( ! table.column_names ) || ( table.rows == 0 ) ||
+      ( table.columns == 0 ) )
+   return;
+
+  auto variable = get_variable( table );
+
+  variable.putVar( { get_scenario_index( scenario ) , std::size_t( stage ) ,
+                     0 , 0 } ,
+                   { 1 , 1 , std::size_t( table.rows ) ,
+                     std::size_t( table.columns ) } ,
+                   table.values.data() );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ netCDF::NcFile file;                         ///< the file being written
+
+ netCDF::NcDim scenario_dimension;            ///< the scenario dimension
+
+ netCDF::NcDim stage_dimension;               ///< the stage dimension
+
+ netCDF::NcVar scenario_variable;             ///< the indices of the scenarios
+
+ std::map< Index , std::size_t > scenario_indices;
+ ///< the index in the file of each scenario written into it
+
+ std::map< std::string , netCDF::NcDim > dimensions;
+ ///< the other dimensions, by name
+
+ std::map< std::string , netCDF::NcVar > variables;
+ ///< the variables of the quantities, by name
+
+ int deflate_level = 4;                       ///< the deflate level
+
+ UCBlockSolutionOutput solution_output;       ///< provides the Tables
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class NetCDFSolutionOutput )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* NetCDFSolutionOutput.h included */
+
+/*--------------------------------------------------------------------------*/
+/*-------------------- End File NetCDFSolutionOutput.h ---------------------*/
+/*--------------------------------------------------------------------------*/
@@ -0,0 +1,371 @@
+/*--------------------------------------------------------------------------*/
+/*------------------------- File ParameterSweep.h --------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of ParameterSweep, a class that generates in memory the
+ * variants of a set of configuration files in which some parameters are
+ * given different values, like chgcfg does on file.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __ParameterSweep
+#define __ParameterSweep
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ CLASS ParameterSweep ----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// the variants of a set of configuration files for a parameter study
+/** The ParameterSweep class reads a grid from a text file in which every
+ * line (after removing the comments, which start with '#') is either empty
+ * or has the form
+ *
+ *     <configuration file> <parameter> <value_1> [ <value_2> ... ]
+ *
+ * Each line is an axis of the grid and the variants are all the
+ * combinations of the values of the axes: variant v gives to the parameter
+ * of axis i the value of index v_i, where v is written in the mixed radix
+ * given by the number of values of the axes and the last axis varies
+ * fastest. Hence, variant 0 takes the first value of every axis.
+ *
+ * The text of a configuration file in a variant (see get_text()) is
+ * obtained with the rules of chgcfg (in its BAREBONES form): comments and
+ * leading whitespaces are removed, and the first line whose first token is
+ * the name of a parameter is replaced by "<parameter>   <value>". Each axis
+ * replaces a single line, so a parameter occurring many times in a file can
+ * be changed by giving as many axes for it, in order. Unlike chgcfg, the
+ * names are never looked for in the comments, a name must be the whole first
+ * token of a line (so that, e.g., "intLogVerb" does not match the line of
+ * "intLogVerbosity"), and every parameter must be found; this is checked by
+ * load(). */
+
+class ParameterSweep {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// the name of a parameter and the value it must be given
+ using Override = std::pair< std::string , std::string >;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// reads the grid in the file with the given name
+ /** Reads the grid in the file with the given name and the configuration
+  * files it refers to. A std::runtime_error is thrown if a file cannot be
+  * read, and a std::logic_error if the grid is not valid or a parameter is
+  * not found in its configuration file. */
+
+ void load( const std::string & filename ) {
+  std::ifstream file( filename );
+  if( ! file.is_open() )
+   throw( std::runtime_error( "ParameterSweep: the file " + filename +
+                              " could not be opened." ) );
+  axes.clear();
+  filenames.clear();
+  texts.clear();
+
+  std::string line;
+  for( unsigned long n = 1 ; std::getline( file , line ) ; ++n ) {
+   line.erase( std::find( line.begin() , line.end() , '#' ) , line.end() );
+   std::istringstream tokens( line );
+
+   Axis axis;
+   std::string config_filename;
+   if( ! ( tokens >> config_filename ) )
+    continue;  // empty line
+
+   tokens >> axis.parameter;
+   for( std::string value ; tokens >> value ; )
+    axis.values.push_back( value );
+
+   if( axis.values.empty() )
+    throw( std::logic_error( "ParameterSweep: line " + std::to_string( n ) +
+                             " of " + filename + " must contain a "
+                             "configuration file, a parameter and at "
+                             "least one value." ) );
+
+   axis.file = std::find( filenames.begin() , filenames.end() ,
+                          config_filename ) - filenames.begin();
+   if( axis.file == filenames.size() )
+    filenames.push_back( config_filename );
+
+   axes.push_back( std::move( axis ) );
+  }
+
+  if( file.bad() )
+   throw( std::runtime_error( "ParameterSweep: error while reading the file "
+                              + filename + "." ) );
+
+  if( axes.empty() )
+   throw( std::logic_error( "ParameterSweep: the file " + filename +
+                            " contains no parameter." ) );
+
+  for( const auto & config_filename : filenames ) {
+   std::ifstream config_file( config_filename );
+   if( ! config_file.is_open() )
+    throw( std::runtime_error( "ParameterSweep: the configuration file " +
+                               config_filename + " could not be opened." ) );
+   std::ostringstream text;
+   text << config_file.rdbuf();
+   texts.push_back( text.str() );
+  }
+
+  // check that every parameter is found (in every variant, the same lines
+  // are replaced)
+  for( const auto & config_filename : filenames )
+   get_text( config_filename , 0 );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of variants
+ unsigned long get_number_variants() const {
+  unsigned long number_variants = 1;
+  for( const auto & axis : axes )
+   number_variants *= axis.values.size();
+  return( number_variants );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the names of the configuration files, as given in the grid
+ const std::vector< std::string > & get_filenames() const {
+  return( filenames );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether the grid changes the configuration file with that name
+ bool has_file( const std::string & filename ) const {
+  return( find_file( filename ) < filenames.size() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the parameters of the given file changed by the given variant
+ /** Returns the pairs < parameter , value > of the axes of the given
+  * configuration file in the given variant, in the order of the grid. */
+
+ std::vector< Override > get_overrides( const std::string & filename ,
+                                        unsigned long variant ) const {
+  const auto file = find_file( filename );
+  const auto indices = get_value_indices( variant );
+  std::vector< Override > overrides;
+  for( unsigned long i = 0 ; i < axes.size() ; ++i )
+   if( axes[ i ].file == file )
+    overrides.emplace_back( axes[ i ].parameter ,
+                            axes[ i ].values[ indices[ i ] ] );
+  return( overrides );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the text of the given configuration file in the given variant
+ /** Returns the text of the given configuration file (one of those in the
+  * grid, see has_file()) in which the parameters are given the values of
+  * the given variant. A std::logic_error is thrown if some parameter is not
+  * found in the file. */
+
+ std::string get_text( const std::string & filename ,
+                       unsigned long variant ) const {
+  const auto file = find_file( filename );
+  if( file == filenames.size() )
+   throw( std::logic_error( "ParameterSweep::get_text: the grid does not "
+                            "change the configuration file " + filename +
+                            "." ) );
+  std::istringstream input( texts[ file ] );
+  try {
+   return( override( input , get_overrides( filename , variant ) ) );
+  }
+  catch( const std::logic_error & e ) {
+   throw( std::logic_error( e.what() + std::string( " in " ) +
+                            filenames[ file ] + "." ) );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns a description of the given variant
+ /** Returns a line of the form "<file>: <parameter> = <value>, ..." with
+  * the value of every axis in the given variant. */
+
+ std::string get_description( unsigned long variant ) const {
+  const auto indices = get_value_indices( variant );
+  std::string description;
+  for( unsigned long i = 0 ; i < axes.size() ; ++i ) {
+   if( i > 0 )
+    description += ", ";
+   description += filenames[ axes[ i ].file ] + ": " +
+    axes[ i ].parameter + " = " + axes[ i ].values[ indices[ i ] ];
+  }
+  return( description );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the given text with the given parameters replaced
+ /** Applies the given overrides to the configuration text read from
+  * \p input with the rules of chgcfg (see the general notes of the class)
+  * and returns the result. A std::logic_error is thrown if some parameter
+  * is not found. */
+
+ static std::string override( std::istream & input ,
+                              std::vector< Override > overrides ) {
+  std::ostringstream output;
+  std::string line;
+  while( std::getline( input , line ) ) {
+   line.erase( std::find( line.begin() , line.end() , '#' ) , line.end() );
+   line.erase( line.begin() , std::find_if_not
+               ( line.begin() , line.end() ,
+                 []( unsigned char c ) { return( std::isspace( c ) ); } ) );
+
+   // the name of a parameter is the first token of its line
+   const std::string name( line.begin() , std::find_if
+                           ( line.begin() , line.end() ,
+                             []( unsigned char c ) {
+                              return( std::isspace( c ) ); } ) );
+
+   auto it = std::find_if( overrides.begin() , overrides.end() ,
+                           [ & name ]( const Override & o ) {
+                            return( o.first == name );
+                           } );
+
+   if( line.empty() || ( it == overrides.end() ) )
+    output << line << '\n';
+   else {
+    output << it->first << "   " << it->second << '\n';
+    overrides.erase( it );
+   }
+  }
+
+  if( ! overrides.empty() )
+   throw( std::logic_error( "ParameterSweep: the parameter " +
+                            overrides.front().first + " was not found" ) );
+
+  return( output.str() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// tells whether the two given names refer to the same file
+ /** Two names refer to the same file if they are equal or if they are the
+  * names of the same existing file (possibly through different paths). An
+  * empty name never refers to a file. */
+
+ static bool same_file( const std::string & a , const std::string & b ) {
+  if( a.empty() || b.empty() )
+   return( false );
+  if( a == b )
+   return( true );
+  std::error_code error;
+  return( std::filesystem::equivalent( a , b , error ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE TYPES -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// a line of the grid
+ struct Axis {
+  unsigned long file;                 ///< index of the configuration file
+  std::string parameter;              ///< name of the parameter
+  std::vector< std::string > values;  ///< values of the parameter
+ };
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// returns the index of the given file (filenames.size() if not found)
+ unsigned long find_file( const std::string & filename ) const {
+  unsigned long file = 0;
+  while( ( file < filenames.size() ) &&
+         ( ! same_file( filenames[ file ] , filename ) ) )
+   ++file;
+  return( file );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the index of the value of each axis in the given variant
+ std::vector< unsigned long > get_value_indices( unsigned long variant )
+  const {
+  if( variant >= get_number_variants() )
+   throw( std::logic_error( "ParameterSweep: invalid variant " +
+                            std::to_string( variant ) + "." ) );
+
+  std::vector< unsigned long > indices( axes.size() );
+  for( auto i = axes.size() ; i-- > 0 ; ) {
+   indices[ i ] = variant % axes[ i ].values.size();
+   variant /= axes[ i ].values.size();
+  }
+  return( indices );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ std::vector< Axis > axes;
+ ///< the lines of the grid
+
+ std::vector< std::string > filenames;
+ ///< the names of the configuration files, in order of first appearance
+
+ std::vector< std::string > texts;
+ ///< the original text of each configuration file
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class ParameterSweep )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* ParameterSweep.h included */
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- End File ParameterSweep.h ------------------------*/
+/*--------------------------------------------------------------------------*/
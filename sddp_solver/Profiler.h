@@ -0,0 +1,384 @@
+/*--------------------------------------------------------------------------*/
+/*---------------------------- File Profiler.h -----------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of Profiler, a lightweight collector of timings and counters
+ * for the phases of the tools.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __Profiler
+#define __Profiler
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- CLASS Profiler ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// a lightweight collector of timings and counters
+/** The Profiler class collects, for each thread, the time spent in named
+ * phases (by means of ScopedTimer) and the values of named counters (by
+ * means of count()), possibly associated with a scenario. For each thread,
+ * name and scenario, the number of records, their sum and their maximum
+ * are kept; write_report() writes them into a CSV or a JSON file.
+ *
+ * The Profiler is disabled by default, in which case a ScopedTimer or a
+ * call to count() costs a single (relaxed) atomic load: no clock is read
+ * and nothing is recorded. When it is enabled, each thread records into its
+ * own data, so that no synchronization is needed except when a thread
+ * records for the first time and when it exits. The data of a thread that
+ * exits is kept, and it is given to the next thread that records for the
+ * first time: the records of the threads that never run at the same time
+ * are hence merged, and the memory used by the Profiler is bounded by the
+ * largest number of threads that have recorded at the same time, however
+ * many threads are created (e.g., by successive OpenMP parallel regions
+ * with a different number of threads).
+ *
+ * The names must be string literals (or have static storage duration),
+ * since they are not copied. The data must not be reset or reported while
+ * some thread is recording. */
+
+class Profiler {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// the value of the scenario of the records that are not associated with one
+ static constexpr long no_scenario = -1;
+
+/*--------------------------------------------------------------------------*/
+
+ /// records the time elapsed between its construction and its destruction
+ /** A ScopedTimer records, when it is destroyed or stopped, the time (in
+  * seconds) elapsed since its construction under the given name and
+  * scenario. Nothing is done if the Profiler is disabled when the
+  * ScopedTimer is constructed. */
+
+ class ScopedTimer {
+
+ public:
+
+  explicit ScopedTimer( const char * name , long scenario = no_scenario )
+   : name( name ) , scenario( scenario ) , running( is_enabled() ) {
+   if( running )
+    start = std::chrono::steady_clock::now();
+  }
+
+  ScopedTimer( const ScopedTimer & ) = delete;
+
+  ScopedTimer & operator=( const ScopedTimer & ) = delete;
+
+  ~ScopedTimer() { stop(); }
+
+  /// records the time elapsed so far (only the first time it is called)
+  void stop() {
+   if( ! running )
+    return;
+   running = false;
+   const std::chrono::duration< double > elapsed =
+    std::chrono::steady_clock::now() - start;
+   record( timers , name , scenario , elapsed.count() );
+  }
+
+ private:
+
+  const char * name;                              ///< the name of the phase
+
+  long scenario;                                  ///< the scenario
+
+  bool running;                                   ///< whether it is timing
+
+  std::chrono::steady_clock::time_point start;    ///< the starting time
+ };
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// enables (or disables) the Profiler
+ static void enable( bool enable = true ) {
+  enabled.store( enable , std::memory_order_relaxed );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns true if and only if the Profiler is enabled
+ static bool is_enabled() {
+  return( enabled.load( std::memory_order_relaxed ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// records the given value of the counter with the given name
+ static void count( const char * name , double value = 1 ,
+                    long scenario = no_scenario ) {
+  if( is_enabled() )
+   record( counters , name , scenario , value );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// discards all records
+ static void reset() {
+  std::lock_guard< std::mutex > lock( get_mutex() );
+  for( auto & data : get_thread_data() )
+   for( auto & records : data->records )
+    records.clear();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the records into the file with the given name
+ /** Writes the records of all threads into the file with the given name.
+  * If its extension is ".json", the file contains a JSON object with the
+  * arrays "timers" and "counters"; otherwise, it is a CSV file with the
+  * columns
+  *
+  *   kind , name , thread , scenario , count , total , max
+  *
+  * where kind is either "timer" (total and max being in seconds) or
+  * "counter", and scenario is empty for the records that are not
+  * associated with a scenario. The thread is the index of the data into
+  * which the thread has recorded (see the general notes of the class): the
+  * data are numbered in the order in which they were created, and the
+  * threads that never ran at the same time may share the same number. A
+  * std::runtime_error is thrown if the file cannot be opened. */
+
+ static void write_report( const std::string & filename ) {
+
+  std::ofstream output( filename , std::ios::out );
+  if( ! output.is_open() )
+   throw( std::runtime_error( "Profiler::write_report: it was not possible "
+                              "to open the file \"" + filename + "\"." ) );
+
+  output.precision( 17 );
+
+  const bool json = std::filesystem::path( filename ).extension() == ".json";
+
+  std::lock_guard< std::mutex > lock( get_mutex() );
+  const auto & thread_data = get_thread_data();
+
+  if( ! json )
+   output << "kind,name,thread,scenario,count,total,max\n";
+  else
+   output << "{\n";
+
+  for( const auto kind : { timers , counters } ) {
+
+   const char * kind_name = ( kind == timers ) ? "timer" : "counter";
+
+   if( json )
+    output << ( kind == timers ? "" : ",\n" ) << " \"" << kind_name
+           << "s\": [";
+
+   bool first = true;
+   for( std::size_t t = 0 ; t < thread_data.size() ; ++t ) {
+    for( const auto & [ key , statistics ] :
+          thread_data[ t ]->records[ kind ] ) {
+
+     if( json ) {
+      output << ( first ? "\n" : ",\n" ) << "  { \"name\": \"" << key.first
+             << "\", \"thread\": " << t;
+      if( key.second != no_scenario )
+       output << ", \"scenario\": " << key.second;
+      output << ", \"count\": " << statistics.count << ", \"total\": "
+             << statistics.total << ", \"max\": " << statistics.max << " }";
+     }
+     else {
+      output << kind_name << ',' << key.first << ',' << t << ',';
+      if( key.second != no_scenario )
+       output << key.second;
+      output << ',' << statistics.count << ',' << statistics.total << ','
+             << statistics.max << '\n';
+     }
+     first = false;
+    }
+   }
+
+   if( json )
+    output << ( first ? "]" : "\n ]" );
+  }
+
+  if( json )
+   output << "\n}\n";
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of thread data (see the general notes of the class)
+ static std::size_t get_number_thread_data() {
+  std::lock_guard< std::mutex > lock( get_mutex() );
+  return( get_thread_data().size() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the name of the report of a process
+ /** Returns the given name if \p size is 1; otherwise, "_<rank>" is
+  * appended to its stem, so that each of the \p size processes writes its
+  * own report (e.g., "profile.json" becomes "profile_1.json" for the
+  * process of rank 1). */
+
+ static std::string get_filename( const std::string & filename , int rank ,
+                                  int size ) {
+  if( size <= 1 )
+   return( filename );
+  std::filesystem::path path( filename );
+  auto name = path.stem();
+  name += "_" + std::to_string( rank );
+  name += path.extension();
+  path.replace_filename( name );
+  return( path.string() );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE TYPES -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ enum kind_type { timers = 0 , counters = 1 , number_kinds };
+
+ /// the statistics of the records with the same name and scenario
+ struct Statistics {
+  unsigned long count = 0;          ///< the number of records
+  double total = 0;                 ///< the sum of the recorded values
+  double max = 0;                   ///< the largest recorded value
+ };
+
+ using Key = std::pair< std::string_view , long >;
+
+ /// the records of a thread
+ struct ThreadData {
+  std::map< Key , Statistics > records[ number_kinds ];
+  ///< the statistics of the timers and of the counters, by name and scenario
+
+  bool in_use = false;
+  ///< whether some (running) thread is recording into this data
+ };
+
+ /// gives the data of a thread back when the thread exits
+ struct ThreadSlot {
+  ThreadData * data = nullptr;    ///< the data of the thread
+
+  ~ThreadSlot() {
+   if( ! data )
+    return;
+   std::lock_guard< std::mutex > lock( get_mutex() );
+   data->in_use = false;
+  }
+ };
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ static std::mutex & get_mutex() {
+  static std::mutex mutex;
+  return( mutex );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ static std::vector< std::unique_ptr< ThreadData > > & get_thread_data() {
+  static std::vector< std::unique_ptr< ThreadData > > thread_data;
+  return( thread_data );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the data of the calling thread, which is taken if needed
+ /** The first time a thread records, it takes the first data that is not in
+  * use by another thread, or a new one if they are all in use. */
+
+ static ThreadData & get_this_thread_data() {
+  thread_local ThreadSlot slot;
+  if( ! slot.data ) {
+   std::lock_guard< std::mutex > lock( get_mutex() );
+   auto & thread_data = get_thread_data();
+   auto it = std::find_if( thread_data.begin() , thread_data.end() ,
+                           []( const auto & data ) {
+                            return( ! data->in_use );
+                           } );
+   if( it == thread_data.end() ) {
+    thread_data.push_back( std::make_unique< ThreadData >() );
+    it = std::prev( thread_data.end() );
+   }
+   ( *it )->in_use = true;
+   slot.data = it->get();
+  }
+  return( *slot.data );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ static void record( kind_type kind , const char * name , long scenario ,
+                     double value ) {
+  auto & statistics =
+   get_this_thread_data().records[ kind ][ Key( name , scenario ) ];
+  ++statistics.count;
+  statistics.total += value;
+  statistics.max = ( statistics.count == 1 ) ? value :
+   std::max( statistics.max , value );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ inline static std::atomic< bool > enabled{ false };
+ ///< whether the Profiler is enabled
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class Profiler )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* Profiler.h included */
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- End File Profiler.h ---------------------------*/
+/*--------------------------------------------------------------------------*/
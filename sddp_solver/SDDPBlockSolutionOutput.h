@@ -21,12 +21,15 @@
 /*------------------------------ INCLUDES ----------------------------------*/
 /*--------------------------------------------------------------------------*/
 
+#include "CutArchive.h"
 #include "SDDPBlock.h"
 #include "StochasticBlock.h"
 #include "UCBlockSolutionOutput.h"
 
+#include <deque>
 #include <iomanip>
 #include <iostream>
+#include <map>
 
 /*--------------------------------------------------------------------------*/
 /*--------------------------- NAMESPACE ------------------------------------*/
@@ -38,6 +41,18 @@ using namespace SMSpp_di_unipi_it;
 /*--------------------- CLASS SDDPBlockSolutionOutput ----------------------*/
 /*--------------------------------------------------------------------------*/
 
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// outputs the solutions and the cuts of an SDDPBlock
+/** The SDDPBlockSolutionOutput class outputs the solutions of the UCBlocks
+ * of the stages of an SDDPBlock into CSV files (see UCBlockSolutionOutput),
+ * possibly through a snapshot (see Solution), and the cuts of its
+ * PolyhedralFunctions. The same UCBlockSolutionOutput is used by every call,
+ * so that the memory of its buffer and the names of the columns it caches
+ * are reused: an SDDPBlockSolutionOutput is hence meant to be used for a
+ * single SDDPBlock (or SDDPBlocks with the same structure, such as its
+ * replicas), and by a single thread at a time. */
+
 class SDDPBlockSolutionOutput {
 
 /*--------------------------------------------------------------------------*/
@@ -52,19 +67,79 @@ public:
 
  using Index = Block::Index;
 
+/*--------------------------------------------------------------------------*/
+
+ /// a snapshot of the solution of an SDDPBlock for a scenario
+ /** A Solution holds a copy of the Tables (see UCBlockSolutionOutput) of the
+  * UCBlocks of all stages of an SDDPBlock, as obtained by snapshot(), so
+  * that they can be output once the SDDPBlock is being used for something
+  * else. The names of the columns of the Tables are also copied. Only the
+  * first #number_tables Tables are meaningful: the others are kept so that
+  * their memory is reused when a Solution is filled again. */
+
+ struct Solution {
+
+  Solution() = default;
+
+  Solution( const Solution & ) = delete;  ///< the names would be shared
+
+  Solution & operator=( const Solution & ) = delete;
+
+  Solution( Solution && ) = default;
+
+  Solution & operator=( Solution && ) = default;
+
+  Index scenario = 0;                 ///< the scenario
+  Index number_tables = 0;            ///< the number of Tables
+  std::vector< Index > stages;        ///< the stage of each Table
+  std::vector< UCBlockSolutionOutput::Table > tables; ///< the Tables
+  std::deque< std::vector< std::string > > names;
+  ///< the names of the columns the Tables point to
+ };
+
 /*--------------------------------------------------------------------------*/
 /*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
 /*--------------------------------------------------------------------------*/
 
+ /// prints the cuts of the given SDDPBlock
+ /** Prints the cuts of the given SDDPBlock into the file with the given
+  * name. If this name has the extension of a CutArchive (see
+  * CutArchive::has_archive_extension()), the cuts are written in binary
+  * format by CutArchive::write(); otherwise, a CSV file is written. */
+
  void print_cuts( SDDPBlock * block , const std::string & filename ) const {
 
   if( block->get_polyhedral_functions().empty() )
    return;
 
+  std::vector< PolyhedralFunction * > functions( block->get_time_horizon() );
+  for( Index stage = 0 ; stage < functions.size() ; ++stage )
+   functions[ stage ] = block->get_polyhedral_function( stage );
+
+  print_cuts( functions , filename );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// prints the cuts of the given PolyhedralFunction
+ /** Prints the cuts of the given PolyhedralFunction, the i-th of which is
+  * that of stage i, into the file with the given name, in the same format
+  * as print_cuts( SDDPBlock * , const std::string & ). */
+
+ void print_cuts( const std::vector< PolyhedralFunction * > & functions ,
+                  const std::string & filename ) const {
+
+  if( functions.empty() )
+   return;
+
+  if( CutArchive::has_archive_extension( filename ) ) {
+   CutArchive::write( functions , filename );
+   return;
+  }
+
   std::ofstream output( filename , std::ios::out );
 
-  const auto num_var =
-   block->get_polyhedral_functions().front()->get_num_active_var();
+  const auto num_var = functions.front()->get_num_active_var();
 
   output << "Timestep";
   for( Index i = 0 ; i < num_var ; ++i ) {
@@ -72,10 +147,10 @@ public:
   }
   output << separator_character << "b" << std::endl;
 
-  for( Index stage = 0 ; stage < block->get_time_horizon() ; ++stage ) {
+  for( Index stage = 0 ; stage < functions.size() ; ++stage ) {
 
-   const auto & b = block->get_polyhedral_function( stage )->get_b();
-   const auto & A = block->get_polyhedral_function( stage )->get_A();
+   const auto & b = functions[ stage ]->get_b();
+   const auto & A = functions[ stage ]->get_A();
 
    assert( b.size() == A.size() );
 
@@ -95,7 +170,7 @@ public:
 
  void print( SDDPBlock * block , Index fault_stage = Inf< Index >() ) const {
 
-  UCBlockSolutionOutput solution_output;
+  solution_output.reset_settings();
   solution_output.set_separator_character( separator_character );
 
   Index initial_time = 0;
@@ -103,26 +178,9 @@ public:
   for( Index stage = 0 ;
        stage < std::min( block->get_time_horizon() , fault_stage ) ; ++stage ) {
 
-   auto benders_block = static_cast< BendersBlock * >
-    ( static_cast< StochasticBlock * >( block->get_sub_Block( stage ) )->
-      get_nested_Blocks().front() );
-
-   auto objective = static_cast< FRealObjective * >
-    ( benders_block->get_objective() );
-
-   auto benders_function = static_cast< BendersBFunction * >
-    ( objective->get_function() );
-
-   auto uc_block = static_cast< UCBlock * >
-    ( benders_function->get_inner_block() );
+   get_solution( block , stage );
 
-   if( auto solver = benders_function->get_solver() ) {
-    if( solver->has_var_solution() )
-     solver->get_var_solution();
-    if( auto cda_solver = dynamic_cast< CDASolver * >( solver ) )
-     if( cda_solver->has_dual_solution() )
-      cda_solver->get_dual_solution();
-   }
+   auto uc_block = get_UCBlock( block , stage );
 
    solution_output.print( uc_block );
 
@@ -149,11 +207,37 @@ public:
   return( static_cast< UCBlock * >( benders_function->get_inner_block() ) );
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// loads the solution of the UCBlock of the given stage
+ /** Makes the Solver of the BendersBFunction of the given stage write its
+  * primal (and, if available, dual) solution into the UCBlock. */
+
+ static void get_solution( const SDDPBlock * sddp_block , Index stage ) {
+  auto benders_block = static_cast< BendersBlock * >
+   ( static_cast< StochasticBlock * >( sddp_block->get_sub_Block( stage ) )->
+     get_nested_Blocks().front() );
+
+  auto objective = static_cast< FRealObjective * >
+   ( benders_block->get_objective() );
+
+  auto benders_function = static_cast< BendersBFunction * >
+   ( objective->get_function() );
+
+  if( auto solver = benders_function->get_solver() ) {
+   if( solver->has_var_solution() )
+    solver->get_var_solution();
+   if( auto cda_solver = dynamic_cast< CDASolver * >( solver ) )
+    if( cda_solver->has_dual_solution() )
+     cda_solver->get_dual_solution();
+  }
+ }
+
 /*--------------------------------------------------------------------------*/
 
  void print( SDDPBlock * block , Index scenario , bool append ) const {
 
-  UCBlockSolutionOutput solution_output;
+  solution_output.reset_settings();
   solution_output.set_separator_character( separator_character );
 
   Index initial_inner_time = 0;
@@ -182,6 +266,84 @@ public:
   }
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// takes a snapshot of the solution of the given SDDPBlock for a scenario
+ /** Copies into \p solution the data that print( block , scenario , true )
+  * would output for the given \p scenario, as it is currently found in the
+  * UCBlocks of the given SDDPBlock. The memory of \p solution is reused. */
+
+ void snapshot( SDDPBlock * block , Index scenario ,
+                Solution & solution ) const {
+
+  solution_output.reset_settings();
+
+  solution.scenario = scenario;
+  solution.number_tables = 0;
+  solution.names.clear();
+
+  // The copy of the last names seen at each address. The names at an
+  // address change when the number of columns of a kind changes (e.g., the
+  // number of zones), in which case they are copied again.
+  std::map< const std::vector< std::string > * ,
+            const std::vector< std::string > * > copies;
+
+  Index initial_inner_time = 0;
+
+  for( Index stage = 0 ; stage < block->get_time_horizon() ; ++stage ) {
+
+   auto uc_block = get_UCBlock( block , stage );
+
+   solution_output.set_append( stage > 0 );
+   solution_output.set_initial_time( initial_inner_time );
+
+   solution_output.for_each_table
+    ( uc_block , [ & solution , & copies , stage ]
+      ( const UCBlockSolutionOutput::Table & table ) {
+
+      if( solution.number_tables == solution.tables.size() ) {
+       solution.tables.emplace_back();
+       solution.stages.emplace_back();
+      }
+
+      auto & copy = solution.tables[ solution.number_tables ];
+      solution.stages[ solution.number_tables ] = stage;
+      ++solution.number_tables;
+
+      copy = table;
+      if( table.column_names ) {
+       auto & names = copies[ table.column_names ];
+       if( ( ! names ) || ( *names != *table.column_names ) ) {
+        solution.names.push_back( *table.column_names );
+        names = & solution.names.back();
+       }
+       copy.column_names = names;
+      }
+     } );
+
+   initial_inner_time += uc_block->get_time_horizon();
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// prints the given Solution
+ /** Prints the given Solution (see snapshot()) into the same CSV files that
+  * print( block , solution.scenario , true ) would print. */
+
+ void print( const Solution & solution ) const {
+
+  solution_output.reset_settings();
+  solution_output.set_separator_character( separator_character );
+  solution_output.set_filenames_suffix
+   ( get_filename_suffix( solution.scenario ) );
+
+  for( Index i = 0 ; i < solution.number_tables ; ++i ) {
+   solution_output.set_append( solution.stages[ i ] > 0 );
+   solution_output.print( solution.tables[ i ] );
+  }
+ }
+
 /*--------------------------------------------------------------------------*/
 
  void set_separator_character( char separator_character ) {
@@ -247,6 +409,12 @@ private:
 
  char separator_character = ',';
 
+ /// the UCBlockSolutionOutput used by the print() and snapshot() methods
+ /** It is kept from one call to the next, so that the memory of its buffer
+  * and the names of the columns it caches are reused. */
+
+ mutable UCBlockSolutionOutput solution_output;
+
 /*--------------------------------------------------------------------------*/
 /*--------------------------------------------------------------------------*/
 
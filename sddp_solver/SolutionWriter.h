@@ -0,0 +1,320 @@
+/*--------------------------------------------------------------------------*/
+/*------------------------- File SolutionWriter.h --------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of SolutionWriter, a class that outputs snapshots of the
+ * solutions of an SDDPBlock in a background thread.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __SolutionWriter
+#define __SolutionWriter
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include "SDDPBlockSolutionOutput.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- CLASS SolutionWriter --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// outputs snapshots of the solutions of an SDDPBlock in a background thread
+/** The SolutionWriter class decouples taking the solution of an SDDPBlock
+ * from writing it. A thread that has solved a scenario takes a snapshot of
+ * the solution (see SDDPBlockSolutionOutput::snapshot()) into a Solution
+ * obtained by take(), and hands it over with push(), so that the SDDPBlock
+ * can be used by someone else right away. A single background thread then
+ * writes the Solutions, in the order in which they have been pushed, with
+ * the given function (e.g., into CSV files or into a netCDF file, which
+ * therefore never has to be written by more than one thread at a time).
+ *
+ * The memory is bounded: at most a given number of Solutions can be waiting
+ * to be written, and push() suspends the calling thread until the writer
+ * has caught up if this number has been reached. The Solutions that have
+ * been written are kept (up to the same number) to be handed out again by
+ * take(), so that their memory is reused.
+ *
+ * A SolutionWriter can be used for many batches of Solutions (e.g., one for
+ * each evaluation of a function): flush() waits until the Solutions pushed
+ * so far have been written, leaving the background thread (and the
+ * Solutions to be reused) in place for the next batch.
+ *
+ * If the function that writes a Solution throws an exception, the
+ * following Solutions (up to the next call to flush() or close()) are
+ * discarded and the exception is rethrown by flush() or close(). */
+
+class SolutionWriter {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+ using Solution = SDDPBlockSolutionOutput::Solution;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// starts the thread that writes the Solutions with the given function
+ /** Starts the background thread, which writes each pushed Solution by
+  * calling \p write. At most \p capacity (at least 1) Solutions can be
+  * waiting to be written. */
+
+ SolutionWriter( std::function< void( const Solution & ) > write ,
+                 Index capacity )
+  : write( std::move( write ) ) ,
+    capacity( std::max< Index >( capacity , 1 ) ) {
+  thread = std::thread( [ this ]() { run(); } );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ SolutionWriter( const SolutionWriter & ) = delete;
+
+ SolutionWriter & operator=( const SolutionWriter & ) = delete;
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the remaining Solutions and stops the background thread
+ ~SolutionWriter() {
+  try {
+   close();
+  }
+  catch( ... ) {}
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns a Solution to be filled and pushed
+ /** Returns a Solution that has already been written, if any, so that its
+  * memory is reused, or a new one. This function is thread-safe. */
+
+ Solution take() {
+  std::lock_guard< std::mutex > lock( mutex );
+  if( free_solutions.empty() )
+   return( Solution() );
+  auto solution = std::move( free_solutions.back() );
+  free_solutions.pop_back();
+  return( solution );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// hands the given Solution over to the background thread
+ /** Appends the given Solution to the ones waiting to be written. If the
+  * maximum number of them has been reached, the calling thread is suspended
+  * until the background thread has written one. If the writing has failed,
+  * the Solution is discarded. This function is thread-safe. */
+
+ void push( Solution && solution ) {
+  {
+   std::unique_lock< std::mutex > lock( mutex );
+   if( queue.size() >= capacity ) {
+    ++number_waits;
+    not_full.wait( lock , [ this ]() {
+     return( ( queue.size() < capacity ) || error );
+    } );
+   }
+   if( error || closing )
+    return;
+   queue.push_back( std::move( solution ) );
+  }
+  not_empty.notify_one();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// waits until all the pushed Solutions have been written
+ /** Waits until all pushed Solutions have been written. The background
+  * thread keeps running, so that more Solutions can be pushed afterwards.
+  * If the function that writes the Solutions has thrown an exception since
+  * the previous call to flush() (or close()), it is rethrown, and the
+  * Solutions pushed afterwards are written again. */
+
+ void flush() {
+  std::unique_lock< std::mutex > lock( mutex );
+  idle.wait( lock , [ this ]() { return( queue.empty() && ( ! writing ) ); } );
+  if( error ) {
+   auto e = error;
+   error = nullptr;
+   std::rethrow_exception( e );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// waits until all Solutions are written and stops the background thread
+ /** Waits until all pushed Solutions have been written and stops the
+  * background thread. Nothing can be pushed afterwards. If the function
+  * that writes the Solutions has thrown an exception, it is rethrown
+  * (once). */
+
+ void close() {
+  {
+   std::lock_guard< std::mutex > lock( mutex );
+   closing = true;
+  }
+  not_empty.notify_one();
+
+  if( thread.joinable() )
+   thread.join();
+
+  if( error ) {
+   auto e = error;
+   error = nullptr;
+   std::rethrow_exception( e );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the number of times push() had to wait for the writer
+ unsigned long get_number_waits() const {
+  std::lock_guard< std::mutex > lock( mutex );
+  return( number_waits );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// the loop of the background thread
+ void run() {
+  std::unique_lock< std::mutex > lock( mutex );
+  while( true ) {
+   not_empty.wait( lock , [ this ]() {
+    return( ( ! queue.empty() ) || closing );
+   } );
+
+   if( queue.empty() )
+    return;  // closing and nothing left to write
+
+   auto solution = std::move( queue.front() );
+   queue.pop_front();
+   writing = true;
+   lock.unlock();
+   not_full.notify_one();
+
+   std::exception_ptr exception;
+   try {
+    write( solution );
+   }
+   catch( ... ) {
+    exception = std::current_exception();
+   }
+
+   lock.lock();
+   writing = false;
+
+   if( exception ) {
+    // The remaining Solutions are discarded and the waiting threads woken up
+    error = exception;
+    queue.clear();
+    not_full.notify_all();
+   }
+   else if( free_solutions.size() < capacity )
+    free_solutions.push_back( std::move( solution ) );
+
+   if( queue.empty() )
+    idle.notify_all();
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ std::function< void( const Solution & ) > write;
+ ///< the function that writes a Solution
+
+ Index capacity;
+ ///< the maximum number of Solutions waiting to be written
+
+ mutable std::mutex mutex;
+ ///< the mutex protecting everything below
+
+ std::condition_variable not_empty;
+ ///< signalled when a Solution is pushed or the writer is closed
+
+ std::condition_variable not_full;
+ ///< signalled when a Solution is taken from the queue
+
+ std::condition_variable idle;
+ ///< signalled when all the Solutions in the queue have been written
+
+ std::deque< Solution > queue;
+ ///< the Solutions waiting to be written
+
+ std::vector< Solution > free_solutions;
+ ///< the Solutions that have been written, to be reused
+
+ bool closing = false;
+ ///< whether close() has been called
+
+ bool writing = false;
+ ///< whether the background thread is writing a Solution
+
+ std::exception_ptr error;
+ ///< the exception thrown while writing, if any
+
+ unsigned long number_waits = 0;
+ ///< number of times push() had to wait for the writer
+
+ std::thread thread;
+ ///< the background thread
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class SolutionWriter )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* SolutionWriter.h included */
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- End File SolutionWriter.h ------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -0,0 +1,442 @@
+/*--------------------------------------------------------------------------*/
+/*------------------------ File StageLinkingPlan.h -------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of StageLinkingPlan, a class that links the UCBlocks of two
+ * consecutive stages of an SDDPBlock in simulation.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __StageLinkingPlan
+#define __StageLinkingPlan
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <BatteryUnitBlock.h>
+#include <BendersBFunction.h>
+#include <BendersBlock.h>
+#include <FRealObjective.h>
+#include <HydroUnitBlock.h>
+#include <SDDPBlock.h>
+#include <ThermalUnitBlock.h>
+
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- NAMESPACE ------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+using namespace SMSpp_di_unipi_it;
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ CLASS StageLinkingPlan --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// links the UCBlocks of two consecutive stages of an SDDPBlock
+/** In simulation, the UCBlocks of two consecutive stages of an SDDPBlock are
+ * linked in such a way that the final state of the system at one stage is
+ * the initial state of the system at the next stage: once the UCBlock of
+ * stage t - 1 has been solved, and before the UCBlock of stage t is solved,
+ * link( t ) sets
+ *
+ * - the initial flow rates of each HydroUnitBlock to the final flow rates
+ *   of the corresponding HydroUnitBlock of stage t - 1;
+ *
+ * - the initial power (and the initial storage level) of each
+ *   ThermalUnitBlock (and BatteryUnitBlock) to the final ones of the
+ *   corresponding unit of stage t - 1;
+ *
+ * - if required, the initial up/down time of each ThermalUnitBlock to the
+ *   number of time steps the corresponding unit has been on (or off) at the
+ *   end of stage t - 1, across the previous stages.
+ *
+ * The units of the two UCBlocks are paired by visiting their nested Blocks
+ * in breadth-first order, and an exception is thrown if the two UCBlocks do
+ * not have the same structure. This is done only once for each stage, the
+ * first time it is linked: the pairs of units, together with the variables
+ * of the units of stage t - 1 that are read, are kept in a plan, so that
+ * linking a stage afterwards only reads the values of these variables and
+ * sets the data of the units of stage t. Hence, neither the structure of
+ * the UCBlocks nor the abstract variables of the units must change after a
+ * stage has been linked.
+ *
+ * The number of time steps a ThermalUnitBlock has been on (or off) at the
+ * end of each stage is also kept, so that, when the stages are linked in
+ * order (as in a forward pass of the simulation), the initial up/down time
+ * is obtained by only looking at the last stage instead of going back
+ * through all the previous ones. */
+
+class StageLinkingPlan {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ using Index = Block::Index;
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// constructs a plan for linking the stages of the given SDDPBlock
+ explicit StageLinkingPlan( SDDPBlock * sddp_block )
+  : sddp_block( sddp_block ) {}
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the UCBlock of the given stage of the given SDDPBlock
+ static Block * get_uc_block( const SDDPBlock * sddp_block ,
+                              const Index stage ) {
+
+  auto benders_block = static_cast< BendersBlock * >
+   ( sddp_block->get_sub_Block( stage )->get_inner_block() );
+
+  auto objective = static_cast< FRealObjective * >
+   ( benders_block->get_objective() );
+
+  auto benders_function = static_cast< BendersBFunction * >
+   ( objective->get_function() );
+
+  return( benders_function->get_inner_block() );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// links the UCBlock of the given stage to that of the previous stage
+ /** Sets the data of the units of the UCBlock of the given \p stage that
+  * depends on the solution of the UCBlock of the previous stage (see the
+  * GENERAL NOTES). If \p update_init_updown_time is true, the initial
+  * up/down times of the ThermalUnitBlocks are also set. Nothing is done if
+  * \p stage is 0. */
+
+ void link( Index stage , bool update_init_updown_time ) {
+
+  if( stage == 0 )
+   return;
+
+  auto & plan = get_stage( stage );
+
+  for( const auto & hydro : plan.hydro ) {
+   flow_rate.resize( hydro.final_flow_rate.size() );
+   for( Index g = 0 ; g < hydro.final_flow_rate.size() ; ++g )
+    flow_rate[ g ] = hydro.final_flow_rate[ g ]->get_value();
+   hydro.unit->set_initial_flow_rate( flow_rate.cbegin() );
+  }
+
+  const bool in_order = ( last_linked_stage + 1 == stage );
+
+  for( Index k = 0 ; k < plan.thermal.size() ; ++k ) {
+   auto & thermal = plan.thermal[ k ];
+
+   if( update_init_updown_time ) {
+    thermal.final_run = compute_final_run( stage , k , in_order );
+    int_value[ 0 ] = ( thermal.final_shut_down &&
+                       thermal.final_shut_down->get_value() >= 0.5 ) ?
+     0 : thermal.final_run;
+    thermal.unit->set_init_updown_time( int_value.cbegin() );
+   }
+
+   value[ 0 ] = thermal.final_power->get_value();
+   thermal.unit->set_initial_power( value.cbegin() );
+  }
+
+  for( const auto & battery : plan.battery ) {
+   value[ 0 ] = battery.final_power->get_value();
+   battery.unit->set_initial_power( value.cbegin() );
+   value[ 0 ] = battery.final_storage->get_value();
+   battery.unit->set_initial_storage( value.cbegin() );
+  }
+
+  last_linked_stage = update_init_updown_time ? stage : 0;
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE TYPES -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// a HydroUnitBlock and the final flow rates of its previous one
+ struct HydroLink {
+  HydroUnitBlock * unit;                            ///< the unit at stage t
+  std::vector< const ColVariable * > final_flow_rate;
+  ///< the flow rates of the generators of the unit at the end of stage t - 1
+ };
+
+ /// a ThermalUnitBlock and the variables of its previous one
+ struct ThermalLink {
+  ThermalUnitBlock * unit;                          ///< the unit at stage t
+  const ColVariable * commitment;
+  ///< the commitment variables of the unit at stage t - 1
+  Index time_horizon;                  ///< the time horizon of stage t - 1
+  const ColVariable * final_shut_down;
+  ///< the last shut-down variable of the unit at stage t - 1 (if any)
+  const ColVariable * final_power;
+  ///< the last active power variable of the unit at stage t - 1
+  int final_run;
+  ///< the signed number of time steps the unit has been on (off, if
+  ///< negative) at the end of stage t - 1, as computed by the last link()
+ };
+
+ /// a BatteryUnitBlock and the variables of its previous one
+ struct BatteryLink {
+  BatteryUnitBlock * unit;                          ///< the unit at stage t
+  const ColVariable * final_power;
+  ///< the last active power variable of the unit at stage t - 1
+  const ColVariable * final_storage;
+  ///< the last storage level variable of the unit at stage t - 1
+ };
+
+ /// the plan for linking a stage to its previous one
+ struct Stage {
+  bool built = false;                ///< whether the plan has been built
+  std::vector< HydroLink > hydro;              ///< the HydroUnitBlocks
+  std::vector< ThermalLink > thermal;          ///< the ThermalUnitBlocks
+  std::vector< BatteryLink > battery;          ///< the BatteryUnitBlocks
+ };
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// returns the plan of the given stage, which is built if needed
+ Stage & get_stage( Index stage ) {
+  if( stage >= stages.size() )
+   stages.resize( stage + 1 );
+  if( ! stages[ stage ].built )
+   build( stage );
+  return( stages[ stage ] );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ std::logic_error structure_error( Index stage ) const {
+  return( std::logic_error
+          ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
+            " and " + std::to_string( stage ) +
+            " do not have the same structure." ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// builds the plan of the given stage
+ void build( Index stage ) {
+
+  auto & plan = stages[ stage ];
+
+  std::queue< Block * > blocks;
+  blocks.push( get_uc_block( sddp_block , stage ) );
+
+  std::queue< Block * > previous_blocks;
+  previous_blocks.push( get_uc_block( sddp_block , stage - 1 ) );
+
+  while( ! blocks.empty() ) {
+   auto block = blocks.front();
+   blocks.pop();
+
+   auto previous_block = previous_blocks.front();
+   previous_blocks.pop();
+
+   auto n = block->get_number_nested_Blocks();
+
+   if( n != previous_block->get_number_nested_Blocks() )
+    throw( structure_error( stage ) );
+
+   for( decltype( n ) i = 0 ; i < n ; ++i ) {
+    blocks.push( block->get_nested_Block( i ) );
+    previous_blocks.push( previous_block->get_nested_Block( i ) );
+   }
+
+   add_hydro_unit( previous_block , block , stage )
+    || add_thermal_unit( previous_block , block , stage )
+    || add_battery_unit( previous_block , block , stage );
+  }
+
+  plan.built = true;
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ bool add_hydro_unit( Block * previous_block , Block * block ,
+                      const Index stage ) {
+  auto unit = dynamic_cast< HydroUnitBlock * >( block );
+  auto previous_unit = dynamic_cast< HydroUnitBlock * >( previous_block );
+
+  if( ( ! unit ) && ( ! previous_unit ) )
+   return( false );
+
+  if( ( ! unit ) || ( ! previous_unit ) )
+   throw( structure_error( stage ) );
+
+  auto number_generators = previous_unit->get_number_generators();
+
+  if( number_generators != unit->get_number_generators() )
+   throw( std::logic_error
+          ( "sddp_solver: HydroUnitBlock at stage " +
+            std::to_string( stage - 1 ) + " has " +
+            std::to_string( number_generators ) +
+            ", but corresponding HydroUnitBlock at stage " +
+            std::to_string( stage ) + " has " +
+            std::to_string( unit->get_number_generators() ) ) );
+
+  const auto time_horizon = previous_unit->get_time_horizon();
+
+  HydroLink link{ unit , {} };
+  link.final_flow_rate.resize( number_generators );
+  for( Index g = 0 ; g < number_generators ; ++g )
+   link.final_flow_rate[ g ] =
+    previous_unit->get_flow_rate( g , time_horizon - 1 );
+
+  stages[ stage ].hydro.push_back( std::move( link ) );
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ bool add_thermal_unit( Block * previous_block , Block * block ,
+                        const Index stage ) {
+  auto unit = dynamic_cast< ThermalUnitBlock * >( block );
+  auto previous_unit = dynamic_cast< ThermalUnitBlock * >( previous_block );
+
+  if( ( ! unit ) && ( ! previous_unit ) )
+   return( false );
+
+  if( ( ! unit ) || ( ! previous_unit ) )
+   throw( structure_error( stage ) );
+
+  const auto time_horizon = previous_unit->get_time_horizon();
+
+  stages[ stage ].thermal.push_back
+   ( { unit , previous_unit->get_commitment( 0 ) , time_horizon ,
+       previous_unit->get_shut_down( time_horizon - 1 ) ,
+       previous_unit->get_active_power( 0 ) + time_horizon - 1 , 0 } );
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ bool add_battery_unit( Block * previous_block , Block * block ,
+                        const Index stage ) {
+  auto unit = dynamic_cast< BatteryUnitBlock * >( block );
+  auto previous_unit = dynamic_cast< BatteryUnitBlock * >( previous_block );
+
+  if( ( ! unit ) && ( ! previous_unit ) )
+   return( false );
+
+  if( ( ! unit ) || ( ! previous_unit ) )
+   throw( structure_error( stage ) );
+
+  const auto time_horizon = previous_unit->get_time_horizon();
+
+  stages[ stage ].battery.push_back
+   ( { unit , previous_unit->get_active_power( 0 ) + time_horizon - 1 ,
+       &( previous_unit->get_storage_level()[ time_horizon - 1 ] ) } );
+  return( true );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the signed run of the k-th ThermalUnitBlock at stage - 1
+ /** Returns the number of time steps the k-th ThermalUnitBlock has been on
+  * (with a positive sign) or off (with a negative sign) at the end of stage
+  * \p stage - 1, going back through the previous stages as long as the unit
+  * is on (or off) during all of a stage. If \p in_order is true, the run at
+  * the end of stage \p stage - 2 is the one computed by the last link();
+  * otherwise, it is computed again. */
+
+ int compute_final_run( Index stage , Index k , bool in_order ) {
+
+  const auto & thermal = stages[ stage ].thermal[ k ];
+  const auto commitment = thermal.commitment;
+  const auto time_horizon = thermal.time_horizon;
+
+  const bool on = commitment[ time_horizon - 1 ].get_value() >= 0.5;
+
+  // The number of time steps the unit has been on (or off) during stage
+  // stage - 1
+
+  int run = 1;
+  for( Index t = time_horizon - 1 ; t > 0 ; --t , ++run )
+   if( std::abs( commitment[ t ].get_value() -
+                 commitment[ t - 1 ].get_value() ) > 0.5 )
+    return( on ? run : -run );
+
+  if( stage > 1 ) {
+   // The unit has been on (or off) during all of stage stage - 1: the run at
+   // the end of stage stage - 2 is added if it has the same sign
+
+   auto & previous = get_stage( stage - 1 );
+   auto previous_run = previous.thermal[ k ].final_run;
+   if( ! in_order )
+    previous_run = previous.thermal[ k ].final_run =
+     compute_final_run( stage - 1 , k , false );
+
+   if( ( previous_run > 0 ) == on )
+    run += std::abs( previous_run );
+  }
+
+  return( on ? run : -run );
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ SDDPBlock * sddp_block;
+ ///< the SDDPBlock whose stages are linked
+
+ std::vector< Stage > stages;
+ ///< the plan of each stage (the first one is never used)
+
+ Index last_linked_stage = 0;
+ ///< the last stage linked with update_init_updown_time (0 if none)
+
+ std::vector< double > flow_rate;
+ ///< buffer for the flow rates of a HydroUnitBlock
+
+ std::vector< double > value = std::vector< double >( 1 );
+ ///< buffer for one value
+
+ std::vector< int > int_value = std::vector< int >( 1 );
+ ///< buffer for one integer value
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class StageLinkingPlan )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* StageLinkingPlan.h included */
+
+/*--------------------------------------------------------------------------*/
+/*---------------------- End File StageLinkingPlan.h -----------------------*/
+/*--------------------------------------------------------------------------*/
@@ -7,7 +7,7 @@
  * SDDPGreedySolver. The description of the SDDPBlock must be given in a
  * netCDF file. This tool can be executed as follows:
  *
- *     ./sddp_greedy_solver [-i INDEX] [-b FILE] [-s FILE] <nc4-file>
+ *     ./sddp_greedy_solver [-i INDEX] [-b FILE] [-s FILE] [-P FILE] <nc4-file>
  *
  * The only mandatory argument is the netCDF containing the description of the
  * SDDPBlock. This netCDF can be either a BlockFile or a ProbFile. The
@@ -28,6 +28,10 @@
  * every SDDPBlock. If each of these options is not provided when the given
  * netCDF file is a BlockFile, then default configurations are considered.
  *
+ * The -P option enables the Profiler: the time spent in solving each
+ * SDDPBlock is written into the given file at the end, in JSON format if its
+ * extension is ".json" and in CSV format otherwise (see Profiler).
+ *
  * \author Rafael Durbano Lobato \n
  *         Dipartimento di Informatica \n
  *         Universita' di Pisa \n
@@ -48,6 +52,8 @@
 #include <StochasticBlock.h>
 #include <SDDPGreedySolver.h>
 
+#include "Profiler.h"
+
 using namespace SMSpp_di_unipi_it;
 
 /*--------------------------------------------------------------------------*/
@@ -55,6 +61,7 @@ using namespace SMSpp_di_unipi_it;
 std::string filename{};
 std::string block_config_filename{};
 std::string solver_config_filename{};
+std::string profile_filename{};
 long scenario_id = 0;
 
 /*--------------------------------------------------------------------------*/
@@ -67,6 +74,7 @@ void print_help() {
   << "  -i <index>, --scenario <index>  The index of the scenario.\n"
   << "  -b <file>,  --blockcfg <file>   Block configuration.\n"
   << "  -s <file>,  --solvercfg <file>  Solver configuration.\n"
+  << "  -P <file>,  --profile <file>    Write the timings into a file.\n"
   << "  -h, --help                      Print this help." << std::endl;
 }
 
@@ -79,11 +87,12 @@ void process_args( int argc , char ** argv ) {
   exit( 1 );
  }
 
- const char * const short_opts = "b:s:i:h";
+ const char * const short_opts = "b:s:i:P:h";
  const option long_opts[] = {
   { "blockcfg" ,  required_argument , nullptr , 'b' } ,
   { "solvercfg" , required_argument , nullptr , 's' } ,
   { "scenario" ,  required_argument , nullptr , 'i' } ,
+  { "profile" ,   required_argument , nullptr , 'P' } ,
   { "help" ,      no_argument ,       nullptr , 'h' } ,
   { nullptr ,     no_argument ,       nullptr , 0 }
  };
@@ -118,6 +127,10 @@ void process_args( int argc , char ** argv ) {
     }
     break;
    }
+   case 'P':
+    profile_filename = std::string( optarg );
+    Profiler::enable();
+    break;
    case 'h': // -h or --help
     print_help();
     exit( 0 );
@@ -199,7 +212,9 @@ void solve( SDDPBlock * sddp_block ) {
 
  solver->set_scenario_id( scenario_id );
 
+ Profiler::ScopedTimer compute_timer( "simulate" , scenario_id );
  auto status = solver->compute();
+ compute_timer.stop();
 
  show_status( status , solver->get_fault_stage() );
 
@@ -518,5 +533,15 @@ int main( int argc , char ** argv ) {
    exit( 1 );
  }
 
+ if( ! profile_filename.empty() ) {
+  try {
+   Profiler::write_report( profile_filename );
+  }
+  catch( const std::exception & e ) {
+   std::cerr << e.what() << std::endl;
+   exit( 1 );
+  }
+ }
+
  return( 0 );
 }
@@ -7,9 +7,9 @@
  * SDDPSolver or the SDDPGreedySolver. The description of the SDDPBlock must
  * be given in a netCDF file. This tool can be executed as follows:
  *
- *   ./sddp_solver [-s] [-e] [-l FILE] [-i INDEX] [-m NUMBER] [-t STAGE]
- *                 [-n NUMBER] [-B FILE] [-S FILE] [-p PATH] [-c PATH]
- *                 <nc4-file>
+ *   ./sddp_solver [-s] [-e] [-b] [-l FILE] [-i INDEX] [-m NUMBER] [-t STAGE]
+ *                 [-u] [-I] [-O FILE] [-n NUMBER] [-B FILE] [-S FILE]
+ *                 [-P FILE] [-p PATH] [-c PATH] [-w FILE] <nc4-file>
  *
  * The only mandatory argument is the netCDF file containing the description
  * of the SDDPBlock. This netCDF file can be either a BlockFile or a
@@ -41,7 +41,25 @@
  * levels. The final state of some stage of a simulation is used as the
  * initial state for the next simulation. See the comments below for more
  * details. If the value NUMBER provided by this option is greater than 1,
- * then NUMBER consecutive simulations are performed.
+ * then NUMBER consecutive simulations are performed. In this case, the -u
+ * option indicates that the cuts must only be loaded (and, if the -e option
+ * is used, pruned) once: the cuts of the first simulation are then given to
+ * all the following ones.
+ *
+ * The -I option makes the multiple simulations independent: each simulation
+ * i uses its own random number engine, whose seed only depends on i (instead
+ * of continuing the stream of the previous simulation), and the simulations
+ * are distributed among the MPI processes (if MPI is used). The results are
+ * therefore the same regardless of the number of processes. A simulation
+ * that does not find a solution is not tried again. At the end, the lower
+ * and upper bounds of all simulations are printed in order; those of a
+ * failed simulation are NaN, and the exit status is then 1. This option
+ * cannot be used together with the -t option.
+ *
+ * In simulation mode, the solution of the simulated scenario is output
+ * into CSV files (see SDDPBlockSolutionOutput). If the -O option is used,
+ * the solution is instead written into the given netCDF-4 file, with a
+ * variable for each quantity (see NetCDFSolutionOutput).
  *
  * The -n option specifies the number of sub-Blocks of SDDPBlock that must be
  * constructed for each stage. By default, SDDPBlock contains a single
@@ -68,10 +86,59 @@
  * ..., a_k are the coefficients of the cut, and b is the constant term of the
  * cut.
  *
+ * The file given to the -l option can also be a binary cut archive (see
+ * CutArchive), which is recognized by its content, as written by the
+ * -b option.
+ *
+ * In optimization mode, the cuts are written into the files
+ * BellmanValuesAllOUT.csv (all cuts) and BellmanValuesOUT.csv (after the
+ * possible elimination of redundant cuts). If the -b option is used, these
+ * files are written in binary format (see CutArchive) and have the .bin
+ * extension instead.
+ *
  * As a preprocessing, given redundant cuts can be removed by using the -e
  * option. Notice that all cuts will be subject to being removed, whether they
  * are provided in a netCDF file or by the -l option.
  *
+ * In optimization mode, the redundant cuts can also be removed while
+ * solving, by using the -k option (every given number of iterations) and/or
+ * the -T option (every given number of seconds). The cuts are never changed
+ * while the SDDPSolver is running: it is stopped (by means of its iteration
+ * and time limits), the cuts are eliminated by the same CutProcessing as for
+ * the -e option (hence, with the threads given by the -j option), and the
+ * SDDPSolver is restarted from the remaining cuts, until it stops for
+ * another reason or its own limits are reached. The trial points of the
+ * iterations since the previous elimination are used to keep the cuts that
+ * are certainly not redundant. The number of cuts removed and the time
+ * taken are printed after each elimination.
+ *
+ * The -P option enables the Profiler: the time spent in each phase (loading
+ * and eliminating the cuts, solving, outputting the solution and the cuts)
+ * and a few counters (e.g., the number of cuts eliminated) are written into
+ * the given file at the end, in JSON format if its extension is ".json" and
+ * in CSV format otherwise (see Profiler). If there are many MPI processes,
+ * "_<rank>" is appended to the name of the file of each process.
+ *
+ * The -w option performs a parameter sweep over the Block and Solver
+ * configurations given by the -B and -S options, without deserializing the
+ * SDDPBlock and loading the cuts again for each variant. The given file
+ * contains a grid whose lines have the form
+ *
+ *     <configuration file> <parameter> <value_1> [ <value_2> ... ]
+ *
+ * where the configuration file is the one given to the -B or -S option, and
+ * each combination of the values of the lines is a variant (see
+ * ParameterSweep). The parameters are replaced in memory with the rules of
+ * chgcfg, except that the name of a parameter must be the first token of
+ * its line. Each SDDPBlock is deserialized, configured and given its cuts
+ * (possibly pruned by the -e option) once; then, for each variant v, it is
+ * configured with the modified configurations, its cuts are reset to the
+ * initial ones (when solving) and it is solved (or simulated) in the
+ * directory "variant_<v>", which receives the output files of the variant
+ * (e.g., the cuts or the solution) and a copy of the modified configuration
+ * files. This option can only be used with a BlockFile and cannot be used
+ * together with the -m option.
+ *
  * There are a few ways to specify the initial state for the first stage
  * subproblem. This can be done by setting the initial state variable of
  * SDDPBlock or by setting the initial state parameter of SDDPSolver or
@@ -96,10 +163,18 @@
  * \copyright &copy; by Rafael Durbano Lobato
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <getopt.h>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <queue>
+#include <sstream>
+#include <system_error>
 
 #include <BendersBlock.h>
 #include <BlockSolverConfig.h>
@@ -110,10 +185,18 @@
 #include <SDDPGreedySolver.h>
 #include <SDDPSolver.h>
 
+#include "CutArchive.h"
+#include "CutFileReader.h"
 #include "CutProcessing.h"
+#include "CutSet.h"
+#include "NetCDFSolutionOutput.h"
+#include "ParameterSweep.h"
+#include "Profiler.h"
 #include "SDDPBlockSolutionOutput.h"
+#include "StageLinkingPlan.h"
 
 #ifdef USE_MPI
+#include <boost/mpi/collectives.hpp>
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/communicator.hpp>
 #endif
@@ -127,12 +210,22 @@ std::string block_config_filename{};
 std::string solver_config_filename{};
 std::string config_filename_prefix{};
 std::string cuts_filename{};
+std::string solution_filename{};
+std::string profile_filename{};
+std::string sweep_filename{};
 long scenario_id = 0;
 long num_sub_blocks_per_stage = 1;
 long number_simulations = 1;
 long initial_solution_stage = -1;
+long cut_processing_threads = 1;
+long pruning_iterations = 0;
+double pruning_interval = 0;
 bool simulation_mode = false;
 bool eliminate_redundant_cuts = false;
+bool binary_cuts = false;
+bool reuse_setup = false;
+bool independent_simulations = false;
+int exit_status = 0;
 const bool force_hard_components = false;
 const bool continuous_relaxation = true;
 
@@ -177,23 +270,41 @@ void print_help() {
            << "  " << exe << " -h | --help\n"
            << std::endl
            << "Options:\n"
+           << "  -b, --binary-cuts               Output the cuts in binary format.\n"
            << "  -B, --blockcfg <file>           Block configuration.\n"
            << "  -c, --configdir <path>          The prefix for all config filenames.\n"
            << "  -e, --eliminate-redundant-cuts  Eliminate given redundant cuts.\n"
            << "  -h, --help                      Print this help.\n"
+           << "  -I, --independent               Independent (MPI-parallel) simulations.\n"
            << "  -i, --scenario <index>          The index of the scenario.\n"
+           << "  -j, --cut-threads <number>      Threads for eliminating redundant cuts.\n"
+           << "  -k, --prune-every <number>      Prune the cuts every <number> iterations.\n"
            << "  -l, --load-cuts <file>          Load cuts from a file.\n"
            << "  -m, --num-simulations <number>  Number of simulations to be performed.\n"
            << "  -n, --num-blocks <number>       Number of sub-Blocks per stage.\n"
+           << "  -O, --netcdf-solution <file>    Output the solution into a netCDF file.\n"
            << "  -p, --prefix <path>             The prefix for all Block filenames.\n"
+           << "  -P, --profile <file>            Write the timings into a file.\n"
            << "  -s, --simulation                Simulation mode.\n"
            << "  -S, --solvercfg <file>          Solver configuration.\n"
-           << "  -t, --stage <stage>             Stage from which initial state is taken."
+           << "  -t, --stage <stage>             Stage from which initial state is taken.\n"
+           << "  -T, --prune-interval <s>        Prune the cuts every <s> seconds.\n"
+           << "  -u, --reuse-setup               Reuse the cuts across simulations.\n"
+           << "  -w, --sweep <file>              Solve each variant of a parameter sweep."
            << std::endl;
 }
 
 /*--------------------------------------------------------------------------*/
 
+// Returns the CutProcessing used to eliminate redundant cuts
+CutProcessing get_cut_processing() {
+ CutProcessing cut_processing;
+ cut_processing.set_number_threads( cut_processing_threads );
+ return( cut_processing );
+}
+
+/*--------------------------------------------------------------------------*/
+
 long get_long_option() {
  char * end = nullptr;
  errno = 0;
@@ -215,21 +326,30 @@ void process_args( int argc , char ** argv ) {
   exit( 1 );
  }
 
- const char * const short_opts = "B:c:hei:l:m:n:p:rsS:t:";
+ const char * const short_opts = "bB:c:heIi:j:k:l:m:n:O:p:P:rsS:t:T:uw:";
  const option long_opts[] = {
+  { "binary-cuts" ,              no_argument ,       nullptr , 'b' } ,
   { "blockcfg" ,                 required_argument , nullptr , 'B' } ,
   { "configdir" ,                required_argument , nullptr , 'c' } ,
   { "help" ,                     no_argument ,       nullptr , 'h' } ,
   { "eliminate-redundant-cuts" , no_argument ,       nullptr , 'e' } ,
+  { "cut-threads" ,              required_argument , nullptr , 'j' } ,
+  { "prune-every" ,              required_argument , nullptr , 'k' } ,
+  { "independent" ,              no_argument ,       nullptr , 'I' } ,
   { "scenario" ,                 required_argument , nullptr , 'i' } ,
   { "load-cuts" ,                required_argument , nullptr , 'l' } ,
   { "num-simulations" ,          required_argument , nullptr , 'm' } ,
   { "num-blocks" ,               required_argument , nullptr , 'n' } ,
+  { "netcdf-solution" ,          required_argument , nullptr , 'O' } ,
   { "prefix" ,                   required_argument , nullptr , 'p' } ,
+  { "profile" ,                  required_argument , nullptr , 'P' } ,
   { "relax" ,                    no_argument ,       nullptr , 'r' } ,
   { "simulation" ,               no_argument ,       nullptr , 's' } ,
   { "solvercfg" ,                required_argument , nullptr , 'S' } ,
   { "stage" ,                    required_argument , nullptr , 't' } ,
+  { "prune-interval" ,           required_argument , nullptr , 'T' } ,
+  { "reuse-setup" ,              no_argument ,       nullptr , 'u' } ,
+  { "sweep" ,                    required_argument , nullptr , 'w' } ,
   { nullptr ,                    no_argument ,       nullptr , 0 }
  };
 
@@ -243,6 +363,9 @@ void process_args( int argc , char ** argv ) {
   }
 
   switch( opt ) {
+   case 'b':
+    binary_cuts = true;
+    break;
    case 'B':
     block_config_filename = std::string( optarg );
     break;
@@ -253,6 +376,18 @@ void process_args( int argc , char ** argv ) {
    case 'e':
     eliminate_redundant_cuts = true;
     break;
+   case 'j': {
+    cut_processing_threads = get_long_option();
+    if( cut_processing_threads < 0 ) {
+     std::cout << "The number of threads for eliminating redundant cuts must "
+               << "be a nonnegative integer." << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
+   case 'I':
+    independent_simulations = true;
+    break;
    case 'i': {
     scenario_id = get_long_option();
     if( scenario_id < 0 ) {
@@ -262,6 +397,16 @@ void process_args( int argc , char ** argv ) {
     }
     break;
    }
+   case 'k': {
+    pruning_iterations = get_long_option();
+    if( pruning_iterations < 0 ) {
+     std::cout << "The number of iterations between two eliminations of "
+               << "redundant cuts must be\na nonnegative integer."
+               << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
    case 'l':
     cuts_filename = std::string( optarg );
     break;
@@ -282,9 +427,16 @@ void process_args( int argc , char ** argv ) {
     }
     break;
    }
+   case 'O':
+    solution_filename = std::string( optarg );
+    break;
    case 'p':
     Block::set_filename_prefix( std::string( optarg ) );
     break;
+   case 'P':
+    profile_filename = std::string( optarg );
+    Profiler::enable();
+    break;
    case 'r':
     std::cout << "The -r option no longer exists. In order relax the "
               << "integrality constraints,\nplease properly configure the "
@@ -302,6 +454,22 @@ void process_args( int argc , char ** argv ) {
    case 't':
     initial_solution_stage = get_long_option();
     break;
+   case 'T': {
+    char * end = nullptr;
+    pruning_interval = std::strtod( optarg , &end );
+    if( ( end && *end ) || ( ! ( pruning_interval >= 0 ) ) ) {
+     std::cout << "The number of seconds between two eliminations of "
+               << "redundant cuts must be a\nnonnegative number." << std::endl;
+     exit( 1 );
+    }
+    break;
+   }
+   case 'u':
+    reuse_setup = true;
+    break;
+   case 'w':
+    sweep_filename = std::string( optarg );
+    break;
    case 'h': // -h or --help
     print_help();
     exit( 0 );
@@ -312,6 +480,18 @@ void process_args( int argc , char ** argv ) {
   }
  }
 
+ if( independent_simulations && ( initial_solution_stage >= 0 ) ) {
+  std::cout << "The -I and -t options cannot be used together, since the "
+            << "simulations are\nnot independent if the initial state of "
+            << "each one is taken from the previous one." << std::endl;
+  exit( 1 );
+ }
+
+ if( ( ! sweep_filename.empty() ) && ( number_simulations > 1 ) ) {
+  std::cout << "The -w and -m options cannot be used together." << std::endl;
+  exit( 1 );
+ }
+
  // Last argument
  if( optind < argc ) {
   filename = std::string( argv[ optind ] );
@@ -373,239 +553,33 @@ void show_simulation_status( Index status , Index fault_stage ) {
 
 /*--------------------------------------------------------------------------*/
 
-Block * get_uc_block( const SDDPBlock * sddp_block , const Index stage ) {
-
- auto benders_block = static_cast< BendersBlock * >
-  ( sddp_block->get_sub_Block( stage )->get_inner_block() );
-
- auto objective = static_cast< FRealObjective * >
-  ( benders_block->get_objective() );
-
- auto benders_function = static_cast< BendersBFunction * >
-  ( objective->get_function() );
-
- return( benders_function->get_inner_block() );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_hydro_unit( Block * previous_block , Block * block ,
-                        const Index stage ) {
- auto unit = dynamic_cast< HydroUnitBlock * >( block );
- auto previous_unit = dynamic_cast< HydroUnitBlock * >( previous_block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- auto number_generators = previous_unit->get_number_generators();
-
- if( number_generators != unit->get_number_generators() )
-  throw( std::logic_error
-         ( "sddp_solver: HydroUnitBlock at stage " +
-           std::to_string( stage - 1 ) + " has " +
-           std::to_string( number_generators ) +
-           ", but corresponding HydroUnitBlock at stage " +
-           std::to_string( stage ) + " has " +
-           std::to_string( unit->get_number_generators() ) ) );
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > flow_rate( number_generators );
-
- for( Index g = 0 ; g < number_generators ; ++g )
-  flow_rate[ g ] =
-   previous_unit->get_flow_rate( g , time_horizon - 1 )->get_value();
-
- unit->set_initial_flow_rate( flow_rate.cbegin() );
-
- return( true );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_battery_unit( Block * previous_block , Block * block ,
-                          const Index stage ) {
- auto unit = dynamic_cast< BatteryUnitBlock * >( block );
- auto previous_unit = dynamic_cast< BatteryUnitBlock * >( previous_block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > initial_power_data =
-  { ( previous_unit->get_active_power( 0 ) + time_horizon - 1 )->get_value() };
-
- unit->set_initial_power( initial_power_data.cbegin() );
-
- std::vector< double > initial_storage_data =
-  { previous_unit->get_storage_level()[ time_horizon - 1 ].get_value() };
-
- unit->set_initial_storage( initial_storage_data.cbegin() );
-
- return( true );
-}
-
-/*--------------------------------------------------------------------------*/
-
-int compute_init_up_down_time( const SDDPBlock * sddp_block ,
-                               ThermalUnitBlock * previous_unit ,
-                               ThermalUnitBlock * unit , const Index stage ) {
-
- auto time_horizon = previous_unit->get_time_horizon();
- auto commitment = previous_unit->get_commitment( 0 ) + time_horizon - 1;
-
- auto shutdown = previous_unit->get_shut_down( time_horizon - 1 );
- if( shutdown && shutdown->get_value() >= 0.5 ) {
-  return( 0 );
- }
-
- int init_up_down_time = 0;
- const bool on = commitment->get_value() >= 0.5;
- if( on )
-  init_up_down_time = 1;
- else
-  init_up_down_time = -1;
-
- AbstractPath path;
-
- for( Index outer_t = 0 ; outer_t < stage ; ++outer_t ) {
-
-  for( Index t = 1 ; t < time_horizon ; ++t , --commitment ) {
-   if( std::abs( commitment->get_value() -
-                 ( commitment - 1 )->get_value() ) > 0.5 )
-    return( init_up_down_time );
-   if( on ) ++init_up_down_time;
-   else --init_up_down_time;
-  }
-
-  if( outer_t == stage - 1 )
-   break;
-
-  if( path.empty() ) {
-   auto uc_block = get_uc_block( sddp_block , stage );
-   path.build( unit , uc_block );
-  }
-
-  auto previous_uc_block = get_uc_block( sddp_block , stage - outer_t - 2 );
-  previous_unit = dynamic_cast< ThermalUnitBlock * >
-   ( path.get_element< Block >( previous_uc_block ) );
-
-  time_horizon = previous_unit->get_time_horizon();
-
-  if( ! previous_unit )
-   throw( std::logic_error
-          ( "sddp_solver::update_thermal_block: ThermalUnitBlock not found "
-            "at stage " + std::to_string( stage - outer_t - 2 ) ) );
-
-  commitment = previous_unit->get_commitment( 0 ) + time_horizon - 1;
-
-  if( on ) {
-   if( commitment->get_value() >= 0.5 ) ++init_up_down_time;
-   else break;
-  }
-  else {
-   if( commitment->get_value() < 0.5 ) --init_up_down_time;
-   else break;
-  }
- }
-
- return( init_up_down_time );
-}
-
-/*--------------------------------------------------------------------------*/
-
-bool update_thermal_unit( const SDDPBlock * sddp_block ,
-                          Block * previous_block , Block * block ,
-                          const Index stage ) {
-
- auto previous_unit = dynamic_cast< ThermalUnitBlock * >( previous_block );
- auto unit = dynamic_cast< ThermalUnitBlock * >( block );
-
- if( ( ! unit ) && ( ! previous_unit ) )
-  return( false );
-
- if( ( ! unit ) || ( ! previous_unit ) )
-  throw( std::logic_error
-         ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-           " and " + std::to_string( stage ) +
-           " do not have the same structure." ) );
-
- if( simulation_mode ) {
-  auto init_up_down_time = compute_init_up_down_time
-   ( sddp_block , previous_unit , unit , stage );
-
-  std::vector< int > init_up_down_time_data = { init_up_down_time };
-  unit->set_init_updown_time( init_up_down_time_data.cbegin() );
- }
-
- const auto time_horizon = previous_unit->get_time_horizon();
-
- std::vector< double > active_power_data =
-  { ( previous_unit->get_active_power( 0 ) + time_horizon - 1 )->get_value() };
- unit->set_initial_power( active_power_data.cbegin() );
-
- return( true );
+// Links the UCBlock of the given stage to that of the previous stage (see
+// StageLinkingPlan), also updating the initial up and down times in
+// simulation.
+void callback( StageLinkingPlan & plan , Block::Index stage ) {
+ plan.link( stage , simulation_mode );
 }
 
 /*--------------------------------------------------------------------------*/
 
-void callback( SDDPBlock * sddp_block , Block::Index stage ) {
-
- if( stage == 0 )
+void load_cuts( SDDPBlock * sddp_block ) {
+ if( cuts_filename.empty() )
   return;
 
- auto previous_uc_block = get_uc_block( sddp_block , stage - 1 );
- auto uc_block = get_uc_block( sddp_block , stage );
-
- std::queue< Block * > blocks;
- blocks.push( uc_block );
-
- std::queue< Block * > previous_blocks;
- previous_blocks.push( previous_uc_block );
-
- while( ! blocks.empty() ) {
-  auto block = blocks.front();
-  blocks.pop();
-
-  auto previous_block = previous_blocks.front();
-  previous_blocks.pop();
+ Profiler::ScopedTimer timer( "load_cuts" );
 
-  auto n = block->get_number_nested_Blocks();
-
-  if( n != previous_block->get_number_nested_Blocks() ) {
-   throw( std::logic_error
-          ( "sddp_solver: UCBlocks at stages " + std::to_string( stage - 1 ) +
-            " and " + std::to_string( stage ) +
-            " do not have the same structure." ) );
-  }
-
-  for( decltype( n ) i = 0 ; i < n ; ++i ) {
-   blocks.push( block->get_nested_Block( i ) );
-   previous_blocks.push( previous_block->get_nested_Block( i ) );
-  }
-
-  update_hydro_unit( previous_block , block , stage )
-   || update_thermal_unit( sddp_block , previous_block , block , stage )
-   || update_battery_unit( previous_block , block , stage );
- }
+ if( CutArchive::is_cut_archive( cuts_filename ) )
+  CutArchive::load( sddp_block , cuts_filename );
+ else
+  CutFileReader::load( sddp_block , cuts_filename );
 }
 
 /*--------------------------------------------------------------------------*/
 
-void simulate( SDDPBlock * sddp_block ) {
+/// simulates the given SDDPBlock with its SDDPGreedySolver
+/** If \p load_given_cuts is false, the cuts are not loaded (nor pruned),
+ * since they are already in the SDDPBlock (as in a parameter sweep). */
+void simulate( SDDPBlock * sddp_block , bool load_given_cuts = true ) {
 
  auto solver = dynamic_cast< SDDPGreedySolver * >
   ( sddp_block->get_registered_solvers().front() );
@@ -614,23 +588,29 @@ void simulate( SDDPBlock * sddp_block ) {
   throw( std::logic_error( "The Solver for the SDDPBlock must be a "
                            "SDDPGreedySolver in simulation mode." ) );
 
- solver->set_callback( [ sddp_block ]( Index stage ) {
-  callback( sddp_block , stage );
- });
+ solver->set_callback
+  ( [ plan = std::make_shared< StageLinkingPlan >( sddp_block ) ]
+    ( Index stage ) {
+   callback( *plan , stage );
+  } );
 
- // Load possibly given cuts
+ if( load_given_cuts ) {
 
- if( ! cuts_filename.empty() )
-  solver->set_par( SDDPGreedySolver::strLoadCuts , cuts_filename );
+  // Load possibly given cuts
 
- // Eliminate redundant cuts if it is desired
+  load_cuts( sddp_block );
 
- if( eliminate_redundant_cuts )
-  CutProcessing().remove_redundant_cuts( sddp_block );
+  // Eliminate redundant cuts if it is desired
+
+  if( eliminate_redundant_cuts )
+   get_cut_processing().remove_redundant_cuts( sddp_block );
+ }
 
  solver->set_scenario_id( scenario_id );
 
+ Profiler::ScopedTimer compute_timer( "simulate" , scenario_id );
  auto status = solver->compute();
+ compute_timer.stop();
 
 #ifdef USE_MPI
  boost::mpi::communicator world;
@@ -639,14 +619,26 @@ void simulate( SDDPBlock * sddp_block ) {
 
  show_simulation_status( status , solver->get_fault_stage() );
 
- SDDPBlockSolutionOutput output;
+ Profiler::ScopedTimer output_timer( "output_solution" , scenario_id );
+
+ const auto fault_stage = solver->has_var_solution() ?
+  Inf< Index >() : solver->get_fault_stage();
 
- if( solver->has_var_solution() ) {
+ if( solver->has_var_solution() )
   solver->get_var_solution();
-  output.print( sddp_block );
+
+ if( solution_filename.empty() )
+  SDDPBlockSolutionOutput().print( sddp_block , fault_stage );
+ else {
+  const auto num_stages = std::min( sddp_block->get_time_horizon() ,
+                                    fault_stage );
+  for( Index stage = 0 ; stage < num_stages ; ++stage )
+   SDDPBlockSolutionOutput::get_solution( sddp_block , stage );
+  NetCDFSolutionOutput( solution_filename ).print( sddp_block , scenario_id ,
+                                                   fault_stage );
  }
- else
-  output.print( sddp_block , solver->get_fault_stage() );
+
+ output_timer.stop();
 
  auto lb = solver->get_lb();
  auto ub = solver->get_ub();
@@ -695,6 +687,16 @@ void show_status( Index status ) {
 
 /*--------------------------------------------------------------------------*/
 
+// Returns the total number of cuts in the given SDDPBlock
+Block::Index get_number_cuts( SDDPBlock * sddp_block ) {
+ Block::Index number_cuts = 0;
+ for( auto function : sddp_block->get_polyhedral_functions() )
+  number_cuts += function->get_nrows();
+ return( number_cuts );
+}
+
+/*--------------------------------------------------------------------------*/
+
 void solve( SDDPBlock * sddp_block ) {
 
  auto solver = dynamic_cast< SDDPSolver * >
@@ -706,126 +708,126 @@ void solve( SDDPBlock * sddp_block ) {
 
  solver->set_log( &std::cout );
 
- auto status = solver->compute();
-
- show_status( status );
-
- SDDPBlockSolutionOutput o;
- o.print_cuts( sddp_block , "BellmanValuesAllOUT.csv" );
-
- if( eliminate_redundant_cuts )
-  CutProcessing().remove_redundant_cuts
-   ( static_cast< SDDPBlock * >( sddp_block ) );
-
- o.print_cuts( sddp_block , "BellmanValuesOUT.csv" );
-}
-
-/*--------------------------------------------------------------------------*/
-
-void load_cuts( SDDPBlock * sddp_block ) {
- if( cuts_filename.empty() )
-  return;
-
- std::ifstream cuts_file( cuts_filename );
-
- // Make sure the file is open
- if( ! cuts_file.is_open() )
-  throw( std::runtime_error( "It was not possible to open the file \"" +
-                             cuts_filename + "\"." ) );
-
- const auto time_horizon = sddp_block->get_time_horizon();
+ // Possibly eliminate the redundant cuts while solving. The cuts are never
+ // eliminated while the SDDPSolver is running, since it may be using them:
+ // instead, the SDDPSolver is stopped every pruning_iterations iterations
+ // and/or every pruning_interval seconds (by means of its iteration and time
+ // limits), the cuts are eliminated, and the SDDPSolver is restarted from
+ // the remaining cuts, until it stops for another reason or its own limits
+ // are reached. A handler of eEverykIteration collects the trial points of
+ // each iteration as the sample points of the next elimination, into a
+ // CutProcessing that only lives as long as the elimination round.
 
- std::vector< PolyhedralFunction::MultiVector > A
-  ( time_horizon , PolyhedralFunction::MultiVector{} );
- std::vector< PolyhedralFunction::RealVector > b
-  ( time_horizon , PolyhedralFunction::RealVector{} );
+ const bool prune_cuts = ( pruning_iterations > 0 ) || ( pruning_interval > 0 );
 
- std::string line;
+ const auto max_iterations =
+  solver->get_int_par( ThinComputeInterface::intMaxIter );
+ const auto max_time = solver->get_dbl_par( ThinComputeInterface::dblMaxTime );
+ const auto every_k_iterations =
+  solver->get_int_par( ThinComputeInterface::intEverykIt );
 
- if( cuts_file.good() )
-  // Skip the first line containing the header
-  std::getline( cuts_file , line );
+ const auto solve_start = std::chrono::steady_clock::now();
+ long iteration = 0;
+ int status;
 
- int line_number = 0;
+ while( true ) {
 
- // Read the cuts
+  auto cut_processing = get_cut_processing();
+  ThinComputeInterface::EventID sampling_event = {};
+  const auto round_start_iteration = iteration;
+
+  if( prune_cuts ) {
+   // Each round is given what is left of the iteration limit (at most
+   // pruning_iterations), since the SDDPSolver restarts its count
+   auto round_iterations = long( max_iterations ) - iteration;
+   if( pruning_iterations > 0 )
+    round_iterations = std::min( round_iterations , pruning_iterations );
+   solver->set_par( ThinComputeInterface::intMaxIter ,
+                    int( round_iterations ) );
+
+   if( pruning_interval > 0 ) {
+    const std::chrono::duration< double > elapsed =
+     std::chrono::steady_clock::now() - solve_start;
+    solver->set_par( ThinComputeInterface::dblMaxTime ,
+                     std::min( max_time - elapsed.count() ,
+                               pruning_interval ) );
+   }
 
- while( std::getline( cuts_file , line ) ) {
-  ++line_number;
+   solver->set_par( ThinComputeInterface::intEverykIt , 1 );
+   sampling_event = solver->set_event_handler
+    ( ThinComputeInterface::eEverykIteration ,
+      [ sddp_block , &cut_processing , &iteration ]() {
+       cut_processing.add_sample_points( sddp_block );
+       ++iteration;
+       return( ThinComputeInterface::eContinue );
+      } );
+  }
 
-  std::stringstream line_stream( line );
+  Profiler::ScopedTimer compute_timer( "solve" );
+  status = solver->compute();
+  compute_timer.stop();
 
-  // Try to read the stage
-  Index stage;
-  if( ! ( line_stream >> stage ) )
+  if( ! prune_cuts )
    break;
 
-  if( stage >= time_horizon )
-   throw( std::logic_error( "File \"" + cuts_filename + "\" contains an invalid"
-                            " stage: " + std::to_string( stage ) + "." ) );
-
-  if( line_stream.peek() != ',' )
-   throw( std::logic_error( "File \"" + cuts_filename +
-                            "\" has an invalid format." ) );
-  line_stream.ignore();
+  solver->reset_event_handler( ThinComputeInterface::eEverykIteration ,
+                               sampling_event );
 
-  // Read the cut
+  // Go on only if the SDDPSolver has been stopped by the limits of this
+  // round (and not by its own ones) after at least an iteration
 
-  const auto polyhedral_function = sddp_block->get_polyhedral_function( stage );
-  const auto num_active_var = polyhedral_function->get_num_active_var();
-  PolyhedralFunction::RealVector a( num_active_var );
+  const std::chrono::duration< double > elapsed =
+   std::chrono::steady_clock::now() - solve_start;
 
-  Index i = 0;
-  double value;
-  while( line_stream >> value ) {
-   if( i > num_active_var )
-    throw( std::logic_error
-           ( "File \"" + cuts_filename + "\" contains an invalid"
-             " cut at line " + std::to_string( line_number ) + "." ) );
+  if( ( iteration == round_start_iteration ) ||
+      ( ! ( ( ( status == SDDPSolver::kStopIter ) &&
+              ( iteration < max_iterations ) ) ||
+            ( ( status == SDDPSolver::kStopTime ) &&
+              ( elapsed.count() < max_time ) ) ) ) )
+   break;
 
-   if( i < num_active_var )
-    a[ i ] = value;
-   else
-    b[ stage ].push_back( value );
+  Profiler::ScopedTimer timer( "prune_cuts" );
+  const auto start = std::chrono::steady_clock::now();
+  const auto number_cuts = get_number_cuts( sddp_block );
 
-   ++i;
+  cut_processing.remove_redundant_cuts( sddp_block );
 
-   if( line_stream.peek() == ',' )
-    line_stream.ignore();
-  }
+  const auto number_removed = number_cuts - get_number_cuts( sddp_block );
+  Profiler::count( "pruned_cuts" , number_removed );
 
-  if( i < num_active_var )
-   throw( std::logic_error
-          ( "File \"" + cuts_filename + "\" contains an invalid"
-            " cut at line " + std::to_string( line_number ) + "." ) );
+  const std::chrono::duration< double > time =
+   std::chrono::steady_clock::now() - start;
 
-  A[ stage ].push_back( a );
+  std::cout << "Iteration " << iteration << ": " << number_removed
+            << " of " << number_cuts << " cuts eliminated in "
+            << time.count() << " seconds." << std::endl;
  }
 
- cuts_file.close();
+ // Restore the limits of the SDDPSolver
 
- // Now, add the cuts to all PolyhedralFunctions
+ if( prune_cuts ) {
+  solver->set_par( ThinComputeInterface::intMaxIter , max_iterations );
+  solver->set_par( ThinComputeInterface::dblMaxTime , max_time );
+  solver->set_par( ThinComputeInterface::intEverykIt , every_k_iterations );
+ }
 
- const auto num_sub_blocks_per_stage =
-  sddp_block->get_num_sub_blocks_per_stage();
+ show_status( status );
 
- for( Index stage = 0 ; stage < time_horizon ; ++stage ) {
-  for( Index sub_block_index = 0 ; sub_block_index < num_sub_blocks_per_stage ;
-       ++sub_block_index ) {
+ Profiler::ScopedTimer print_timer( "print_cuts" );
 
-   if( b[ stage ].empty() )
-    continue; // no cut for this stage
+ const std::string cuts_extension = binary_cuts ? CutArchive::extension :
+                                                 ".csv";
 
-   // We assume that there is only one PolyhedralFunction per stage
-   auto polyhedral_function =
-    sddp_block->get_polyhedral_function( stage , 0 , sub_block_index );
+ SDDPBlockSolutionOutput o;
+ o.print_cuts( sddp_block , "BellmanValuesAllOUT" + cuts_extension );
+ print_timer.stop();
 
-   // Copy the A matrix for this stage so that it can be moved
-   auto A_stage = A[ stage ];
+ if( eliminate_redundant_cuts )
+  get_cut_processing().remove_redundant_cuts
+   ( static_cast< SDDPBlock * >( sddp_block ) );
 
-   polyhedral_function->add_rows( std::move( A_stage ) , b[ stage ] );
-  }
- }
+ Profiler::ScopedTimer final_print_timer( "print_cuts" );
+ o.print_cuts( sddp_block , "BellmanValuesOUT" + cuts_extension );
 }
 
 /*--------------------------------------------------------------------------*/
@@ -1025,7 +1027,7 @@ void process_prob_file( const netCDF::NcFile & file ) {
   // Eliminate redundant cuts if it is desired
 
   if( eliminate_redundant_cuts )
-   CutProcessing().remove_redundant_cuts( sddp_block );
+   get_cut_processing().remove_redundant_cuts( sddp_block );
 
 
   std::cout << "Problem: " << problem.first << std::endl;
@@ -1106,6 +1108,34 @@ BlockConfig * build_BlockConfig( const SDDPBlock * sddp_block ) {
 
 /*--------------------------------------------------------------------------*/
 
+/// reads a BlockConfig from the given stream
+BlockConfig * read_BlockConfig( std::istream & input ) {
+
+ std::string config_name;
+ input >> eatcomments >> config_name;
+ auto config = Configuration::new_Configuration( config_name );
+ auto block_config = dynamic_cast< BlockConfig * >( config );
+
+ if( ! block_config ) {
+  std::cerr << "Block configuration is not valid: "
+            << config_name << std::endl;
+  delete( config );
+  exit( 1 );
+ }
+
+ try {
+  input >> *block_config;
+ }
+ catch( const std::exception& e ) {
+  std::cerr << "Block configuration is not valid: " << e.what() << std::endl;
+  exit( 1 );
+ }
+
+ return( block_config );
+}
+
+/*--------------------------------------------------------------------------*/
+
 BlockConfig * load_BlockConfig() {
 
  if( block_config_filename.empty() ) {
@@ -1126,28 +1156,37 @@ BlockConfig * load_BlockConfig() {
  std::cout << "Using Block configuration in " << block_config_filename
            << "." << std::endl;
 
+ auto block_config = read_BlockConfig( block_config_file );
+ block_config_file.close();
+ return( block_config );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// reads a BlockSolverConfig from the given stream
+BlockSolverConfig * read_BlockSolverConfig( std::istream & input ) {
+
  std::string config_name;
- block_config_file >> eatcomments >> config_name;
+ input >> eatcomments >> config_name;
  auto config = Configuration::new_Configuration( config_name );
- auto block_config = dynamic_cast< BlockConfig * >( config );
+ auto solver_config = dynamic_cast< BlockSolverConfig * >( config );
 
- if( ! block_config ) {
-  std::cerr << "Block configuration is not valid: "
+ if( ! solver_config ) {
+  std::cerr << "Solver configuration is not valid: "
             << config_name << std::endl;
   delete( config );
   exit( 1 );
  }
 
  try {
-  block_config_file >> *block_config;
+  input >> *solver_config;
  }
- catch( const std::exception& e ) {
-  std::cerr << "Block configuration is not valid: " << e.what() << std::endl;
+ catch( ... ) {
+  std::cout << "Solver configuration is not valid." << std::endl;
   exit( 1 );
  }
 
- block_config_file.close();
- return( block_config );
+ return( solver_config );
 }
 
 /*--------------------------------------------------------------------------*/
@@ -1171,26 +1210,7 @@ BlockSolverConfig * load_BlockSolverConfig( const std::string & filename ) {
 
  std::cout << "Using Solver configuration in " << filename << "." << std::endl;
 
- std::string config_name;
- solver_config_file >> eatcomments >> config_name;
- auto config = Configuration::new_Configuration( config_name );
- auto solver_config = dynamic_cast< BlockSolverConfig * >( config );
-
- if( ! solver_config ) {
-  std::cerr << "Solver configuration is not valid: "
-            << config_name << std::endl;
-  delete( config );
-  exit( 1 );
- }
-
- try {
-  solver_config_file >> *solver_config;
- }
- catch( ... ) {
-  std::cout << "Solver configuration is not valid." << std::endl;
-  exit( 1 );
- }
-
+ auto solver_config = read_BlockSolverConfig( solver_config_file );
  solver_config_file.close();
  return( solver_config );
 }
@@ -1680,6 +1700,23 @@ void config_Lagrangian_dual( BlockSolverConfig * sddp_solver_config ,
 
 /*--------------------------------------------------------------------------*/
 
+/// simulates (in simulation mode) or solves the given SDDPBlock
+/** See simulate() for \p load_given_cuts, which is only used in simulation
+ * mode (when solving, the cuts must always have been loaded). */
+void solve_or_simulate( SDDPBlock * sddp_block ,
+                        bool load_given_cuts = true ) {
+ if( simulation_mode ) {
+  auto solver = sddp_block->get_registered_solvers().front();
+  if( solver->get_int_par( solver->int_par_str2idx( "intLogVerb" ) ) )
+   solver->set_log( & std::cout );
+  simulate( sddp_block , load_given_cuts );
+ }
+ else
+  solve( sddp_block );
+}
+
+/*--------------------------------------------------------------------------*/
+
 void process_block_file( const netCDF::NcFile & file ) {
  std::multimap< std::string , netCDF::NcGroup > blocks = file.getGroups();
 
@@ -1756,18 +1793,11 @@ void process_block_file( const netCDF::NcFile & file ) {
   // Eliminate redundant cuts if it is desired
 
   if( eliminate_redundant_cuts )
-   CutProcessing().remove_redundant_cuts( sddp_block );
+   get_cut_processing().remove_redundant_cuts( sddp_block );
 
   // Solve
 
-  if( simulation_mode ) {
-   auto solver = sddp_block->get_registered_solvers().front();
-   if( solver->get_int_par( solver->int_par_str2idx( "intLogVerb" ) ) )
-    solver->set_log( & std::cout );
-   simulate( sddp_block );
-  }
-  else
-   solve( sddp_block );
+  solve_or_simulate( sddp_block );
 
   // Destroy the SDDPBlock and the Configurations
 
@@ -1817,6 +1847,244 @@ std::vector< double > get_final_state( SDDPBlock * block , Index stage ) {
 
 /*--------------------------------------------------------------------------*/
 
+/// changes the current directory, which is restored when it is destroyed
+/** The previous current directory is restored even if an exception is
+ * thrown while the directory is changed; an error while restoring it is
+ * ignored, since it cannot be reported from the destructor. */
+class CurrentPathGuard {
+public:
+ explicit CurrentPathGuard( const std::filesystem::path & directory )
+  : previous( std::filesystem::current_path() ) {
+  std::filesystem::current_path( directory );
+ }
+
+ CurrentPathGuard( const CurrentPathGuard & ) = delete;
+
+ CurrentPathGuard & operator=( const CurrentPathGuard & ) = delete;
+
+ ~CurrentPathGuard() {
+  std::error_code error;
+  std::filesystem::current_path( previous , error );
+ }
+
+private:
+ std::filesystem::path previous;  ///< the directory to be restored
+};
+
+/*--------------------------------------------------------------------------*/
+
+/// solves (or simulates) every SDDPBlock once for each variant of the sweep
+/** Each SDDPBlock in the given BlockFile is deserialized and configured
+ * once, and its cuts are loaded (and possibly pruned) once. Then, for each
+ * variant of the parameter sweep given by the -w option (see
+ * ParameterSweep), the SDDPBlock is configured with the Block and Solver
+ * configurations of the variant (read from memory), its cuts are reset to
+ * the loaded ones (when solving, since a simulation does not change them)
+ * and it is solved (or simulated) in the directory "variant_<v>", which
+ * receives all the output of the variant. */
+void sweep_block_file( const netCDF::NcFile & file ) {
+ std::multimap< std::string , netCDF::NcGroup > blocks = file.getGroups();
+
+ ParameterSweep sweep;
+ try {
+  sweep.load( sweep_filename );
+ }
+ catch( const std::exception & e ) {
+  std::cerr << e.what() << std::endl;
+  exit( 1 );
+ }
+
+ for( const auto & config_filename : sweep.get_filenames() )
+  if( ( ! ParameterSweep::same_file( config_filename ,
+                                     block_config_filename ) ) &&
+      ( ! ParameterSweep::same_file( config_filename ,
+                                     solver_config_filename ) ) ) {
+   std::cerr << "The parameter sweep can only change the configuration files "
+             << "given by the -B\nand -S options, but it changes "
+             << config_filename << "." << std::endl;
+   exit( 1 );
+  }
+
+ const bool sweep_block_config = sweep.has_file( block_config_filename );
+ const bool sweep_solver_config = sweep.has_file( solver_config_filename );
+
+ std::cout << "Parameter sweep with " << sweep.get_number_variants()
+           << " variants." << std::endl;
+
+ // The outputs of each variant are written into its own directory, so the
+ // relative paths to the configuration files must not depend on the
+ // current directory
+
+ const auto working_directory = std::filesystem::current_path();
+ Configuration::set_filename_prefix
+  ( ( working_directory / config_filename_prefix ).string() );
+
+ // BlockConfig
+ auto given_block_config = load_BlockConfig();
+
+ BlockConfig * block_config = nullptr;
+ if( given_block_config ) {
+  block_config = given_block_config->clone();
+  block_config->clear();
+ }
+
+ // BlockSolverConfig
+ bool block_solver_config_provided = true;
+ auto solver_config = load_BlockSolverConfig( solver_config_filename );
+ if( ! solver_config ) {
+  block_solver_config_provided = false;
+  solver_config = build_BlockSolverConfig();
+ }
+
+ auto cleared_solver_config = solver_config->clone();
+ cleared_solver_config->clear();
+
+ const auto is_using_lagrangian_dual_solver =
+  using_lagrangian_dual_solver( solver_config );
+
+ if( is_using_lagrangian_dual_solver && using_thermal_dp_solver
+     ( config_filename_prefix + thermal_config_filename ) )
+  // The ThermalUnitDPSolver cannot currently deal with spinning
+  // reserves. Thus, any reserve that is provided must be ignored.
+  ThermalUnitBlock::ignore_reserve();
+
+ // For each Block descriptor
+ for( auto block_description : blocks ) {
+
+  // Deserialize the SDDPBlock
+
+  auto sddp_block = new SDDPBlock;
+  sddp_block->set_num_sub_blocks_per_stage( num_sub_blocks_per_stage );
+  sddp_block->deserialize( block_description.second );
+
+  // Configure the SDDPBlock
+
+  if( given_block_config )
+   given_block_config->apply( sddp_block );
+  else {
+   configure_Blocks( sddp_block , is_using_lagrangian_dual_solver ,
+                     feasibility_tolerance , relative_violation ,
+                     is_using_lagrangian_dual_solver );
+
+   if( ! block_solver_config_provided ) {
+    block_config = build_BlockConfig( sddp_block );
+    block_config->apply( sddp_block );
+    block_config->clear();
+   }
+  }
+
+  // The cuts are loaded (and possibly pruned) once, in the working
+  // directory (where a relative name of the cut file refers to); when
+  // solving, every variant starts from the same cuts. A simulation does not
+  // change the cuts, so they are not copied.
+
+  load_cuts( sddp_block );
+
+  if( eliminate_redundant_cuts )
+   get_cut_processing().remove_redundant_cuts( sddp_block );
+
+  CutSet cuts;
+  if( ! simulation_mode )
+   cuts = CutSet( sddp_block );
+
+  for( unsigned long variant = 0 ; variant < sweep.get_number_variants() ;
+       ++variant ) {
+
+   std::cout << "Variant " << variant << ": "
+             << sweep.get_description( variant ) << std::endl;
+
+   const auto directory = working_directory /
+    ( "variant_" + std::to_string( variant ) );
+   std::filesystem::create_directories( directory );
+
+   // Configure the SDDPBlock and the Solver for this variant; the modified
+   // configuration files are also written into the directory of the
+   // variant, for reference
+
+   BlockConfig * variant_block_config = nullptr;
+   if( sweep_block_config ) {
+    const auto text = sweep.get_text( block_config_filename , variant );
+    std::ofstream( directory / std::filesystem::path
+                   ( block_config_filename ).filename() ) << text;
+    std::istringstream input( text );
+    variant_block_config = read_BlockConfig( input );
+    variant_block_config->apply( sddp_block );
+   }
+
+   auto variant_solver_config = solver_config;
+   if( sweep_solver_config ) {
+    const auto text = sweep.get_text( solver_config_filename , variant );
+    std::ofstream( directory / std::filesystem::path
+                   ( solver_config_filename ).filename() ) << text;
+    std::istringstream input( text );
+    variant_solver_config = read_BlockSolverConfig( input );
+   }
+
+   if( is_using_lagrangian_dual_solver )
+    config_Lagrangian_dual( variant_solver_config , sddp_block );
+
+   variant_solver_config->apply( sddp_block );
+
+   // Set the output stream for the log of the inner Solvers
+
+   set_log( sddp_block , &std::cout );
+
+   // Every variant but the first one starts from the loaded cuts again
+
+   if( ( variant > 0 ) && ( ! simulation_mode ) )
+    cuts.apply_to( sddp_block );
+
+   // Solve in the directory of the variant; the cuts are already there
+
+   {
+    CurrentPathGuard current_path( directory );
+    solve_or_simulate( sddp_block , false );
+   }
+
+   // Remove the Solvers and restore the configuration of the SDDPBlock
+
+   cleared_solver_config->apply( sddp_block );
+   if( variant_solver_config != solver_config )
+    delete( variant_solver_config );
+
+   if( variant_block_config ) {
+    given_block_config->apply( sddp_block );
+    delete( variant_block_config );
+   }
+  }
+
+  // Destroy the SDDPBlock and the Configurations
+
+  if( block_config )
+   block_config->apply( sddp_block );
+  if( ! given_block_config ) {
+   delete( block_config );
+   block_config = nullptr;
+  }
+
+  delete( sddp_block );
+ }
+
+ delete( block_config );
+ delete( given_block_config );
+ delete( solver_config );
+ delete( cleared_solver_config );
+}
+
+/*--------------------------------------------------------------------------*/
+
+/// returns the random number engine of the i-th independent simulation
+/** Returns the random number engine to be used by the i-th simulation when
+ * the simulations are independent (-I option). Its seed only depends on i,
+ * so that each simulation has its own stream of random numbers and the
+ * results do not depend on how the simulations are distributed. */
+std::mt19937 get_simulation_engine( long i ) {
+ std::seed_seq seed{ std::uint32_t( i ) , std::uint32_t( i >> 16 >> 16 ) };
+ return( std::mt19937( seed ) );
+}
+
+/*--------------------------------------------------------------------------*/
+
 void multiple_simulations( const netCDF::NcFile & file ) {
  std::multimap< std::string , netCDF::NcGroup > blocks = file.getGroups();
 
@@ -1857,10 +2125,50 @@ void multiple_simulations( const netCDF::NcFile & file ) {
   std::mt19937 random_number_engine;
   std::vector< double > initial_state;
 
+  // The trial points of each simulation are used as sample points when
+  // eliminating the redundant cuts of the following ones
+
+  auto cut_processing = get_cut_processing();
+
+  // The cuts of the first simulation, if they must be reused
+
+  CutSet template_cuts;
+  bool has_template_cuts = false;
+
+  // The bounds of each simulation, when they are independent
+
+  std::vector< double > lower_bounds;
+  std::vector< double > upper_bounds;
+
+  long rank = 0;
+  long num_ranks = 1;
+
+  if( independent_simulations ) {
+   lower_bounds.assign( number_simulations , 0 );
+   upper_bounds.assign( number_simulations , 0 );
+#ifdef USE_MPI
+   boost::mpi::communicator world;
+   rank = world.rank();
+   num_ranks = world.size();
+#endif
+  }
+
   for( long i = 0 ; i < number_simulations ; ++i ) {
 
+   // Independent simulations are distributed among the MPI processes
+
+   if( independent_simulations && ( i % num_ranks != rank ) )
+    continue;
+
    std::cout << "Simulation " << i << "." << std::endl;
 
+   // The bounds of an independent simulation are NaN until it succeeds
+
+   if( independent_simulations ) {
+    lower_bounds[ i ] = std::numeric_limits< double >::quiet_NaN();
+    upper_bounds[ i ] = std::numeric_limits< double >::quiet_NaN();
+   }
+
    /* In the simulation, Blocks of two consecutive stages are linked in such a
     * way that the final state of the system at one stage affects the system
     * at the next stage. For example, the initial volumes of the reservoirs
@@ -1884,7 +2192,10 @@ void multiple_simulations( const netCDF::NcFile & file ) {
     *
     * This prevents us from reusing the same Blocks in different simulations
     * and, thus, the Blocks are created at the beginning of each
-    * simulation. */
+    * simulation. What can be reused are the cuts: if the -u option is used,
+    * the cuts are loaded (and possibly pruned) only for the first
+    * simulation, and the resulting cuts of every PolyhedralFunction are kept
+    * in memory and given to the SDDPBlocks of the following simulations. */
 
    // Deserialize the SDDPBlock
 
@@ -1937,11 +2248,16 @@ void multiple_simulations( const netCDF::NcFile & file ) {
    auto subgradients_filename_prefix =
     solver->get_str_par( SDDPGreedySolver::strSimulationData );
 
-   solver->set_callback( [ sddp_block ]( Index stage ) {
-    callback( sddp_block , stage );
-   });
+   solver->set_callback
+    ( [ plan = std::make_shared< StageLinkingPlan >( sddp_block ) ]
+      ( Index stage ) {
+     callback( *plan , stage );
+    } );
 
-   if( i > 0 ) {
+   if( independent_simulations )
+    // Each simulation has its own random number engine
+    solver->set_random_number_engine( get_simulation_engine( i ) );
+   else if( i > 0 ) {
     // Set the random number engine
     solver->set_random_number_engine( random_number_engine );
 
@@ -1953,15 +2269,24 @@ void multiple_simulations( const netCDF::NcFile & file ) {
     }
    }
 
-   // Load possibly given cuts
+   if( reuse_setup && has_template_cuts )
+    // Reuse the cuts of the first simulation
+    template_cuts.apply_to( sddp_block );
+   else {
+    // Load possibly given cuts
 
-   if( ! cuts_filename.empty() )
-    solver->set_par( SDDPGreedySolver::strLoadCuts , cuts_filename );
+    load_cuts( sddp_block );
 
-   // Eliminate redundant cuts if it is desired
+    // Eliminate redundant cuts if it is desired
 
-   if( eliminate_redundant_cuts )
-    CutProcessing().remove_redundant_cuts( sddp_block );
+    if( eliminate_redundant_cuts )
+     cut_processing.remove_redundant_cuts( sddp_block );
+
+    if( reuse_setup ) {
+     template_cuts = CutSet( sddp_block );
+     has_template_cuts = true;
+    }
+   }
 
    // Set the name of the file that will output the subgradients
 
@@ -1974,16 +2299,22 @@ void multiple_simulations( const netCDF::NcFile & file ) {
    while( true ) {
 
     // Simulate
+    Profiler::ScopedTimer compute_timer( "simulate" , i );
     const auto status = solver->compute();
+    compute_timer.stop();
 
     if( solver->has_var_solution() ) {
      // A feasible solution has been found
 
-     if( set_initial_state ) {
+     if( set_initial_state || eliminate_redundant_cuts )
       // Retrieve the solution
       solver->get_var_solution();
+
+     if( set_initial_state )
       initial_state = get_final_state( sddp_block , initial_solution_stage );
-     }
+
+     if( eliminate_redundant_cuts )
+      cut_processing.add_sample_points( sddp_block );
 
      // Save the random number engine
      random_number_engine = solver->get_random_number_engine();
@@ -1995,6 +2326,19 @@ void multiple_simulations( const netCDF::NcFile & file ) {
      std::cout << "Lower bound: " << std::setprecision( 20 ) << lb << std::endl;
      std::cout << "Upper bound: " << std::setprecision( 20 ) << ub << std::endl;
 
+     if( independent_simulations ) {
+      lower_bounds[ i ] = lb;
+      upper_bounds[ i ] = ub;
+     }
+
+     break;
+    }
+
+    if( independent_simulations ) {
+     // An independent simulation is not tried again: it is reported as
+     // failed, and so are its bounds (NaN)
+     show_simulation_status( status , solver->get_fault_stage() );
+     std::cout << "Simulation " << i << " failed." << std::endl;
      break;
     }
    }
@@ -2012,6 +2356,41 @@ void multiple_simulations( const netCDF::NcFile & file ) {
    delete( sddp_block );
 
   }
+
+  if( independent_simulations ) {
+
+   // Gather the bounds of all simulations (each one has been computed by a
+   // single process, the others having 0) and output them in order. The
+   // bounds of a failed simulation are NaN, and the exit status is then 1.
+
+#ifdef USE_MPI
+   boost::mpi::communicator world;
+   for( auto bounds : { & lower_bounds , & upper_bounds } ) {
+    std::vector< double > values( bounds->size() );
+    boost::mpi::all_reduce( world , bounds->data() , int( bounds->size() ) ,
+                            values.data() , std::plus< double >() );
+    * bounds = std::move( values );
+   }
+#endif
+
+   if( rank == 0 ) {
+    std::cout << "Simulation,LowerBound,UpperBound" << std::endl;
+    for( long i = 0 ; i < number_simulations ; ++i )
+     std::cout << i << "," << std::setprecision( 20 ) << lower_bounds[ i ]
+               << "," << std::setprecision( 20 ) << upper_bounds[ i ]
+               << std::endl;
+   }
+
+   const auto number_failed =
+    std::count_if( lower_bounds.begin() , lower_bounds.end() ,
+                   []( double bound ) { return( std::isnan( bound ) ); } );
+   if( number_failed > 0 ) {
+    if( rank == 0 )
+     std::cout << number_failed << " of " << number_simulations
+               << " simulations failed." << std::endl;
+    exit_status = 1;
+   }
+  }
  }
 
  delete( block_config );
@@ -2051,6 +2430,11 @@ int main( int argc , char ** argv ) {
 
  switch( type ) {
   case eProbFile: {
+   if( ! sweep_filename.empty() ) {
+    std::cerr << "The -w option requires a block file, but " << filename
+              << " is a problem file." << std::endl;
+    exit( 1 );
+   }
    std::cout << filename << " is a problem file, "
     "ignoring Block/Solver configurations..." << std::endl;
    process_prob_file( file );
@@ -2062,6 +2446,8 @@ int main( int argc , char ** argv ) {
 
    if( simulation_mode && ( number_simulations > 1 ) )
     multiple_simulations( file );
+   else if( ! sweep_filename.empty() )
+    sweep_block_file( file );
    else
     process_block_file( file );
 
@@ -2074,5 +2460,26 @@ int main( int argc , char ** argv ) {
  }
 
  file.close();
- return( 0 );
+
+ // Possibly write the timings and counters of this process
+
+ if( ! profile_filename.empty() ) {
+  int rank = 0;
+  int size = 1;
+#ifdef USE_MPI
+  boost::mpi::communicator world;
+  rank = world.rank();
+  size = world.size();
+#endif
+  try {
+   Profiler::write_report( Profiler::get_filename( profile_filename , rank ,
+                                                   size ) );
+  }
+  catch( const std::exception & e ) {
+   std::cerr << e.what() << std::endl;
+   exit( 1 );
+  }
+ }
+
+ return( exit_status );
 }
@@ -0,0 +1,222 @@
+/*--------------------------------------------------------------------------*/
+/*--------------------------- File CSVWriter.h -----------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ * Header file of CSVWriter, a buffered writer for the CSV files produced by
+ * UCBlockSolutionOutput.
+ *
+ * \author Rafael Durbano Lobato \n
+ *         Dipartimento di Informatica \n
+ *         Universita' di Pisa \n
+ *
+ * \copyright &copy; by Rafael Durbano Lobato
+ */
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __CSVWriter
+#define __CSVWriter
+                      /* self-identification: #endif at the end of the file */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------------ INCLUDES ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- CLASS CSVWriter ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+/*--------------------------- GENERAL NOTES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/// a buffered writer for CSV files
+/** The CSVWriter class writes a file through a (large) user-space buffer,
+ * which is handed to the underlying std::ofstream only when it is full and
+ * when the file is closed, so that the file is flushed once. Its interface
+ * mimics the one of std::ostream for the few types that are needed to write
+ * a CSV file: characters, strings, bools (written as 1 or 0), integers, and
+ * floating-point values. The latter are formatted with std::to_chars() using
+ * the shortest representation that reads back to the very same value (a
+ * 17-digit representation is used if the standard library does not provide
+ * std::to_chars() for floating-point values).
+ *
+ * The buffer is provided by the user, so that the same memory can be reused
+ * for writing many files. The buffer must not be used by anyone else while
+ * the CSVWriter is alive. */
+
+class CSVWriter {
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+public:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// size of the buffer if the given one is smaller
+ static constexpr std::size_t default_buffer_size = std::size_t( 1 ) << 22;
+
+/*--------------------------------------------------------------------------*/
+
+ /// opens the file with the given name using the given buffer
+ /** Opens the file with the given name and mode (see std::ofstream). If the
+  * given \p buffer has less than #default_buffer_size elements, it is
+  * resized to #default_buffer_size. As for std::ofstream, nothing is written
+  * if the file cannot be opened. */
+
+ CSVWriter( const std::string & filename , std::ios_base::openmode mode ,
+            std::vector< char > & buffer )
+  : output( filename , mode | std::ios::binary ) {
+  if( buffer.size() < default_buffer_size )
+   buffer.resize( default_buffer_size );
+  begin = buffer.data();
+  position = begin;
+  end = begin + buffer.size();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ CSVWriter( const CSVWriter & ) = delete;
+
+ CSVWriter & operator=( const CSVWriter & ) = delete;
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the content of the buffer and closes the file
+ ~CSVWriter() {
+  if( output.is_open() )
+   write_buffer();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ CSVWriter & operator<<( char c ) {
+  if( position == end )
+   write_buffer();
+  *(position++) = c;
+  return( *this );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ CSVWriter & operator<<( std::string_view s ) {
+  if( std::size_t( end - position ) < s.size() ) {
+   write_buffer();
+   if( std::size_t( end - position ) < s.size() ) {
+    output.write( s.data() , s.size() );
+    return( *this );
+   }
+  }
+  std::memcpy( position , s.data() , s.size() );
+  position += s.size();
+  return( *this );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ CSVWriter & operator<<( const std::string & s ) {
+  return( *this << std::string_view( s ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ CSVWriter & operator<<( const char * s ) {
+  return( *this << std::string_view( s ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes a bool as 1 or 0, like std::ostream does by default
+ CSVWriter & operator<<( bool value ) {
+  return( *this << ( value ? '1' : '0' ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes an integer or a floating-point value
+ template< class T >
+ std::enable_if_t< std::is_arithmetic_v< T > &&
+                   ( ! std::is_same_v< T , bool > ) &&
+                   ( ! std::is_same_v< T , char > ) , CSVWriter & >
+ operator<<( T value ) {
+  if( std::size_t( end - position ) < max_number_length )
+   write_buffer();
+
+  if constexpr( std::is_integral_v< T > )
+   position = std::to_chars( position , end , value ).ptr;
+  else {
+#if defined( __cpp_lib_to_chars ) && ( __cpp_lib_to_chars >= 201611L )
+   position = std::to_chars( position , end , double( value ) ).ptr;
+#else
+   position += std::snprintf( position , max_number_length , "%.17g" ,
+                              double( value ) );
+#endif
+  }
+  return( *this );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// writes the content of the buffer and closes the file
+ void close() {
+  if( ! output.is_open() )
+   return;
+  write_buffer();
+  output.close();
+ }
+
+/*--------------------------------------------------------------------------*/
+/*--------------------- PRIVATE PART OF THE CLASS --------------------------*/
+/*--------------------------------------------------------------------------*/
+
+private:
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- PRIVATE METHODS ------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ void write_buffer() {
+  output.write( begin , position - begin );
+  position = begin;
+ }
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PRIVATE FIELDS  -----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// an upper bound on the length of a formatted number
+ static constexpr std::size_t max_number_length = 32;
+
+ std::ofstream output;  ///< the file being written
+
+ char * begin;          ///< the beginning of the buffer
+
+ char * position;       ///< the first free position of the buffer
+
+ char * end;            ///< the end of the buffer
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+};  // end( class CSVWriter )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* CSVWriter.h included */
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ End File CSVWriter.h ----------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -127,6 +127,20 @@
  * - pz+1 is the number of zones for pollutant p and v_j is the dual value of
  *   the constraint associated with zone j.
  *
+ * The headers of two files are kept as they have always been written, since
+ * the tools reading these files rely on them: in NodeInjectionOUT.csv, the
+ * index of each node is appended to its name, and in the MarginalPollutant
+ * files every zone is called Zone_0 (and the header starts with a
+ * separator). The Tables (see for_each_table()), and hence the netCDF
+ * output, have the actual names of the columns.
+ *
+ * Every file is written through a CSVWriter, so that it is flushed once and
+ * the values are written with the shortest representation that reads back
+ * to the very same value. The names of the columns are computed once and
+ * cached, so that a UCBlockSolutionOutput is meant to be used for UCBlocks
+ * sharing the same structure, such as the UCBlocks of the stages of an
+ * SDDPBlock (see clear_cache()).
+ *
  * \author Rafael Durbano Lobato \n
  *         Dipartimento di Informatica \n
  *         Universita' di Pisa \n
@@ -150,6 +164,7 @@
 /*--------------------------------------------------------------------------*/
 
 #include "BatteryUnitBlock.h"
+#include "CSVWriter.h"
 #include "DCNetworkBlock.h"
 #include "HydroSystemUnitBlock.h"
 #include "IntermittentUnitBlock.h"
@@ -157,9 +172,13 @@
 #include "ThermalUnitBlock.h"
 #include "UCBlock.h"
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 /*--------------------------------------------------------------------------*/
 /*--------------------------- NAMESPACE ------------------------------------*/
@@ -188,12 +207,17 @@ class UCBlockSolutionOutput
 
 /*--------------------------------------------------------------------------*/
 /*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ /// the suffix of the names of the files, unless set_filenames_suffix()
+ static constexpr const char * default_filenames_suffix = "OUT.csv";
+
 /*--------------------------------------------------------------------------*/
 
  UCBlockSolutionOutput() {
   filenames.resize( number_of_files );
 
-  auto extension = "OUT.csv";
+  auto extension = default_filenames_suffix;
 
   // Variables
 
@@ -219,15 +243,38 @@ class UCBlockSolutionOutput
   filenames[ flow_rate ] = { "FlowRate" , extension };
   filenames[ node_injection ] = { "NodeInjection" , extension };
 
+  column_names.resize( number_of_column_kinds );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_flow( const UCBlock * uc_block ) const {
+ /// the values of one of the quantities of the solution of a UCBlock
+ /** A Table holds the values of one of the quantities that are output (e.g.,
+  * the active power of the generators). The values are stored row by row in
+  * #values: each row is associated with a time step (or, for the maximum
+  * pollutant emission constraints, with a pollutant) and each column with
+  * an element of the UCBlock (e.g., a generator) whose name is given by
+  * #column_names. If #column_names is nullptr, the quantity is not defined
+  * for the UCBlock (e.g., it has no NetworkBlock) and nothing is output. */
 
-  const auto & blocks = uc_block->get_network_blocks();
+ struct Table
+ {
+  Index file = 0;                     ///< the file of the quantity
+  const char * row_dimension = "";    ///< what the rows are (e.g., "time")
+  const char * column_dimension = ""; ///< what the columns are
+  const std::vector< std::string > * column_names = nullptr;
+                                      ///< the names of the columns
+  Index first_row = 0;                ///< the time step of the first row
+  Index rows = 0;                     ///< the number of rows
+  Index columns = 0;                  ///< the number of columns
+  std::vector< double > values;       ///< the values, row by row
+ };
 
-  std::ofstream output( filenames[ flow ].name() , open_mode() );
+/*--------------------------------------------------------------------------*/
+
+ void get_flow( const UCBlock * uc_block , Table & table ) const {
+
+  const auto & blocks = uc_block->get_network_blocks();
 
   auto get_power_flow =
    []( NetworkBlock * block , Index line ) -> double {
@@ -239,30 +286,20 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  std::function< std::string( Index ) > get_line_name = []( Index line ) {
-   return( "Line_" + std::to_string( line ) );
-  };
-
-  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
-   uc_block->get_NetworkData() ) ) {
-   const auto & line_names = network_data->get_line_names();
-   if( ! line_names.empty() )
-    get_line_name = [ &line_names ]( Index line ) {
-     assert( line < line_names.size() );
-     return( line_names[ line ] );
-    };
-  }
+  table.file = flow;
+  get_line_data( table , uc_block , blocks , get_power_flow );
+ }
 
-  print_line_data( output , blocks , get_power_flow , get_line_name );
+/*--------------------------------------------------------------------------*/
 
-  output.close();
+ void print_flow( const UCBlock * uc_block ) const {
+  get_flow( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_node_injection( const UCBlock * uc_block ) const {
-
-  std::ofstream output( filenames[ node_injection ].name() , open_mode() );
+ void get_node_injection( const UCBlock * uc_block , Table & table ) const {
 
   auto get_node_injection =
    []( NetworkBlock * block , Index node ) -> double {
@@ -274,17 +311,20 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_node_data( output , uc_block , get_node_injection );
-
-  output.close();
+  table.file = node_injection;
+  get_node_data( table , uc_block , get_node_injection );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_node_injection_duals( UCBlock * uc_block ) const {
+ void print_node_injection( const UCBlock * uc_block ) const {
+  get_node_injection( uc_block , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ marginal_cost_active_power_demand ].name() ,
-                        open_mode() );
+ void get_node_injection_duals( UCBlock * uc_block , Table & table ) const {
 
   auto get_node_injection_dual =
    []( UCBlock * block , Index time , Index node ) -> double {
@@ -294,19 +334,22 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_data( output , uc_block , get_node_injection_dual ,
-              get_number_nodes( uc_block ) );
+  table.file = marginal_cost_active_power_demand;
+  get_time_data( table , uc_block , get_node_injection_dual ,
+                 get_number_nodes( uc_block ) );
+ }
 
-  output.close();
+/*--------------------------------------------------------------------------*/
+
+ void print_node_injection_duals( UCBlock * uc_block ) const {
+  get_node_injection_duals( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
 
  /// dual values for the primary demand constraints
- void print_primary_demand_duals( UCBlock * uc_block ) const {
-
-  std::ofstream output( filenames[ marginal_cost_primary ].name() ,
-                        open_mode() );
+ void get_primary_demand_duals( UCBlock * uc_block , Table & table ) const {
 
   auto get_primary_demand_dual =
    []( UCBlock * block , Index time , Index zone ) -> double {
@@ -316,19 +359,24 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_data( output , uc_block , get_primary_demand_dual ,
-              uc_block->get_number_primary_zones() ,
-              []( Index i ) { return( "Zone_" + std::to_string( i ) ); } );
+  const auto number_zones = uc_block->get_number_primary_zones();
+  table.file = marginal_cost_primary;
+  get_time_data( table , uc_block , get_primary_demand_dual , number_zones ,
+                 "primary_zone" , get_zone_names( number_zones ) );
+ }
 
-  output.close();
+/*--------------------------------------------------------------------------*/
+
+ /// dual values for the primary demand constraints
+ void print_primary_demand_duals( UCBlock * uc_block ) const {
+  get_primary_demand_duals( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
 
  /// dual values for the secondary demand constraints
- void print_secondary_demand_duals( UCBlock * uc_block ) const {
-  std::ofstream output( filenames[ marginal_cost_secondary ].name() ,
-                        open_mode() );
+ void get_secondary_demand_duals( UCBlock * uc_block , Table & table ) const {
 
   auto get_secondary_demand_dual =
    []( UCBlock * block , Index time , Index zone ) -> double {
@@ -338,19 +386,24 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_data( output , uc_block , get_secondary_demand_dual ,
-              uc_block->get_number_secondary_zones() ,
-              []( Index i ) { return( "Zone_" + std::to_string( i ) ); } );
+  const auto number_zones = uc_block->get_number_secondary_zones();
+  table.file = marginal_cost_secondary;
+  get_time_data( table , uc_block , get_secondary_demand_dual , number_zones ,
+                 "secondary_zone" , get_zone_names( number_zones ) );
+ }
 
-  output.close();
+/*--------------------------------------------------------------------------*/
+
+ /// dual values for the secondary demand constraints
+ void print_secondary_demand_duals( UCBlock * uc_block ) const {
+  get_secondary_demand_duals( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
 
  /// dual values for the inertia demand constraints
- void print_inertia_demand_duals( UCBlock * uc_block ) const {
-  std::ofstream output( filenames[ marginal_cost_inertia ].name() ,
-                        open_mode() );
+ void get_inertia_demand_duals( UCBlock * uc_block , Table & table ) const {
 
   auto get_inertia_demand_dual =
    []( UCBlock * block , Index time , Index zone ) -> double {
@@ -360,46 +413,65 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_data( output , uc_block , get_inertia_demand_dual ,
-              uc_block->get_number_inertia_zones() ,
-              []( Index i ) { return( "Zone_" + std::to_string( i ) ); } );
+  const auto number_zones = uc_block->get_number_inertia_zones();
+  table.file = marginal_cost_inertia;
+  get_time_data( table , uc_block , get_inertia_demand_dual , number_zones ,
+                 "inertia_zone" , get_zone_names( number_zones ) );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  output.close();
+ /// dual values for the inertia demand constraints
+ void print_inertia_demand_duals( UCBlock * uc_block ) const {
+  get_inertia_demand_duals( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
 
  /// dual values for the maximum pollutant emission constraints
- void print_maximum_pollutant_emission_duals( UCBlock * uc_block ) const {
+ /** Each row of the Table is associated with a pollutant. Since the number
+  * of zones may depend on the pollutant, the number of columns is the
+  * largest number of zones and the missing values are NaN. */
+
+ void get_maximum_pollutant_emission_duals( UCBlock * uc_block ,
+                                            Table & table ) const {
 
   const auto number_pollutants = uc_block->get_number_pollutants();
+  const auto & number_zones = uc_block->get_number_pollutant_zones();
+  const auto & constraints = uc_block->get_pollutant_constraints();
 
-  for( Index p = 0 ; p < number_pollutants ; ++p ) {
+  Index max_number_zones = 0;
+  for( Index p = 0 ; p < number_pollutants ; ++p )
+   max_number_zones = std::max< Index >( max_number_zones ,
+                                         number_zones[ p ] );
 
-   std::ofstream output( get_marginal_pollutant_filename( p ) , open_mode() );
+  table.file = marginal_pollutant;
+  set_table( table , "pollutant" , "pollutant_zone" ,
+             & get_zone_names( max_number_zones ) , 0 , number_pollutants ,
+             max_number_zones );
 
-   // Header
+  std::fill( table.values.begin() , table.values.end() ,
+             std::numeric_limits< double >::quiet_NaN() );
 
-   for( Index z = 0 ; z < uc_block->get_number_pollutant_zones()[ p ] ; ++z )
-    output << separator_character << "Zone_" << 0;
-   output << std::endl;
+  for( Index p = 0 ; p < number_pollutants ; ++p )
+   for( Index z = 0 ; z < number_zones[ p ] ; ++z )
+    table.values[ p * max_number_zones + z ] = constraints[ p ][ z ].get_dual();
+ }
 
-   // Values
-   for( Index z = 0 ; z < uc_block->get_number_pollutant_zones()[ p ] ; ++z ) {
-    if( z > 0 ) output << separator_character;
-    output << uc_block->get_pollutant_constraints()[ p ][ z ].get_dual();
-   }
+/*--------------------------------------------------------------------------*/
 
-   output.close();
-  }
+ /// dual values for the maximum pollutant emission constraints
+ void print_maximum_pollutant_emission_duals( UCBlock * uc_block ) const {
+
+  get_maximum_pollutant_emission_duals( uc_block , table );
+  print_pollutant_table( table , uc_block->get_number_pollutant_zones() );
  }
 
 /*--------------------------------------------------------------------------*/
 
  /// dual values for the power flow limit constraints
- void print_power_flow_limit_duals( UCBlock * uc_block ) const {
-
-  std::ofstream output( filenames[ marginal_cost_flows ].name() , open_mode() );
+ void get_power_flow_limit_duals( UCBlock * uc_block , Table & table ) const {
 
   auto get_power_flow_limit_dual =
    []( NetworkBlock * block , Index line ) -> double {
@@ -420,24 +492,17 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  std::function< std::string( Index ) > get_line_name = []( Index line ) {
-   return( "Line_" + std::to_string( line ) );
-  };
-
-  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
-   uc_block->get_NetworkData() ) ) {
-   const auto & line_names = network_data->get_line_names();
-   if( ! line_names.empty() )
-    get_line_name = [ &line_names ]( Index line ) {
-     assert( line < line_names.size() );
-     return( line_names[ line ] );
-    };
-  }
+  table.file = marginal_cost_flows;
+  get_line_data( table , uc_block , uc_block->get_network_blocks() ,
+                 get_power_flow_limit_dual );
+ }
 
-  print_line_data( output , uc_block->get_network_blocks() ,
-                   get_power_flow_limit_dual , get_line_name );
+/*--------------------------------------------------------------------------*/
 
-  output.close();
+ /// dual values for the power flow limit constraints
+ void print_power_flow_limit_duals( UCBlock * uc_block ) const {
+  get_power_flow_limit_duals( uc_block , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
@@ -453,9 +518,7 @@ class UCBlockSolutionOutput
 
 /*--------------------------------------------------------------------------*/
 
- void print_demand( UCBlock * block ) const {
-
-  std::ofstream output( filenames[ demand ].name() , open_mode() );
+ void get_demand( UCBlock * block , Table & table ) const {
 
   auto get_demand =
    []( UCBlock * block , Index time , Index node ) {
@@ -470,16 +533,21 @@ class UCBlockSolutionOutput
     }
    };
 
-  print_data( output , block , get_demand , get_number_nodes( block ) );
-
-  output.close();
+  table.file = demand;
+  get_time_data( table , block , get_demand , get_number_nodes( block ) );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_active_power( const std::vector< UnitBlock * > & blocks ) const {
+ void print_demand( UCBlock * block ) const {
+  get_demand( block , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ active_power ].name() , open_mode() );
+ void get_active_power( const std::vector< UnitBlock * > & blocks ,
+                        Table & table ) const {
 
   auto get_active_power =
    []( UnitBlock * block , Index g , Index t ) -> double {
@@ -488,33 +556,41 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_generator_data( output , blocks , get_active_power );
-
-  output.close();
+  table.file = active_power;
+  get_generator_data( table , blocks , get_active_power );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_max_power( const std::vector< UnitBlock * > & blocks ) const {
+ void print_active_power( const std::vector< UnitBlock * > & blocks ) const {
+  get_active_power( blocks , table );
+  print_table( table );
+ }
 
-  std::ofstream output( filenames[ max_power ].name() , open_mode() );
+/*--------------------------------------------------------------------------*/
+
+ void get_max_power( const std::vector< UnitBlock * > & blocks ,
+                     Table & table ) const {
 
   auto get_max_power = []( UnitBlock * block , Index g , Index t ) {
    return( block->get_max_power( t , g ) );
   };
 
-  print_generator_data( output , blocks , get_max_power );
-
-  output.close();
+  table.file = max_power;
+  get_generator_data( table , blocks , get_max_power );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_primary_spinning_reserve(
-  const std::vector< UnitBlock * > & blocks ) const {
+ void print_max_power( const std::vector< UnitBlock * > & blocks ) const {
+  get_max_power( blocks , table );
+  print_table( table );
+ }
 
-  std::ofstream output( filenames[ primary_spinning_reserve ].name() ,
-                        open_mode() );
+/*--------------------------------------------------------------------------*/
+
+ void get_primary_spinning_reserve( const std::vector< UnitBlock * > & blocks ,
+                                    Table & table ) const {
 
   auto get_primary_spinning_reserve =
    []( UnitBlock * block , Index g , Index t ) -> double {
@@ -523,18 +599,22 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_generator_data( output , blocks , get_primary_spinning_reserve );
-
-  output.close();
+  table.file = primary_spinning_reserve;
+  get_generator_data( table , blocks , get_primary_spinning_reserve );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_secondary_spinning_reserve(
+ void print_primary_spinning_reserve(
   const std::vector< UnitBlock * > & blocks ) const {
+  get_primary_spinning_reserve( blocks , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ secondary_spinning_reserve ].name() ,
-                        open_mode() );
+ void get_secondary_spinning_reserve(
+  const std::vector< UnitBlock * > & blocks , Table & table ) const {
 
   auto get_secondary_spinning_reserve =
    []( UnitBlock * block , Index g , Index t ) -> double {
@@ -543,16 +623,22 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_generator_data( output , blocks , get_secondary_spinning_reserve );
-
-  output.close();
+  table.file = secondary_spinning_reserve;
+  get_generator_data( table , blocks , get_secondary_spinning_reserve );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_volume( const std::vector< HydroUnitBlock * > & blocks ) const {
+ void print_secondary_spinning_reserve(
+  const std::vector< UnitBlock * > & blocks ) const {
+  get_secondary_spinning_reserve( blocks , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ volume ].name() , open_mode() );
+ void get_volume( const std::vector< HydroUnitBlock * > & blocks ,
+                  Table & table ) const {
 
   auto get_volume =
    []( HydroUnitBlock * block , Index r , Index t ) -> double {
@@ -561,16 +647,21 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_reservoir_data( output , blocks , get_volume );
-
-  output.close();
+  table.file = volume;
+  get_reservoir_data( table , blocks , get_volume );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_inflows( const std::vector< HydroUnitBlock * > & blocks ) const {
+ void print_volume( const std::vector< HydroUnitBlock * > & blocks ) const {
+  get_volume( blocks , table );
+  print_table( table );
+ }
 
-  std::ofstream output( filenames[ inflow ].name() , open_mode() );
+/*--------------------------------------------------------------------------*/
+
+ void get_inflows( const std::vector< HydroUnitBlock * > & blocks ,
+                   Table & table ) const {
 
   auto get_inflow =
    []( HydroUnitBlock * block , Index r , Index t ) -> double {
@@ -580,16 +671,21 @@ class UCBlockSolutionOutput
     return( 0 );
    };
 
-  print_reservoir_data( output , blocks , get_inflow );
-
-  output.close();
+  table.file = inflow;
+  get_reservoir_data( table , blocks , get_inflow );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_flow_rate( const std::vector< HydroUnitBlock * > & blocks ) const {
+ void print_inflows( const std::vector< HydroUnitBlock * > & blocks ) const {
+  get_inflows( blocks , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ flow_rate ].name() , open_mode() );
+ void get_flow_rate( const std::vector< HydroUnitBlock * > & blocks ,
+                     Table & table ) const {
 
   auto get_flow_rate =
    []( UnitBlock * block , Index g , Index t ) -> double {
@@ -604,16 +700,22 @@ class UCBlockSolutionOutput
   for( auto block : blocks )
    unit_blocks.push_back( block );
 
-  print_generator_data( output , unit_blocks , get_flow_rate );
-
-  output.close();
+  table.file = flow_rate;
+  get_generator_data( table , unit_blocks , get_flow_rate ,
+                      hydro_unit_columns );
  }
 
 /*--------------------------------------------------------------------------*/
 
- void print_storage( const std::vector< UnitBlock * > & blocks ) const {
+ void print_flow_rate( const std::vector< HydroUnitBlock * > & blocks ) const {
+  get_flow_rate( blocks , table );
+  print_table( table );
+ }
+
+/*--------------------------------------------------------------------------*/
 
-  std::ofstream output( filenames[ volume ].name() , open_mode() );
+ void get_storage( const std::vector< UnitBlock * > & blocks ,
+                   Table & table ) const {
 
   auto get_storage =
    []( UnitBlock * block , Index r , Index t ) -> double {
@@ -632,9 +734,15 @@ class UCBlockSolutionOutput
       block->classname() ) );
    };
 
-  print_storage_data( output , blocks , get_storage );
+  table.file = volume;
+  get_storage_data( table , blocks , get_storage );
+ }
 
-  output.close();
+/*--------------------------------------------------------------------------*/
+
+ void print_storage( const std::vector< UnitBlock * > & blocks ) const {
+  get_storage( blocks , table );
+  print_table( table );
  }
 
 /*--------------------------------------------------------------------------*/
@@ -653,6 +761,85 @@ class UCBlockSolutionOutput
   }
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// calls the given function with each Table of the solution of a Block
+ /** Calls \p function (as function( table ), with a const Table &) with
+  * each Table of the data that print() outputs for the given Block, in the
+  * same order. The Table is only valid during the call and it is reused by
+  * the subsequent calls. */
+
+ template< class F >
+ void for_each_table( Block * block , const F & function ) const {
+  if( auto uc_block = dynamic_cast< UCBlock * >( block ) ) {
+   auto unit_blocks = get_unit_blocks( uc_block );
+   get_active_power( unit_blocks , table );
+   function( std::as_const( table ) );
+   get_primary_spinning_reserve( unit_blocks , table );
+   function( std::as_const( table ) );
+   get_secondary_spinning_reserve( unit_blocks , table );
+   function( std::as_const( table ) );
+   get_storage( get_unit_blocks_with_storage( uc_block ) , table );
+   function( std::as_const( table ) );
+   get_flow( uc_block , table );
+   function( std::as_const( table ) );
+   get_power_flow_limit_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_node_injection_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_primary_demand_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_secondary_demand_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_inertia_demand_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_maximum_pollutant_emission_duals( uc_block , table );
+   function( std::as_const( table ) );
+   get_demand( uc_block , table );
+   function( std::as_const( table ) );
+   get_max_power( unit_blocks , table );
+   function( std::as_const( table ) );
+  }
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// prints the given Table into its CSV file(s)
+ /** Prints the given Table, as obtained by for_each_table() (possibly for
+  * another UCBlockSolutionOutput), into the CSV file(s) of its quantity,
+  * according to the current suffix and append mode. The Table of the
+  * maximum pollutant emission duals is printed into one file per pollutant,
+  * whose number of zones is given by the values that are not NaN at the end
+  * of its row. */
+
+ void print( const Table & table ) const {
+  if( table.file != marginal_pollutant ) {
+   print_table( table );
+   return;
+  }
+
+  std::vector< Index > number_zones( table.rows , table.columns );
+  for( Index p = 0 ; p < table.rows ; ++p )
+   while( ( number_zones[ p ] > 0 ) &&
+          std::isnan( table.values[ p * table.columns +
+                                    number_zones[ p ] - 1 ] ) )
+    --number_zones[ p ];
+
+  print_pollutant_table( table , number_zones );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// returns the name of the quantity of the given Table
+ /** Returns the name of the quantity of the given Table, which is the prefix
+  * of the name of the file in which it is printed (e.g., "ActivePower"). */
+
+ std::string get_table_name( const Table & table ) const {
+  if( table.file == marginal_pollutant )
+   return( "MarginalPollutant" );
+  return( filenames[ table.file ].prefix );
+ }
+
 /*--------------------------------------------------------------------------*/
 
  void set_separator_character( char separator_character ) {
@@ -678,6 +865,35 @@ class UCBlockSolutionOutput
   this->initial_time = initial_time;
  }
 
+/*--------------------------------------------------------------------------*/
+
+ /// restores the default settings, keeping the buffer and the cached names
+ /** Restores the default separator character, suffix of the names of the
+  * files, append mode and initial time, so that the same
+  * UCBlockSolutionOutput (with the memory of its buffer and its cached
+  * names) can be used for many outputs. */
+
+ void reset_settings() {
+  separator_character = ',';
+  append = false;
+  initial_time = 0;
+  set_filenames_suffix( default_filenames_suffix );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// forgets the cached names of the columns
+ /** The names of the columns (e.g., the names of the generators or of the
+  * lines) are computed the first time they are needed and then reused for
+  * every UCBlock having the same number of columns of that kind. This must
+  * be called before printing a UCBlock whose structure differs from the one
+  * of the previously printed UCBlocks but has the same number of columns. */
+
+ void clear_cache() {
+  for( auto & names : column_names )
+   names.clear();
+ }
+
 /*--------------------------------------------------------------------------*/
 
  void copy( const std::string & current_suffix , const std::string & suffix ,
@@ -781,153 +997,317 @@ class UCBlockSolutionOutput
 
 /*--------------------------------------------------------------------------*/
 
- template< class F , class G >
- void print_line_data( std::ostream & output ,
-                       const std::vector< NetworkBlock * > & blocks ,
-                       const F & get_data , const G & get_line_name ,
-                       const int precision = 20 ) const {
-  if( blocks.empty() ) return;
+ /// returns the names of the columns of the given kind
+ /** Returns the names of the columns of the given \p kind (see
+  * column_kinds). The names are computed by \p set_names (which must append
+  * \p number_columns names to the given vector) the first time they are
+  * needed or if the number of cached names is not \p number_columns;
+  * otherwise, the cached names are returned. */
 
-  auto number_lines = get_number_lines( blocks.front() );
+ template< class G >
+ const std::vector< std::string > & get_column_names(
+  Index kind , Index number_columns , const G & set_names ) const {
+  auto & names = column_names[ kind ];
+  if( names.size() != number_columns ) {
+   names.clear();
+   names.reserve( number_columns );
+   set_names( names );
+   assert( names.size() == number_columns );
+  }
+  return( names );
+ }
 
-  // Header
+/*--------------------------------------------------------------------------*/
 
-  if( ! append ) {
-   output << "Timestep";
-   for( Index line = 0 ; line < number_lines ; ++line )
-    output << separator_character << get_line_name( line );
-   output << std::endl;
-  }
+ /// returns the names "<prefix>0", ..., "<prefix>{number_columns-1}"
+ const std::vector< std::string > & get_indexed_names(
+  Index kind , Index number_columns , const std::string & prefix ) const {
+  return( get_column_names( kind , number_columns ,
+                            [ & ]( std::vector< std::string > & names ) {
+                             for( Index i = 0 ; i < number_columns ; ++i )
+                              names.push_back( prefix + std::to_string( i ) );
+                            } ) );
+ }
 
-  // Values
+/*--------------------------------------------------------------------------*/
 
-  Index t = 0;
-  if( append )
-   t = initial_time;
+ const std::vector< std::string > & get_line_names(
+  const UCBlock * uc_block , Index number_lines ) const {
+  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
+   uc_block->get_NetworkData() ) ) {
+   const auto & line_names = network_data->get_line_names();
+   if( ! line_names.empty() ) {
+    assert( number_lines <= line_names.size() );
+    return( line_names );
+   }
+  }
+  return( get_indexed_names( line_columns , number_lines , "Line_" ) );
+ }
 
-  for( auto block : blocks ) {
-   output << t;
-   for( Index line = 0 ; line < number_lines ; ++line )
-    output << separator_character << std::setprecision( precision )
-           << get_data( block , line );
-   output << std::endl;
-   ++t;
+/*--------------------------------------------------------------------------*/
+
+ const std::vector< std::string > & get_node_names(
+  const UCBlock * uc_block , Index number_nodes ) const {
+  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
+   uc_block->get_NetworkData() ) ) {
+   const auto & node_names = network_data->get_node_names();
+   if( ! node_names.empty() ) {
+    assert( number_nodes <= node_names.size() );
+    return( node_names );
+   }
   }
+  return( get_indexed_names( node_columns , number_nodes , "Node_" ) );
  }
 
 /*--------------------------------------------------------------------------*/
 
- template< class F >
- void print_node_data( std::ostream & output , const UCBlock * uc_block ,
-                       const F & get_data , const int precision = 20 ) const {
+ const std::vector< std::string > & get_zone_names( Index number_zones )
+  const {
+  return( get_indexed_names( zone_columns , number_zones , "Zone_" ) );
+ }
 
+/*--------------------------------------------------------------------------*/
 
-  const auto & blocks = uc_block->get_network_blocks();
+ /// returns the names of the generators of the given UnitBlocks
+ /** Returns the names of the generators of the given UnitBlocks, which are
+  * cached in the entry \p kind of column_names. */
 
-  if( blocks.empty() ) return;
+ const std::vector< std::string > & get_generator_names(
+  const std::vector< UnitBlock * > & blocks , Index kind ) const {
 
-  auto number_nodes = get_number_nodes( blocks.front() );
+  Index number_columns = 0;
+  for( auto block : blocks )
+   number_columns += block->get_number_generators();
+
+  return( get_column_names(
+   kind , number_columns , [ & ]( std::vector< std::string > & names ) {
+    for( auto block : blocks ) {
+     auto block_name = get_name( block );
+     const auto number_generators = block->get_number_generators();
+     if( number_generators == 1 )
+      names.push_back( block_name );
+     else
+      for( Index g = 0 ; g < number_generators ; ++g )
+       names.push_back( block_name + "_" + std::to_string( g ) );
+    }
+   } ) );
+ }
 
-  // Header
+/*--------------------------------------------------------------------------*/
 
-  std::function< std::string( Index ) > get_node_name = []( Index node ) {
-   return( "Node_" + std::to_string( node ) );
-  };
+ const std::vector< std::string > & get_reservoir_names(
+  const std::vector< HydroUnitBlock * > & blocks ) const {
 
-  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
-   uc_block->get_NetworkData() ) ) {
-   const auto & node_names = network_data->get_node_names();
-   if( ! node_names.empty() )
-    get_node_name = [ &node_names ]( Index node ) {
-     assert( node < node_names.size() );
-     return( node_names[ node ] );
-    };
+  Index number_columns = 0;
+  for( auto block : blocks )
+   number_columns += block->get_number_reservoirs();
+
+  return( get_column_names(
+   reservoir_columns , number_columns ,
+   [ & ]( std::vector< std::string > & names ) {
+    for( auto block : blocks ) {
+     auto block_name = get_name( block );
+     const auto number_reservoirs = block->get_number_reservoirs();
+     if( number_reservoirs == 1 )
+      names.push_back( block_name );
+     else
+      for( Index r = 0 ; r < number_reservoirs ; ++r )
+       names.push_back( block_name + "_" + std::to_string( r ) );
+    }
+   } ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ const std::vector< std::string > & get_storage_names(
+  const std::vector< UnitBlock * > & blocks ) const {
+
+  Index number_columns = 0;
+  for( auto block : blocks ) {
+   if( auto hydro = dynamic_cast< HydroUnitBlock * >( block ) )
+    number_columns += hydro->get_number_reservoirs();
+   else if( dynamic_cast< BatteryUnitBlock * >( block ) )
+    ++number_columns;
+   else
+    throw( std::invalid_argument(
+     "UCBlockSolutionOutput::get_storage_names: invalid type of UnitBlock: "
+     + block->classname() ) );
   }
 
+  return( get_column_names(
+   storage_columns , number_columns ,
+   [ & ]( std::vector< std::string > & names ) {
+    for( auto block : blocks ) {
+     auto block_name = get_name( block );
+     if( auto hydro = dynamic_cast< HydroUnitBlock * >( block ) ) {
+      const auto number_reservoirs = hydro->get_number_reservoirs();
+      if( number_reservoirs == 1 )
+       names.push_back( block_name );
+      else
+       for( Index r = 0 ; r < number_reservoirs ; ++r )
+        names.push_back( block_name + "_" + std::to_string( r ) );
+     } else
+      names.push_back( block_name );
+    }
+   } ) );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// sets the fields of the given Table and resizes its values
+ void set_table( Table & table , const char * row_dimension ,
+                 const char * column_dimension ,
+                 const std::vector< std::string > * column_names ,
+                 Index first_row , Index rows , Index columns ) const {
+  table.row_dimension = row_dimension;
+  table.column_dimension = column_dimension;
+  table.column_names = column_names;
+  table.first_row = first_row;
+  table.rows = rows;
+  table.columns = columns;
+  table.values.resize( std::size_t( rows ) * columns );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ /// prints the given Table into its CSV file
+ void print_table( const Table & table ) const {
+
+  CSVWriter output( filenames[ table.file ].name() , open_mode() , buffer );
+
+  if( ! table.column_names ) return;
+
+  // Header
+
   if( ! append ) {
+   assert( table.columns <= table.column_names->size() );
    output << "Timestep";
-   for( Index node = 0 ; node < number_nodes ; ++node )
-    output << separator_character << get_node_name( node ) << node;
-   output << std::endl;
+   for( Index i = 0 ; i < table.columns ; ++i ) {
+    output << separator_character << ( *table.column_names )[ i ];
+    if( table.file == node_injection )
+     output << i;  // the index of the node is appended (see the notes)
+   }
+   output << '\n';
   }
 
   // Values
 
-  Index t = 0;
-  if( append )
-   t = initial_time;
-
-  for( auto block : blocks ) {
-   output << t;
-   for( Index line = 0 ; line < number_nodes ; ++line )
-    output << separator_character << std::setprecision( precision )
-           << get_data( block , line );
-   output << std::endl;
-   ++t;
+  auto value = table.values.data();
+  for( Index r = 0 ; r < table.rows ; ++r ) {
+   output << ( table.first_row + r );
+   for( Index i = 0 ; i < table.columns ; ++i )
+    output << separator_character << *(value++);
+   output << '\n';
   }
+
+  output.close();
  }
 
 /*--------------------------------------------------------------------------*/
 
- template< class F , class G >
- void print_data( std::ostream & output , UCBlock * block , const F & get_data ,
-                  const Index columns , const G & get_column_name ,
-                  const std::string first_column_header ,
-                  const Index rows , const Index initial_row = 0 ,
-                  const int precision = 20 ) const {
-  // Header
+ /// prints the Table of the maximum pollutant emission duals
+ /** Prints each row of the given Table, whose p-th row is associated with
+  * the p-th pollutant, into the file of that pollutant. Only the first \p
+  * number_zones[ p ] values of the p-th row are printed. */
 
-  if( ! append ) {
-   output << first_column_header;
-   for( Index i = 0 ; i < columns ; ++i )
-    output << separator_character << get_column_name( i );
-   output << std::endl;
+ template< class V >
+ void print_pollutant_table( const Table & table ,
+                             const V & number_zones ) const {
+
+  for( Index p = 0 ; p < table.rows ; ++p ) {
+
+   CSVWriter output( get_marginal_pollutant_filename( p ) , open_mode() ,
+                     buffer );
+
+   // Header
+
+   for( Index z = 0 ; z < number_zones[ p ] ; ++z )
+    output << separator_character << "Zone_" << 0;  // see the notes
+   output << '\n';
+
+   // Values
+   for( Index z = 0 ; z < number_zones[ p ] ; ++z ) {
+    if( z > 0 ) output << separator_character;
+    output << table.values[ p * table.columns + z ];
+   }
+
+   output.close();
   }
+ }
 
-  // Values
+/*--------------------------------------------------------------------------*/
 
-  for( Index r = 0 ; r < rows ; ++r ) {
-   output << ( r + initial_row );
-   for( Index i = 0 ; i < columns ; ++i )
-    output << separator_character << std::setprecision( precision )
-           << get_data( block , r , i );
-   output << std::endl;
+ template< class F >
+ void get_line_data( Table & table , const UCBlock * uc_block ,
+                     const std::vector< NetworkBlock * > & blocks ,
+                     const F & get_data ) const {
+  if( blocks.empty() ) {
+   set_table( table , "time" , "line" , nullptr , 0 , 0 , 0 );
+   return;
   }
+
+  auto number_lines = get_number_lines( blocks.front() );
+
+  set_table( table , "time" , "line" ,
+             & get_line_names( uc_block , number_lines ) ,
+             append ? initial_time : 0 , blocks.size() , number_lines );
+
+  auto value = table.values.begin();
+  for( auto block : blocks )
+   for( Index line = 0 ; line < number_lines ; ++line )
+    *(value++) = get_data( block , line );
  }
 
 /*--------------------------------------------------------------------------*/
 
  template< class F >
- void print_data( std::ostream & output , UCBlock * block , const F & get_data ,
-                  const Index columns , const int precision = 20 ) const {
-  std::function< std::string( Index ) > get_node_name = []( Index node ) {
-   return( "Node_" + std::to_string( node ) );
-  };
+ void get_node_data( Table & table , const UCBlock * uc_block ,
+                     const F & get_data ) const {
 
-  if( auto network_data = dynamic_cast< DCNetworkBlock::DCNetworkData * >(
-   block->get_NetworkData() ) ) {
-   const auto & node_names = network_data->get_node_names();
-   if( ! node_names.empty() )
-    get_node_name = [ &node_names ]( Index node ) {
-     assert( node < node_names.size() );
-     return( node_names[ node ] );
-    };
+  const auto & blocks = uc_block->get_network_blocks();
+
+  if( blocks.empty() ) {
+   set_table( table , "time" , "node" , nullptr , 0 , 0 , 0 );
+   return;
   }
 
-  print_data( output , block , get_data , columns , get_node_name ,
-              "Timestep" , block->get_time_horizon() , initial_time ,
-              precision );
+  auto number_nodes = get_number_nodes( blocks.front() );
+
+  set_table( table , "time" , "node" ,
+             & get_node_names( uc_block , number_nodes ) ,
+             append ? initial_time : 0 , blocks.size() , number_nodes );
+
+  auto value = table.values.begin();
+  for( auto block : blocks )
+   for( Index node = 0 ; node < number_nodes ; ++node )
+    *(value++) = get_data( block , node );
  }
 
 /*--------------------------------------------------------------------------*/
 
- template< class F, class G >
- void print_data( std::ostream & output , UCBlock * block , const F & get_data ,
-                  const Index columns , const G & get_column_name ,
-                  const int precision = 20 ) const {
-  print_data( output , block , get_data , columns , get_column_name ,
-              "Timestep" , block->get_time_horizon() , initial_time ,
-              precision );
+ template< class F >
+ void get_time_data( Table & table , UCBlock * block , const F & get_data ,
+                const Index columns , const char * column_dimension ,
+                const std::vector< std::string > & column_names ) const {
+
+  const auto rows = block->get_time_horizon();
+
+  set_table( table , "time" , column_dimension , & column_names ,
+             initial_time , rows , columns );
+
+  auto value = table.values.begin();
+  for( Index r = 0 ; r < rows ; ++r )
+   for( Index i = 0 ; i < columns ; ++i )
+    *(value++) = get_data( block , r , i );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ template< class F >
+ void get_time_data( Table & table , UCBlock * block , const F & get_data ,
+                const Index columns ) const {
+  get_time_data( table , block , get_data , columns , "node" ,
+                 get_node_names( block , columns ) );
  }
 
 /*--------------------------------------------------------------------------*/
@@ -993,159 +1373,93 @@ class UCBlockSolutionOutput
 /*--------------------------------------------------------------------------*/
 
  template< class F >
- void print_generator_data( std::ostream & output ,
-                            const std::vector< UnitBlock * > & blocks ,
-                            const F & get_data ,
-                            const int precision = 20 ) const {
-
-  if( blocks.empty() ) return;
-
-  // Header
+ void get_generator_data( Table & table ,
+                          const std::vector< UnitBlock * > & blocks ,
+                          const F & get_data ,
+                          const Index kind = unit_columns ) const {
 
-  if( ! append ) {
+  const char * column_dimension =
+   kind == unit_columns ? "generator" : "hydro_generator";
 
-   output << "Timestep";
-   for( auto block : blocks ) {
-    auto block_name = get_name( block );
-    const auto number_generators = block->get_number_generators();
-    if( number_generators <= 1 )
-     output << separator_character << block_name;
-    else
-     for( Index g = 0 ; g < number_generators ; ++g )
-      output << separator_character << block_name << "_" << g;
-   }
-   output << std::endl;
+  if( blocks.empty() ) {
+   set_table( table , "time" , column_dimension , nullptr , 0 , 0 , 0 );
+   return;
   }
 
-  // Values
-
+  const auto & names = get_generator_names( blocks , kind );
   auto time_horizon = blocks.front()->get_time_horizon();
 
-  for( Index t = 0 ; t < time_horizon ; ++t ) {
+  set_table( table , "time" , column_dimension , & names ,
+             append ? initial_time : 0 , time_horizon , names.size() );
 
-   Index time = t;
-   if( append )
-    time = initial_time + t;
-
-   output << time;
+  auto value = table.values.begin();
+  for( Index t = 0 ; t < time_horizon ; ++t )
    for( auto block : blocks ) {
     const auto number_generators = block->get_number_generators();
     for( Index g = 0 ; g < number_generators ; ++g )
-     output << separator_character << std::setprecision( precision )
-            << get_data( block , g , t );
+     *(value++) = get_data( block , g , t );
    }
-   output << std::endl;
-  }
  }
 
 /*--------------------------------------------------------------------------*/
 
  template< class F >
- void print_reservoir_data( std::ostream & output ,
-                            const std::vector< HydroUnitBlock * > & blocks ,
-                            const F & get_data ,
-                            const int precision = 20 ) const {
-
-  if( blocks.empty() ) return;
+ void get_reservoir_data( Table & table ,
+                          const std::vector< HydroUnitBlock * > & blocks ,
+                          const F & get_data ) const {
 
-  // Header
-
-  if( ! append ) {
-   output << "Timestep";
-   for( auto block : blocks ) {
-    auto block_name = get_name( block );
-    const auto number_reservoirs = block->get_number_reservoirs();
-    if( number_reservoirs <= 1 )
-     output << separator_character << block_name;
-    else
-     for( Index r = 0 ; r < number_reservoirs ; ++r )
-      output << separator_character << block_name << "_" << r;
-   }
-   output << std::endl;
+  if( blocks.empty() ) {
+   set_table( table , "time" , "reservoir" , nullptr , 0 , 0 , 0 );
+   return;
   }
 
-  // Values
-
+  const auto & names = get_reservoir_names( blocks );
   auto time_horizon = blocks.front()->get_time_horizon();
 
-  for( Index t = 0 ; t < time_horizon ; ++t ) {
+  set_table( table , "time" , "reservoir" , & names ,
+             append ? initial_time : 0 , time_horizon , names.size() );
 
-   Index time = t;
-   if( append )
-    time = initial_time + t;
-
-   output << time;
+  auto value = table.values.begin();
+  for( Index t = 0 ; t < time_horizon ; ++t )
    for( auto block : blocks ) {
     const auto number_reservoirs = block->get_number_reservoirs();
     for( Index r = 0 ; r < number_reservoirs ; ++r )
-     output << separator_character << std::setprecision( precision )
-            << get_data( block , r , t );
+     *(value++) = get_data( block , r , t );
    }
-   output << std::endl;
-  }
  }
 
 /*--------------------------------------------------------------------------*/
 
  template< class F >
- void print_storage_data( std::ostream & output ,
-                          const std::vector< UnitBlock * > & blocks ,
-                          const F & get_data ,
-                          const int precision = 20 ) const {
-
-  if( blocks.empty() ) return;
+ void get_storage_data( Table & table ,
+                        const std::vector< UnitBlock * > & blocks ,
+                        const F & get_data ) const {
 
-  // Header
-
-  if( ! append ) {
-   output << "Timestep";
-   for( auto block : blocks ) {
-    auto block_name = get_name( block );
-    if( auto hydro = dynamic_cast< HydroUnitBlock * >( block ) ) {
-     const auto number_reservoirs = hydro->get_number_reservoirs();
-     if( number_reservoirs <= 1 )
-      output << separator_character << block_name;
-     else
-      for( Index r = 0 ; r < number_reservoirs ; ++r )
-       output << separator_character << block_name << "_" << r;
-    } else if( auto battery = dynamic_cast< BatteryUnitBlock * >( block ) )
-     output << separator_character << block_name;
-    else
-     throw( std::invalid_argument(
-      "UCBlockSolutionOutput::print_storage_data: invalid type of UnitBlock: "
-      + block->classname() ) );
-   }
-   output << std::endl;
+  if( blocks.empty() ) {
+   set_table( table , "time" , "storage" , nullptr , 0 , 0 , 0 );
+   return;
   }
 
-  // Values
-
+  const auto & names = get_storage_names( blocks );
   auto time_horizon = blocks.front()->get_time_horizon();
 
-  for( Index t = 0 ; t < time_horizon ; ++t ) {
-
-   Index time = t;
-   if( append )
-    time = initial_time + t;
+  set_table( table , "time" , "storage" , & names ,
+             append ? initial_time : 0 , time_horizon , names.size() );
 
-   output << time;
+  auto value = table.values.begin();
+  for( Index t = 0 ; t < time_horizon ; ++t )
    for( auto block : blocks ) {
-
     if( auto hydro = dynamic_cast< HydroUnitBlock * >( block ) ) {
      const auto number_reservoirs = hydro->get_number_reservoirs();
      for( Index r = 0 ; r < number_reservoirs ; ++r )
-      output << separator_character << std::setprecision( precision )
-             << get_data( hydro , r , t );
+      *(value++) = get_data( hydro , r , t );
     } else if( auto battery = dynamic_cast< BatteryUnitBlock * >( block ) )
-     output << separator_character << std::setprecision( precision )
-            << get_data( battery , t , t );
+     *(value++) = get_data( battery , t , t );
     else
      throw( std::invalid_argument(
-      "UCBlockSolutionOutput::print_storage_data: invalid type of UnitBlock: "
+      "UCBlockSolutionOutput::get_storage_data: invalid type of UnitBlock: "
       + block->classname() ) );
    }
-   output << std::endl;
-  }
  }
 
 /*--------------------------------------------------------------------------*/
@@ -1189,6 +1503,19 @@ class UCBlockSolutionOutput
   number_of_files
  };
 
+ /// the kinds of columns whose names are cached (see get_column_names())
+ enum column_kinds
+ {
+  unit_columns = 0 ,
+  hydro_unit_columns ,
+  reservoir_columns ,
+  storage_columns ,
+  line_columns ,
+  node_columns ,
+  zone_columns ,
+  number_of_column_kinds
+ };
+
 /*--------------------------------------------------------------------------*/
 /*---------------------------- PRIVATE FIELDS  -----------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -1198,6 +1525,15 @@ class UCBlockSolutionOutput
  Index initial_time = 0;
  std::vector< Filename > filenames;
 
+ /// the cached names of the columns, for each kind in column_kinds
+ mutable std::vector< std::vector< std::string > > column_names;
+
+ /// the buffer used by the CSVWriter of every file
+ mutable std::vector< char > buffer;
+
+ /// the Table used by the print_*() methods
+ mutable Table table;
+
 /*--------------------------------------------------------------------------*/
 /*--------------------------------------------------------------------------*/
 
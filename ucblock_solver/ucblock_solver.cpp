@@ -5,6 +5,11 @@
  * optionally configures it with a BlockConfig and a BlockSolverConfig,
  * and solves it with all the loaded Solvers.
  *
+ * Several files (or directories, standing for the .nc4 files they contain)
+ * can be given: the configurations are then read once, the files are
+ * solved concurrently by the number of threads given by the -j option, and
+ * the results are printed in the order of the files.
+ *
  * Optionally, it writes back the Block, the BlockConfig and the
  * BlockSolverConfig on a SMS++ nc4 problem file.
  *
@@ -25,6 +30,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
 
 #include <Block.h>
 #include <BlockSolverConfig.h>
@@ -43,56 +49,102 @@ int main( int argc, char ** argv ) {
  docopt_desc = "SMS++ unit commitment solver.\n";
  process_args( argc, argv );
 
- // Deserialize block
- Block * block = Block::deserialize( filename );
- if( ! block ) {
-  std::cerr << exe << ": "
-            << "Block::deserialize() failed!" << std::endl;
+ const bool batch_mode = filenames.size() > 1;
+
+ if( batch_mode && solution_output_type >= 2 ) {
+  std::cerr << exe << ": the solutions cannot be output to files when "
+            << "several files are solved,\nsince they would all be written "
+            << "into the same files" << std::endl;
   exit( 1 );
  }
 
- // Configure block
- BlockConfig * b_config;
+ // Read the configurations (once for all files)
+ BlockConfig * b_config = nullptr;
  if( ! bconf_file.empty() ) {
   b_config = get_blockconfig( bconf_file );
   if( b_config == nullptr ) {
    std::cerr << exe << ": Block configuration not valid" << std::endl;
    exit( 1 );
   }
- } else {
-  // TODO: Try to remove this
-  std::cout << "Using a default Block configuration" << std::endl;
-  b_config = default_configure_UCBlock( block );
  }
- b_config->apply( block );
 
- // Configure solver
- BlockSolverConfig * s_config;
+ BlockSolverConfig * s_config = nullptr;
  if( ! sconf_file.empty() ) {
   s_config = get_blocksolverconfig( sconf_file );
   if( s_config == nullptr ) {
    std::cerr << exe << ": Solver configuration not valid" << std::endl;
    exit( 1 );
   }
- } else {
-  std::cout << "Using a default Solver configuration" << std::endl;
-  s_config = default_configure_solver( solvVerbose );
  }
- s_config->apply( block );
 
- // Write nc4 problem
- if( writeprob )
-  write_nc4problem( block, b_config, s_config );
+ // Solve each file, possibly concurrently, see common_utils.h
+ auto solve_file = [ & ]( std::size_t i, std::ostream & out ) {
+
+  const auto & file = filenames[ i ];
+  if( batch_mode )
+   out << "File: " << file << std::endl;
+
+  // Deserialize block
+  Block * block;
+  {
+   std::lock_guard< std::mutex > lock( netcdf_mutex );
+   block = Block::deserialize( file );
+  }
+  if( ! block )
+   throw( std::runtime_error( "Block::deserialize() failed for " + file ) );
+
+  // Configure block
+  BlockConfig * block_config;
+  if( b_config )
+   block_config = b_config->clone();
+  else {
+   // TODO: Try to remove this
+   out << "Using a default Block configuration" << std::endl;
+   block_config = default_configure_UCBlock( block );
+  }
+  block_config->apply( block );
+
+  // Configure solver
+  BlockSolverConfig * solver_config;
+  if( s_config )
+   solver_config = s_config->clone();
+  else {
+   out << "Using a default Solver configuration" << std::endl;
+   solver_config = default_configure_solver( solvVerbose );
+  }
+  solver_config->apply( block );
+
+  // Write nc4 problem
+  if( writeprob ) {
+   std::lock_guard< std::mutex > lock( netcdf_mutex );
+   write_nc4problem( block, block_config, solver_config, file );
+  }
+
+  block_config->clear();
+  solver_config->clear();
+
+  // Solve
+  out.setf( std::ios::scientific, std::ios::floatfield );
+  out << std::setprecision( 8 );
+  solve_all( block, out );
+
+  // Print the results
+  print_UCBlock_solver_results( block , solution_output_type , out );
+
+  // Destroy the Block and the Configurations
+  block_config->apply( block );
+  delete( block_config );
+  solver_config->apply( block );
+  delete( solver_config );
+  delete( block );
+ };
 
- // Solve
- std::cout.setf( std::ios::scientific, std::ios::floatfield );
- std::cout << std::setprecision( 8 );
- solve_all( block );
+ const auto number_failed = run_batch( filenames.size(), solve_file );
 
- // Print the results
- print_UCBlock_solver_results( block , solution_output_type );
+ delete( b_config );
+ delete( s_config );
 
- return( 0 );
+ return( number_failed ? 1 : 0 );
 }  // end( main )
 
 /*--------------------------------------------------------------------------*/
@@ -68,7 +68,8 @@ BlockConfig * default_configure_UCBlock( Block * uc_block ) {
 }
 
 /// Prints the content of a solved UCBlock
-void print_UCBlock_solver_results( Block * block ) {
+void print_UCBlock_solver_results( Block * block ,
+                                   std::ostream & out = std::cout ) {
 
  auto solver = block->get_registered_solvers().front();
  solver->get_var_solution();
@@ -76,7 +77,7 @@ void print_UCBlock_solver_results( Block * block ) {
  int n_unit_blocks = 0;
  int n_net_blocks = 0;
 
- std::cout << std::endl;
+ out << std::endl;
 
  for( auto i : block->get_nested_Blocks() ) {
 
@@ -87,30 +88,30 @@ void print_UCBlock_solver_results( Block * block ) {
   Index number_inertia_zones = uc_block->get_number_inertia_zones();
 
   if( auto unit_block = dynamic_cast< UnitBlock * >( i ) ) {
-   std::cout << "----- " << unit_block->classname() <<
-             " " << n_unit_blocks++ << " -----" << std::endl;
+   out << "----- " << unit_block->classname() <<
+       " " << n_unit_blocks++ << " -----" << std::endl;
 
    if( auto obj =
     dynamic_cast< FRealObjective * >( unit_block->get_objective() ) ) {
     auto fun = obj->get_function();
     fun->compute();
-    std::cout << "Function value = " << fun->get_value() << std::endl;
+    out << "Function value = " << fun->get_value() << std::endl;
    }
 
    if( auto thermal_unit_block =
     dynamic_cast< ThermalUnitBlock * >( unit_block ) ) {
 
     if( thermal_unit_block->get_investment_cost() != 0 )
-     std::cout << "Capacity       = " <<
-               thermal_unit_block->get_design().get_value() *
-               thermal_unit_block->get_capacity() << std::endl;
+     out << "Capacity       = " <<
+         thermal_unit_block->get_design().get_value() *
+         thermal_unit_block->get_capacity() << std::endl;
 
     auto commitment = thermal_unit_block->get_commitment( 0 );
-    std::cout << "Commitment     = [";
+    out << "Commitment     = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-     std::cout << std::setw( 2 )
-               << ( unsigned int ) round( commitment[ t ].get_value() );
-    std::cout << " ]" << std::endl;
+     out << std::setw( 2 )
+         << ( unsigned int ) round( commitment[ t ].get_value() );
+    out << " ]" << std::endl;
 
     // Generate init_t
     Index init_t;
@@ -125,41 +126,41 @@ void print_UCBlock_solver_results( Block * block ) {
                 0 : min_down_time + init_up_down_time );
 
     auto startup = thermal_unit_block->get_start_up();
-    std::cout << "Start up       = [";
+    out << "Start up       = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() - init_t ; ++t )
-     std::cout << std::setw( 2 )
-               << ( unsigned int ) round( startup[ t ].get_value() );
-    std::cout << " ]" << std::endl;
+     out << std::setw( 2 )
+         << ( unsigned int ) round( startup[ t ].get_value() );
+    out << " ]" << std::endl;
 
     auto shutdown = thermal_unit_block->get_shut_down();
-    std::cout << "Shut down      = [";
+    out << "Shut down      = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() - init_t ; ++t )
-     std::cout << std::setw( 2 )
-               << ( unsigned int ) round( shutdown[ t ].get_value() );
-    std::cout << " ]" << std::endl;
+     out << std::setw( 2 )
+         << ( unsigned int ) round( shutdown[ t ].get_value() );
+    out << " ]" << std::endl;
 
     auto active_power = thermal_unit_block->get_active_power( 0 );
-    std::cout << "Active power   = [";
+    out << "Active power   = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-     std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << active_power[ t ].get_value();
+    out << " ]" << std::endl;
 
     if( number_primary_zones > 0 ) {
      auto primary_reserve = thermal_unit_block
       ->get_primary_spinning_reserve( 0 );
-     std::cout << "Primary reserve     = [";
+     out << "Primary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << primary_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << primary_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     if( number_secondary_zones > 0 ) {
      auto secondary_reserve = thermal_unit_block
       ->get_secondary_spinning_reserve( 0 );
-     std::cout << "Secondary reserve     = [";
+     out << "Secondary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << secondary_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << secondary_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
    }
 
@@ -167,80 +168,80 @@ void print_UCBlock_solver_results( Block * block ) {
     dynamic_cast< BatteryUnitBlock * >( unit_block ) ) {
 
     if( battery_unit_block->get_batt_investment_cost() != 0 )
-     std::cout << "Batt Capacity  = " <<
-               battery_unit_block->get_batt_design().get_value() *
-               battery_unit_block->get_batt_max_capacity() << std::endl;
+     out << "Batt Capacity  = " <<
+         battery_unit_block->get_batt_design().get_value() *
+         battery_unit_block->get_batt_max_capacity() << std::endl;
 
     if( battery_unit_block->get_conv_investment_cost() != 0 )
-     std::cout << "Conv Capacity  = " <<
-               battery_unit_block->get_conv_design().get_value() *
-               battery_unit_block->get_conv_max_capacity() << std::endl;
+     out << "Conv Capacity  = " <<
+         battery_unit_block->get_conv_design().get_value() *
+         battery_unit_block->get_conv_max_capacity() << std::endl;
 
     auto active_power = battery_unit_block->get_active_power( 0 );
-    std::cout << "Active power   = [";
+    out << "Active power   = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-     std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << active_power[ t ].get_value();
+    out << " ]" << std::endl;
 
     if( number_primary_zones > 0 ) {
      auto PrimarySR = battery_unit_block->get_primary_spinning_reserve( 0 );
-     std::cout << "Primary reserve     = [";
+     out << "Primary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << PrimarySR[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << PrimarySR[ t ].get_value();
+     out << " ]" << std::endl;
     }
     if( number_secondary_zones > 0 ) {
      auto SecondarySR = battery_unit_block->get_secondary_spinning_reserve( 0 );
-     std::cout << "Secondary reserve     = [";
+     out << "Secondary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << SecondarySR[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << SecondarySR[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     auto intake_level = battery_unit_block->get_intake_level();
-    std::cout << "Intake level   = [";
+    out << "Intake level   = [";
     for( auto & t : intake_level )
-     std::cout << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
-    std::cout << " ]" << std::endl;
+     out << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
+    out << " ]" << std::endl;
 
     auto outtake_level = battery_unit_block->get_outtake_level();
-    std::cout << "Outtake level  = [";
+    out << "Outtake level  = [";
     for( auto & t : outtake_level )
-     std::cout << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
-    std::cout << " ]" << std::endl;
+     out << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
+    out << " ]" << std::endl;
 
     auto storage_level = battery_unit_block->get_storage_level();
-    std::cout << "Storage level  = [";
+    out << "Storage level  = [";
     for( auto & t : storage_level )
-     std::cout << std::setw( 20 ) << t.get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << t.get_value();
+    out << " ]" << std::endl;
 
     auto binary_var = battery_unit_block->get_intake_outtake_binary_variables();
     if( ! binary_var.empty() ) {
-     std::cout << "Binary var   = [";
+     out << "Binary var   = [";
      for( auto & t : binary_var )
-      std::cout << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
-     std::cout << " ]" << std::endl;
+      out << std::setw( 2 ) << ( unsigned int ) round( t.get_value() );
+     out << " ]" << std::endl;
     }
    }
 
    if( auto hydro_block = dynamic_cast< HydroUnitBlock * >( unit_block ) ) {
     for( Index g = 0 ; g < unit_block->get_number_generators() ; ++g ) {
      auto active_power = hydro_block->get_active_power( g );
-     std::cout << "Active power [" + std::to_string( g ) + "]" " = [";
+     out << "Active power [" + std::to_string( g ) + "]" " = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << active_power[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     if( number_primary_zones > 0 ) {
      for( Index g = 0 ;
           g < unit_block->get_number_generators() ; ++g ) {
       auto primary_reserve = hydro_block->get_primary_spinning_reserve( g );
-      std::cout << "Primary reserve [" + std::to_string( g ) + "]" " = [";
+      out << "Primary reserve [" + std::to_string( g ) + "]" " = [";
       for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-       std::cout << std::setw( 20 ) << primary_reserve[ t ].get_value();
-      std::cout << " ]" << std::endl;
+       out << std::setw( 20 ) << primary_reserve[ t ].get_value();
+      out << " ]" << std::endl;
      }
     }
     if( number_secondary_zones > 0 ) {
@@ -248,87 +249,87 @@ void print_UCBlock_solver_results( Block * block ) {
           g < unit_block->get_number_generators() ; ++g ) {
       auto secondary_reserve = hydro_block
        ->get_secondary_spinning_reserve( g );
-      std::cout << "Secondary reserve [" + std::to_string( g ) + "]" " = [";
+      out << "Secondary reserve [" + std::to_string( g ) + "]" " = [";
       for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-       std::cout << std::setw( 20 ) << secondary_reserve[ t ].get_value();
-      std::cout << " ]" << std::endl;
+       out << std::setw( 20 ) << secondary_reserve[ t ].get_value();
+      out << " ]" << std::endl;
      }
     }
     for( Index l = 0 ; l < hydro_block->get_number_generators() ; ++l ) {
      auto flow_rate = hydro_block->get_flow_rate( l );
-     std::cout << "Flow rate    [" + std::to_string( l ) + "]" " = [";
+     out << "Flow rate    [" + std::to_string( l ) + "]" " = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 25 ) << std::setprecision( 14 )
-                << flow_rate[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 25 ) << std::setprecision( 14 )
+          << flow_rate[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     for( Index n = 0 ; n < hydro_block->get_number_reservoirs() ; ++n ) {
      auto volumetric = hydro_block->get_volumetric( n );
-     std::cout << "Volumetric   [" + std::to_string( n ) + "]" " = [";
+     out << "Volumetric   [" + std::to_string( n ) + "]" " = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 25 ) << std::setprecision( 14 )
-                << volumetric[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 25 ) << std::setprecision( 14 )
+          << volumetric[ t ].get_value();
+     out << " ]" << std::endl;
     }
-    std::cout << std::setprecision( 8 );
+    out << std::setprecision( 8 );
    }
 
    if( auto hsu_block = dynamic_cast< HydroSystemUnitBlock * >( unit_block ) ) {
 
     for( Index hIdx = 0 ;
          hIdx < hsu_block->get_number_hydro_units() ; ++hIdx ) {
-     std::cout << "----- SubHydroBlock " << hIdx << " -----" << std::endl;
+     out << "----- SubHydroBlock " << hIdx << " -----" << std::endl;
      // for each hydro block inside, print the solution
      if( auto sub_hsu_block = hsu_block->
       get_hydro_unit_block( hIdx ) ) {
       for( Index g = 0 ; g < sub_hsu_block->get_number_generators() ; ++g ) {
        auto active_power = sub_hsu_block->get_active_power( g );
-       std::cout << "Active power [" + std::to_string( g ) + "]" " = [";
+       out << "Active power [" + std::to_string( g ) + "]" " = [";
        for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-        std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-       std::cout << " ]" << std::endl;
+        out << std::setw( 20 ) << active_power[ t ].get_value();
+       out << " ]" << std::endl;
       }
 
       if( number_primary_zones > 0 ) {
        for( Index g = 0 ; g < sub_hsu_block->get_number_generators() ; ++g ) {
         auto primary_reserve = sub_hsu_block
          ->get_primary_spinning_reserve( g );
-        std::cout << "Primary reserve [" + std::to_string( g ) + "]" " = [";
+        out << "Primary reserve [" + std::to_string( g ) + "]" " = [";
         for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-         std::cout << std::setw( 20 ) << primary_reserve[ t ].get_value();
-        std::cout << " ]" << std::endl;
+         out << std::setw( 20 ) << primary_reserve[ t ].get_value();
+        out << " ]" << std::endl;
        }
       }
       if( number_secondary_zones > 0 ) {
        for( Index g = 0 ; g < sub_hsu_block->get_number_generators() ; ++g ) {
         auto secondary_reserve = sub_hsu_block
          ->get_secondary_spinning_reserve( g );
-        std::cout << "Secondary reserve [" + std::to_string( g ) + "]" " = [";
+        out << "Secondary reserve [" + std::to_string( g ) + "]" " = [";
         for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-         std::cout << std::setw( 20 ) << secondary_reserve[ t ].get_value();
-        std::cout << " ]" << std::endl;
+         out << std::setw( 20 ) << secondary_reserve[ t ].get_value();
+        out << " ]" << std::endl;
        }
       }
 
       for( Index l = 0 ; l < sub_hsu_block->get_number_generators() ; ++l ) {
        auto flow_rate = sub_hsu_block->get_flow_rate( l );
-       std::cout << "Flow rate    [" + std::to_string( l ) + "]" " = [";
+       out << "Flow rate    [" + std::to_string( l ) + "]" " = [";
        for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-        std::cout << std::setw( 25 ) << std::setprecision( 14 )
-                  << flow_rate[ t ].get_value();
-       std::cout << " ]" << std::endl;
+        out << std::setw( 25 ) << std::setprecision( 14 )
+            << flow_rate[ t ].get_value();
+       out << " ]" << std::endl;
       }
 
       for( Index n = 0 ; n < sub_hsu_block->get_number_reservoirs() ; ++n ) {
        auto volumetric = sub_hsu_block->get_volumetric( n );
-       std::cout << "Volumetric   [" + std::to_string( n ) + "]" " = [";
+       out << "Volumetric   [" + std::to_string( n ) + "]" " = [";
        for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-        std::cout << std::setw( 25 ) << std::setprecision( 14 )
-                  << volumetric[ t ].get_value();
-       std::cout << " ]" << std::endl;
+        out << std::setw( 25 ) << std::setprecision( 14 )
+            << volumetric[ t ].get_value();
+       out << " ]" << std::endl;
       }
-      std::cout << std::setprecision( 8 );
+      out << std::setprecision( 8 );
      }
     }
    }
@@ -337,33 +338,33 @@ void print_UCBlock_solver_results( Block * block ) {
     dynamic_cast< IntermittentUnitBlock * >( unit_block ) ) {
 
     if( intermittent_unit_block->get_investment_cost() != 0 )
-     std::cout << "Capacity       = " <<
-               intermittent_unit_block->get_design().get_value() *
-               intermittent_unit_block->get_max_capacity() << std::endl;
+     out << "Capacity       = " <<
+         intermittent_unit_block->get_design().get_value() *
+         intermittent_unit_block->get_max_capacity() << std::endl;
 
     auto active_power = intermittent_unit_block->get_active_power( 0 );
-    std::cout << "Active power   = [";
+    out << "Active power   = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-     std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << active_power[ t ].get_value();
+    out << " ]" << std::endl;
 
     if( number_primary_zones > 0 ) {
      auto primary_spinning_reserve = intermittent_unit_block
       ->get_primary_spinning_reserve( 0 );
-     std::cout << "Primary reserve     = [";
+     out << "Primary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << primary_spinning_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << primary_spinning_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     if( number_secondary_zones > 0 ) {
      auto secondary_spinning_reserve = intermittent_unit_block
       ->get_secondary_spinning_reserve( 0 );
-     std::cout << "Secondary reserve     = [";
+     out << "Secondary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 )
-                << secondary_spinning_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 )
+          << secondary_spinning_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
    }
 
@@ -371,76 +372,76 @@ void print_UCBlock_solver_results( Block * block ) {
     dynamic_cast< SlackUnitBlock * >( unit_block ) ) {
 
     auto active_power = slack_unit_block->get_active_power( 0 );
-    std::cout << "Active power   = [";
+    out << "Active power   = [";
     for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-     std::cout << std::setw( 20 ) << active_power[ t ].get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << active_power[ t ].get_value();
+    out << " ]" << std::endl;
 
     if( number_inertia_zones > 0 ) {
      auto commitment = slack_unit_block->get_commitment( 0 );
-     std::cout << "Commitment     = [";
+     out << "Commitment     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 2 )
-                << ( unsigned int ) round( commitment[ t ].get_value() );
-     std::cout << " ]" << std::endl;
+      out << std::setw( 2 )
+          << ( unsigned int ) round( commitment[ t ].get_value() );
+     out << " ]" << std::endl;
     }
 
     if( number_primary_zones > 0 ) {
      auto primary_spinning_reserve = slack_unit_block
       ->get_primary_spinning_reserve( 0 );
-     std::cout << "Primary reserve     = [";
+     out << "Primary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 ) << primary_spinning_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << primary_spinning_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
 
     if( number_secondary_zones > 0 ) {
      auto secondary_spinning_reserve = slack_unit_block
       ->get_secondary_spinning_reserve( 0 );
-     std::cout << "Secondary reserve     = [";
+     out << "Secondary reserve     = [";
      for( Index t = 0 ; t < unit_block->get_time_horizon() ; ++t )
-      std::cout << std::setw( 20 )
-                << secondary_spinning_reserve[ t ].get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 )
+          << secondary_spinning_reserve[ t ].get_value();
+     out << " ]" << std::endl;
     }
    }
 
   } else if( auto network_block = dynamic_cast< NetworkBlock * >( i ) ) {
 
-   std::cout << "----- " << network_block->classname() << " " <<
-             n_net_blocks++ << " -----" << std::endl;
+   out << "----- " << network_block->classname() << " " <<
+       n_net_blocks++ << " -----" << std::endl;
 
    if( auto obj =
     dynamic_cast< FRealObjective * >( network_block->get_objective() ) ) {
     auto fun = obj->get_function();
     fun->compute();
-    std::cout << "Function value   = " << fun->get_value() << std::endl;
+    out << "Function value   = " << fun->get_value() << std::endl;
    }
 
-   /* std::cout << "Node injection   = [" << std::endl;
+   /* out << "Node injection   = [" << std::endl;
    for( Index t = 0 ; t < network_block->get_number_intervals() ; ++t ) {
     auto node_inj = network_block->get_node_injection( t );
     for( Index j = 0 ; j < network_block->get_number_nodes() ; ++j )
-     std::cout << std::setw( 20 ) << node_inj[ j ].get_value();
-    std::cout << std::endl;
+     out << std::setw( 20 ) << node_inj[ j ].get_value();
+    out << std::endl;
    }
-   std::cout << " ]" << std::endl; */
+   out << " ]" << std::endl; */
 
    if( auto dc_network_block =
     dynamic_cast< DCNetworkBlock * >( network_block ) ) {
 
     auto power_flow = dc_network_block->get_power_flow();
-    std::cout << "Power flow       = [";
+    out << "Power flow       = [";
     for( auto & n : power_flow )
-     std::cout << std::setw( 20 ) << n.get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << n.get_value();
+    out << " ]" << std::endl;
 
     auto auxiliary_var = dc_network_block->get_auxiliary_variable();
     if( ! auxiliary_var.empty() ) {
-     std::cout << "Auxiliary variable     = [";
+     out << "Auxiliary variable     = [";
      for( auto & n : auxiliary_var )
-      std::cout << std::setw( 20 ) << n.get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << n.get_value();
+     out << " ]" << std::endl;
     }
 
    } else if( auto ec_network_block =
@@ -448,38 +449,38 @@ void print_UCBlock_solver_results( Block * block ) {
 
     auto shared_power = ec_network_block->get_shared_power();
     if( ! shared_power.empty() ) {
-     std::cout << "Shared power     = [";
+     out << "Shared power     = [";
      for( auto & n : shared_power )
-      std::cout << std::setw( 20 ) << n.get_value();
-     std::cout << " ]" << std::endl;
+      out << std::setw( 20 ) << n.get_value();
+     out << " ]" << std::endl;
     }
 
-    std::cout << "Public power injection   = [" << std::endl;
+    out << "Public power injection   = [" << std::endl;
     for( Index t = 0 ; t < ec_network_block->get_number_intervals() ; ++t ) {
      auto power_inj = ec_network_block->get_power_injection( t );
      for( Index j = 0 ; j < ec_network_block->get_number_nodes() ; ++j )
-      std::cout << std::setw( 20 ) << power_inj[ j ].get_value();
-     std::cout << std::endl;
+      out << std::setw( 20 ) << power_inj[ j ].get_value();
+     out << std::endl;
     }
-    std::cout << " ]" << std::endl;
+    out << " ]" << std::endl;
 
-    std::cout << "Public power absorption   = [" << std::endl;
+    out << "Public power absorption   = [" << std::endl;
     for( Index t = 0 ; t < ec_network_block->get_number_intervals() ; ++t ) {
      auto power_abs = ec_network_block->get_power_absorption( t );
      for( Index j = 0 ; j < ec_network_block->get_number_nodes() ; ++j )
-      std::cout << std::setw( 20 ) << power_abs[ j ].get_value();
-     std::cout << std::endl;
+      out << std::setw( 20 ) << power_abs[ j ].get_value();
+     out << std::endl;
     }
-    std::cout << " ]" << std::endl;
+    out << " ]" << std::endl;
 
     auto peak_power = ec_network_block->get_peak_power();
-    std::cout << "Peak power       = [";
+    out << "Peak power       = [";
     for( auto & n : peak_power )
-     std::cout << std::setw( 20 ) << n.get_value();
-    std::cout << " ]" << std::endl;
+     out << std::setw( 20 ) << n.get_value();
+    out << " ]" << std::endl;
    }
   }
-  std::cout << std::endl;
+  out << std::endl;
  }
 }
 
@@ -487,13 +488,14 @@ void print_UCBlock_solver_results( Block * block ) {
 
 /// Prints the content of a solved UCBlock
 void print_UCBlock_solver_results( Block * block ,
-                                   int solution_output_type ) {
+                                   int solution_output_type ,
+                                   std::ostream & out = std::cout ) {
 
  if( ! ( solution_output_type > 0 && solution_output_type < 4 ) )
   return;
 
  if( solution_output_type == 1 || solution_output_type == 3 )
-  print_UCBlock_solver_results( block );
+  print_UCBlock_solver_results( block , out );
 
  if( solution_output_type == 2 || solution_output_type == 3 ) {
   auto solver = block->get_registered_solvers().front();